@@ -30,6 +30,7 @@ namespace {
 constexpr uint8_t kInitiatorLogicalAddress = 0xFE;
 constexpr uint8_t kTargetLogicalAddress = 0xFE;
 constexpr std::size_t kChunkSize = 1024;
+constexpr std::size_t kWindow = 32;
 
 using Clock = std::chrono::steady_clock;
 
@@ -323,21 +324,17 @@ auto main(int argc, char** argv) -> int {
       kTargetLogicalAddress, std::move(opts.target_address),
       std::move(opts.reply_address));
 
-  // Initial write of the pattern into the device memory.
-  for (std::size_t offset = 0; offset < total_bytes; offset += kChunkSize) {
-    const std::size_t chunk = std::min(kChunkSize, total_bytes - offset);
-    std::span<const uint8_t> chunk_span(pattern.data() + offset, chunk);
-    auto res = client.write(
-        target, base_address + static_cast<uint32_t>(offset), chunk_span);
-    if (!res.has_value()) {
-      std::cerr << "Write failed at offset " << offset << ": "
-                << res.error().message() << "\n";
-      client.shutdown();
-      joinLoop();
-      return 1;
-    }
+  // Initial write of the pattern into the device memory, pipelined.
+  if (auto res =
+          client.bulkWrite(target, base_address, pattern, kChunkSize, kWindow);
+      !res.has_value()) {
+    std::cerr << "Write failed: " << res.error().message() << "\n";
+    client.shutdown();
+    joinLoop();
+    return 1;
   }
 
+  client.resetIoStatistics();
   std::vector<double> latencies_us;
   latencies_us.reserve(ntimes);
   std::vector<uint8_t> read_buffer(total_bytes);
@@ -392,6 +389,17 @@ auto main(int argc, char** argv) -> int {
             << " q3=" << toMicroseconds(q3) << " max=" << toMicroseconds(max_v)
             << '\n';
 
+  const auto io = client.getIoStatistics();
+  const auto packets = io.packets_received + io.packets_sent;
+  if (packets > 0) {
+    std::cout << "recv_calls=" << io.recv_calls
+              << " send_calls=" << io.send_calls << " packets=" << packets
+              << " syscalls/packet="
+              << static_cast<double>(io.recv_calls + io.send_calls) /
+                     static_cast<double>(packets)
+              << '\n';
+  }
+
   auto shutdown_res = client.shutdown();
   if (!shutdown_res.has_value()) {
     std::cerr << "Shutdown error: " << shutdown_res.error().message() << "\n";
@@ -0,0 +1,239 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spw_rmap/memory_target.hh"
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#ifdef __linux__
+#include "spw_rmap/spw_rmap_tcp_multi_server.hh"
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Options {
+  std::string ip{"127.0.0.1"};
+  std::string port{"10030"};
+  std::vector<spw_rmap::MemoryRegionConfig> regions;
+  std::size_t workers = 0;
+};
+
+void printUsage(const char* program) {
+  std::cerr
+      << "Usage: " << program << '\n'
+      << "  --ip <addr> --port <port>\n"
+      << "  --region <extended-address> <address> <size> [<file>] ...\n"
+      << "  --workers <count>\n"
+      << "Serves RMAP commands from memory. Without --region, the whole\n"
+      << "4 GiB of extended address 0 is mapped, without a file. A file\n"
+      << "keeps the region's contents across runs. --workers serves any\n"
+      << "number of clients at once on that many threads (Linux only);\n"
+      << "otherwise clients are served one after another.\n";
+}
+
+auto parseUnsigned(std::string_view token, unsigned long long max_value)
+    -> std::optional<unsigned long long> {
+  try {
+    std::string temp(token);
+    size_t idx = 0;
+    auto value = std::stoull(temp, &idx, 0);
+    if (idx != temp.size() || value > max_value) {
+      return std::nullopt;
+    }
+    return value;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+auto parseRegion(int argc, char** argv, int& index)
+    -> std::optional<spw_rmap::MemoryRegionConfig> {
+  std::vector<std::string_view> values;
+  while (index + 1 < argc && values.size() < 4) {
+    std::string_view next = argv[index + 1];
+    if (next.starts_with("--")) {
+      break;
+    }
+    ++index;
+    values.push_back(next);
+  }
+  if (values.size() < 3) {
+    std::cerr << "--region requires an extended address, an address and a "
+                 "size.\n";
+    return std::nullopt;
+  }
+  const auto extended_address = parseUnsigned(values[0], 0xFF);
+  const auto address = parseUnsigned(values[1], 0xFFFFFFFF);
+  const auto size = parseUnsigned(values[2], 0x100000000);
+  if (!extended_address || !address || !size) {
+    std::cerr << "Invalid --region: '" << values[0] << " " << values[1] << " "
+              << values[2] << "'\n";
+    return std::nullopt;
+  }
+  return spw_rmap::MemoryRegionConfig{
+      .extended_address = static_cast<uint8_t>(*extended_address),
+      .address = static_cast<uint32_t>(*address),
+      .size = *size,
+      .backing_file = values.size() == 4 ? std::string(values[3]) : "",
+  };
+}
+
+auto parseOptions(int argc, char** argv) -> std::optional<Options> {
+  Options opts{};
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (!arg.starts_with("--")) {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      return std::nullopt;
+    }
+    auto name = arg.substr(2);
+
+    auto takeValue = [&](std::string_view opt) -> std::optional<std::string> {
+      if (i + 1 >= argc) {
+        std::cerr << "--" << opt << " requires a value.\n";
+        return std::nullopt;
+      }
+      return std::string(argv[++i]);
+    };
+
+    if (name == "ip") {
+      if (auto v = takeValue(name)) {
+        opts.ip = std::move(*v);
+      } else {
+        return std::nullopt;
+      }
+    } else if (name == "port") {
+      if (auto v = takeValue(name)) {
+        opts.port = std::move(*v);
+      } else {
+        return std::nullopt;
+      }
+    } else if (name == "region") {
+      auto region = parseRegion(argc, argv, i);
+      if (!region) {
+        return std::nullopt;
+      }
+      opts.regions.push_back(std::move(*region));
+    } else if (name == "workers") {
+      auto value = takeValue(name);
+      if (!value) {
+        return std::nullopt;
+      }
+      auto parsed = parseUnsigned(*value, 1024);
+      if (!parsed.has_value() || *parsed == 0) {
+        std::cerr << "Invalid --workers: '" << *value << "'\n";
+        return std::nullopt;
+      }
+      opts.workers = static_cast<std::size_t>(*parsed);
+    } else {
+      std::cerr << "Unknown option: --" << name << "\n";
+      return std::nullopt;
+    }
+  }
+
+  if (opts.regions.empty()) {
+    opts.regions.push_back({.extended_address = 0,
+                            .address = 0,
+                            .size = uint64_t{1} << 32,
+                            .backing_file = ""});
+  }
+  return opts;
+}
+
+// Serves one client after another until accepting fails.
+auto serveSequentially(const Options& opts,
+                       const std::shared_ptr<spw_rmap::MemoryTarget>& memory)
+    -> int {
+  spw_rmap::SpwRmapTCPServer server(
+      {.ip_address = opts.ip, .port = opts.port});
+  server.registerTarget(memory);
+  for (;;) {
+    if (!server.acceptOnce().has_value()) {
+      return 1;
+    }
+    std::cout << "Client connected\n" << std::flush;
+    auto res = server.runLoop();
+    if (!res.has_value()) {
+      std::cerr << "runLoop error: " << res.error().message() << "\n";
+    }
+    std::cout << "Client disconnected\n" << std::flush;
+    if (auto res = memory->sync(); !res.has_value()) {
+      std::cerr << "Failed to sync backing files: " << res.error().message()
+                << "\n";
+    }
+  }
+}
+
+#ifdef __linux__
+auto serveConcurrently(const Options& opts,
+                       const std::shared_ptr<spw_rmap::MemoryTarget>& memory)
+    -> int {
+  spw_rmap::SpwRmapTCPMultiServer server({.ip_address = opts.ip,
+                                          .port = opts.port,
+                                          .worker_threads = opts.workers});
+  server.registerTarget(memory);
+  if (!server.start().has_value()) {
+    return 1;
+  }
+  for (;;) {
+    std::this_thread::sleep_for(1s);
+    if (auto res = memory->sync(); !res.has_value()) {
+      std::cerr << "Failed to sync backing files: " << res.error().message()
+                << "\n";
+    }
+  }
+}
+#endif  // __linux__
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  for (int i = 1; i < argc; ++i) {
+    if (std::string_view(argv[i]) == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    }
+  }
+
+  auto options = parseOptions(argc, argv);
+  if (!options) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  const auto opts = std::move(*options);
+
+  auto memory = std::make_shared<spw_rmap::MemoryTarget>();
+  for (const auto& region : opts.regions) {
+    if (auto res = memory->addRegion(region); !res.has_value()) {
+      std::cerr << "Failed to map region at 0x" << std::hex
+                << static_cast<int>(region.extended_address) << ":"
+                << region.address << std::dec << ": "
+                << res.error().message() << "\n";
+      return 1;
+    }
+  }
+
+  std::cout << "Serving " << opts.regions.size() << " region(s) on "
+            << opts.ip << ":" << opts.port << "\n"
+            << std::flush;
+  if (opts.workers != 0) {
+#ifdef __linux__
+    return serveConcurrently(opts, memory);
+#else
+    std::cerr << "--workers is only supported on Linux.\n";
+    return 1;
+#endif
+  }
+  return serveSequentially(opts, memory);
+}
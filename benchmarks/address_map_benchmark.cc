@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "spw_rmap/address_map.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kReads = 2'000'000;
+constexpr uint32_t kStride = 0x1000;  // Each block is 256 bytes, 4 KiB apart
+
+auto makeBlocks(std::size_t count)
+    -> std::vector<std::shared_ptr<spw_rmap::RmapTarget>> {
+  std::vector<std::shared_ptr<spw_rmap::RmapTarget>> blocks;
+  for (std::size_t i = 0; i < count; ++i) {
+    blocks.push_back(std::make_shared<spw_rmap::CallbackTarget>(
+        spw_rmap::CallbackTarget::Callbacks{
+            .on_write = nullptr,
+            .on_read =
+                [i](const spw_rmap::Packet&, std::span<uint8_t> data) {
+                  data[0] = static_cast<uint8_t>(i);
+                  return spw_rmap::PacketStatusCode::
+                      CommandExecutedSuccessfully;
+                },
+            .on_read_modify_write = nullptr,
+        }));
+  }
+  return blocks;
+}
+
+// The hand-written dispatch the map replaces: test each block in turn.
+class LinearDispatch {
+ public:
+  explicit LinearDispatch(
+      std::vector<std::shared_ptr<spw_rmap::RmapTarget>> blocks)
+      : blocks_(std::move(blocks)) {}
+
+  auto read(const spw_rmap::Packet& packet, std::span<uint8_t> data)
+      -> spw_rmap::PacketStatusCode {
+    for (std::size_t i = 0; i < blocks_.size(); ++i) {
+      const uint32_t begin = static_cast<uint32_t>(i) * kStride;
+      if (packet.address >= begin &&
+          packet.address + data.size() <= begin + 0x100) {
+        return blocks_[i]->read(packet, data);
+      }
+    }
+    return spw_rmap::PacketStatusCode::
+        RMAPCommandNotImplementedOrNotAuthorised;
+  }
+
+ private:
+  std::vector<std::shared_ptr<spw_rmap::RmapTarget>> blocks_;
+};
+
+// Nanoseconds per 4-byte read spread evenly over the blocks.
+template <typename Dispatch>
+auto run(Dispatch& dispatch, std::size_t blocks) -> double {
+  std::array<uint8_t, 4> data{};
+  std::size_t checksum = 0;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kReads; ++i) {
+    // Multiplying by an odd number visits the blocks out of order.
+    const auto block = static_cast<uint32_t>((i * 2654435761U) % blocks);
+    const spw_rmap::Packet packet{.address = block * kStride + 0x10,
+                                  .dataLength = 4};
+    std::ignore = dispatch.read(packet, data);
+    checksum += data[0];
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      Clock::now() - start;
+  if (checksum == 0 && blocks > 1) {
+    std::cerr << "reads were not dispatched\n";
+  }
+  return elapsed.count() / kReads;
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(1)
+            << "blocks  AddressMap  linear  (ns/read)\n";
+  for (const std::size_t count : {8U, 64U, 512U}) {
+    auto blocks = makeBlocks(count);
+    spw_rmap::AddressMap map;
+    for (std::size_t i = 0; i < count; ++i) {
+      std::ignore = map.add({.extended_address = 0,
+                             .address = static_cast<uint32_t>(i) * kStride,
+                             .size = 0x100,
+                             .target = blocks[i]});
+    }
+    LinearDispatch linear(blocks);
+    std::cout << std::setw(6) << count << std::setw(12) << run(map, count)
+              << std::setw(8) << run(linear, count) << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "spw_rmap/inline_packet_builder.hh"
+#include "spw_rmap/packet_builder.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kIterations = 20'000'000;
+
+// Packets per second for `f`, called with a changing transaction ID.
+template <class F>
+auto measure(F&& f) -> double {
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kIterations; ++i) {
+    f(static_cast<uint16_t>(i));
+  }
+  const auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  return static_cast<double>(kIterations) / elapsed.count();
+}
+
+// Mirrors the node's send path: size the buffer, build, then size the frame.
+template <class Builder, class Config>
+auto sendPath(Builder& builder, Config config, std::span<uint8_t> out,
+              uint16_t transaction_id) -> uint8_t {
+  config.transactionID = transaction_id;
+  if (out.size() < builder.getTotalSize(config)) {
+    return 0;
+  }
+  auto res = builder.build(config, out);
+  if (!res.has_value()) {
+    return 0;
+  }
+  return out[builder.getTotalSize(config) - 1];
+}
+
+}  // namespace
+
+auto main() -> int {
+  const std::array<uint8_t, 3> target_address{0x03, 0x05, 0x07};
+  const std::array<uint8_t, 3> reply_address{0x02, 0x04, 0x06};
+  const std::array<uint8_t, 64> payload{};
+  const auto read_config = spw_rmap::ReadPacketConfig{
+      .targetSpaceWireAddress = target_address,
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0xFE,
+      .address = 0x44A00010,
+      .dataLength = 4,
+  };
+  const auto write_config = spw_rmap::WritePacketConfig{
+      .targetSpaceWireAddress = target_address,
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0xFE,
+      .address = 0x44A00010,
+      .data = payload,
+  };
+  std::vector<uint8_t> out(256);
+  static volatile uint8_t sink = 0;
+
+  spw_rmap::ReadPacketBuilder read_builder;
+  spw_rmap::WritePacketBuilder write_builder;
+  spw_rmap::PacketBuilderBase<spw_rmap::ReadPacketConfig>& virtual_read =
+      read_builder;
+  spw_rmap::PacketBuilderBase<spw_rmap::WritePacketConfig>& virtual_write =
+      write_builder;
+  spw_rmap::InlineReadPacketBuilder inline_read;
+  spw_rmap::InlineWritePacketBuilder inline_write;
+
+  const auto read_virtual = measure([&](uint16_t transaction_id) {
+    sink = sendPath(virtual_read, read_config, out, transaction_id);
+  });
+  const auto read_inline = measure([&](uint16_t transaction_id) {
+    sink = sendPath(inline_read, read_config, out, transaction_id);
+  });
+  const auto write_virtual = measure([&](uint16_t transaction_id) {
+    sink = sendPath(virtual_write, write_config, out, transaction_id);
+  });
+  const auto write_inline = measure([&](uint16_t transaction_id) {
+    sink = sendPath(inline_write, write_config, out, transaction_id);
+  });
+
+  std::cout << "packet build, Mpackets/s on one core\n\n";
+  std::cout << std::setw(24) << "" << std::setw(12) << "virtual"
+            << std::setw(12) << "inline" << '\n';
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::setw(24) << "read command" << std::setw(12)
+            << read_virtual / 1e6 << std::setw(12) << read_inline / 1e6
+            << '\n';
+  std::cout << std::setw(24) << "write command (64 B)" << std::setw(12)
+            << write_virtual / 1e6 << std::setw(12) << write_inline / 1e6
+            << '\n';
+  return 0;
+}
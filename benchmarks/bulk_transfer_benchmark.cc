@@ -0,0 +1,106 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kRegionSize = 16 * 1024 * 1024;
+constexpr std::size_t kChunkSize = 4096;
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  ::bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));  // NOLINT
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &sl);   // NOLINT
+  ::close(fd);
+  return std::to_string(ntohs(sin.sin_port));
+}
+
+// MiB/s reading `kRegionSize` bytes from a loopback target, either one
+// blocking `read` per chunk (`window` 0) or with `bulkRead`.
+auto run(std::size_t window) -> double {
+  const auto port = pickFreePort();
+  std::vector<uint8_t> memory(kRegionSize);
+  std::ranges::generate(memory, [n = 0U]() mutable {
+    return static_cast<uint8_t>(n++ * 7);
+  });
+  spw_rmap::SpwRmapTCPServer server({.ip_address = "127.0.0.1", .port = port});
+  server.registerOnRead([&memory](spw_rmap::Packet packet) {
+    const auto first = memory.begin() + packet.address;
+    return std::vector<uint8_t>(first, first + packet.dataLength);
+  });
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+  spw_rmap::SpwRmapTCPClient client({.ip_address = "127.0.0.1", .port = port});
+  while (!client.connect(100ms).has_value()) {
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread loop_thread([&client] { std::ignore = client.runLoop(); });
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+
+  std::vector<uint8_t> readback(kRegionSize);
+  bool ok = true;
+  const auto start = Clock::now();
+  if (window == 0) {
+    for (std::size_t offset = 0; offset < kRegionSize && ok;
+         offset += kChunkSize) {
+      ok = client
+               .read(target, static_cast<uint32_t>(offset),
+                     std::span(readback).subspan(offset, kChunkSize), 1s)
+               .has_value();
+    }
+  } else {
+    ok = client.bulkRead(target, 0, readback, kChunkSize, window).has_value();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  std::ignore = client.shutdown();
+  loop_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+  if (!ok || readback != memory) {
+    std::cerr << "read back wrong data\n";
+  }
+  return static_cast<double>(kRegionSize) / (1024.0 * 1024.0) /
+         elapsed.count();
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(1)
+            << "16 MiB in 4 KiB chunks\n"
+            << "read per chunk " << std::setw(8) << run(0) << " MiB/s\n";
+  for (const std::size_t window : {1UZ, 8UZ, 32UZ, 128UZ}) {
+    std::cout << "bulkRead x" << std::setw(3) << window << "  " << std::setw(8)
+              << run(window) << " MiB/s\n";
+  }
+  return 0;
+}
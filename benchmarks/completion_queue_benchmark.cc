@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/completion_queue.hh"
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kTransactions = 100'000;
+constexpr std::size_t kReadSize = 4;
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  ::bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));  // NOLINT
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &sl);   // NOLINT
+  ::close(fd);
+  return std::to_string(ntohs(sin.sin_port));
+}
+
+// One thread keeping `window` reads in flight through futures.
+auto runFutures(spw_rmap::SpwRmapTCPClient& client,
+                const std::shared_ptr<spw_rmap::TargetNodeBase>& target,
+                std::size_t window) -> std::size_t {
+  std::deque<std::future<std::expected<std::monostate, std::error_code>>>
+      in_flight;
+  std::size_t failures = 0;
+  for (std::size_t issued = 0; issued < kTransactions || !in_flight.empty();) {
+    while (issued < kTransactions && in_flight.size() < window) {
+      in_flight.push_back(client.readAsync(target, 0, kReadSize,
+                                           [](const spw_rmap::Packet&) {}));
+      ++issued;
+    }
+    failures += !in_flight.front().get().has_value();
+    in_flight.pop_front();
+  }
+  return failures;
+}
+
+// One thread keeping `window` reads in flight through a completion queue.
+auto runQueue(spw_rmap::SpwRmapTCPClient& client,
+              const std::shared_ptr<spw_rmap::TargetNodeBase>& target,
+              std::size_t window) -> std::size_t {
+  spw_rmap::CompletionQueue queue(window);
+  std::vector<std::array<uint8_t, kReadSize>> buffers(queue.capacity());
+  std::vector<spw_rmap::RmapRequest> requests(queue.capacity());
+  std::vector<spw_rmap::RmapCompletion> completions(queue.capacity());
+  std::vector<std::size_t> free_buffers;
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    free_buffers.push_back(i);
+  }
+  std::size_t failures = 0;
+  std::size_t issued = 0;
+  std::size_t reaped = 0;
+  while (reaped < kTransactions) {
+    std::size_t batch = 0;
+    while (issued + batch < kTransactions && batch < free_buffers.size() &&
+           queue.outstanding() + batch < window) {
+      const auto buffer = free_buffers[free_buffers.size() - 1 - batch];
+      requests[batch] = {.operation = spw_rmap::RmapOperation::Read,
+                         .target_node = target,
+                         .read_data = buffers[buffer],
+                         .user_data = buffer};
+      ++batch;
+    }
+    const auto accepted =
+        client.submit(queue, std::span(requests).first(batch));
+    free_buffers.resize(free_buffers.size() - accepted);
+    issued += accepted;
+    const auto count = queue.reap(completions, 1);
+    for (std::size_t i = 0; i < count; ++i) {
+      failures += static_cast<std::size_t>(
+          static_cast<bool>(completions[i].error));
+      free_buffers.push_back(completions[i].user_data);
+    }
+    reaped += count;
+  }
+  return failures;
+}
+
+template <class Run>
+auto measure(std::size_t window, Run&& run) -> double {
+  const auto port = pickFreePort();
+  spw_rmap::SpwRmapTCPServer server({.ip_address = "127.0.0.1", .port = port});
+  server.registerOnRead([](spw_rmap::Packet packet) {
+    return std::vector<uint8_t>(packet.dataLength);
+  });
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+  spw_rmap::SpwRmapTCPClient client({
+      .ip_address = "127.0.0.1",
+      .port = port,
+      .transaction_id_min = 0x0000,
+      .transaction_id_max = 0x10000,
+      .use_writer_thread = true,
+  });
+  while (!client.connect(100ms).has_value()) {
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread loop_thread([&client] { std::ignore = client.runLoop(); });
+  client.setTimeout(5s);
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+
+  const auto start = Clock::now();
+  const auto failures = run(client, target, window);
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  std::ignore = client.shutdown();
+  loop_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+  if (failures > 0) {
+    std::cerr << failures << " reads failed\n";
+  }
+  return static_cast<double>(kTransactions) / elapsed.count();
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(0);
+  for (const std::size_t window : {16UZ, 256UZ, 1024UZ}) {
+    std::cout << std::setw(5) << window << " in flight  futures "
+              << std::setw(9) << measure(window, runFutures)
+              << " reads/s  completion queue " << std::setw(9)
+              << measure(window, runQueue) << " reads/s\n";
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "spw_rmap/crc.hh"
+#include "spw_rmap/packet_builder.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kBytesPerMeasurement = std::size_t{512} << 20;
+
+template <class F>
+auto measure(std::size_t bytes_per_call, F&& f) -> double {
+  const std::size_t iterations =
+      std::max<std::size_t>(1, kBytesPerMeasurement / bytes_per_call);
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    f();
+  }
+  const auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  return static_cast<double>(iterations * bytes_per_call) / elapsed.count() /
+         1e9;
+}
+
+}  // namespace
+
+auto main() -> int {
+  constexpr std::size_t kMaxSize = std::size_t{1} << 20;
+  std::vector<uint8_t> src(kMaxSize);
+  std::vector<uint8_t> dst(kMaxSize + 64);
+  std::mt19937 rng(std::random_device{}());
+  std::uniform_int_distribution<int> dist(0, 0xFF);
+  for (auto& byte : src) {
+    byte = static_cast<uint8_t>(dist(rng));
+  }
+  static volatile uint8_t sink = 0;
+
+  std::cout << "copy + CRC ["
+            << spw_rmap::crc::getKernelName(spw_rmap::crc::getActiveKernel())
+            << "], GB/s of payload\n\n";
+  std::cout << std::setw(10) << "bytes" << std::setw(14) << "two-pass"
+            << std::setw(14) << "fused" << '\n';
+  for (std::size_t size = 64; size <= kMaxSize; size *= 4) {
+    const auto in = std::span<const uint8_t>(src).first(size);
+    const auto two_pass = measure(size, [&] {
+      std::memcpy(dst.data(), in.data(), in.size());
+      sink = spw_rmap::crc::calcCRC(in);
+    });
+    const auto fused =
+        measure(size, [&] { sink = spw_rmap::crc::copyAndCalcCRC(in, dst); });
+    std::cout << std::setw(10) << size << std::setw(14) << std::fixed
+              << std::setprecision(3) << two_pass << std::setw(14) << fused
+              << '\n';
+  }
+
+  // Full 64 KiB write command through WritePacketBuilder.
+  const std::array<uint8_t, 2> target_address{0x03, 0x05};
+  const std::array<uint8_t, 2> reply_address{0x02, 0x04};
+  const auto config = spw_rmap::WritePacketConfig{
+      .targetSpaceWireAddress = target_address,
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0xFE,
+      .data = std::span<const uint8_t>(src).first(64 * 1024),
+  };
+  spw_rmap::WritePacketBuilder builder;
+  const auto total = builder.getTotalSize(config);
+  const auto build_rate = measure(total, [&] {
+    auto res = builder.build(config, dst);
+    sink = res.has_value() ? dst[*res - 1] : 0;
+  });
+  std::cout << "\nWritePacketBuilder::build (64 KiB payload): " << std::fixed
+            << std::setprecision(3) << build_rate << " GB/s\n";
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "spw_rmap/crc.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using spw_rmap::crc::Kernel;
+
+constexpr std::array<Kernel, 4> kKernels = {
+    Kernel::Reference, Kernel::Slicing8, Kernel::Slicing16,
+    Kernel::CarrylessMultiply};
+
+// Each measurement processes at least this many bytes.
+constexpr std::size_t kBytesPerMeasurement = std::size_t{256} << 20;
+
+auto measure(Kernel kernel, std::span<const uint8_t> data) -> double {
+  const std::size_t iterations =
+      std::max<std::size_t>(1, kBytesPerMeasurement / data.size());
+  uint8_t sink = 0;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    sink = spw_rmap::crc::calcCRCWith(kernel, data, sink);
+  }
+  const auto elapsed = std::chrono::duration<double>(Clock::now() - start);
+  static volatile uint8_t guard = 0;
+  guard = sink;
+  return static_cast<double>(iterations * data.size()) / elapsed.count() /
+         1e9;
+}
+
+}  // namespace
+
+auto main() -> int {
+  constexpr std::size_t kMaxSize = std::size_t{16} << 20;
+  std::vector<uint8_t> data(kMaxSize);
+  std::mt19937 rng(std::random_device{}());
+  std::uniform_int_distribution<int> dist(0, 0xFF);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(dist(rng));
+  }
+
+  std::cout << "active kernel: "
+            << spw_rmap::crc::getKernelName(spw_rmap::crc::getActiveKernel())
+            << "\n\n";
+  std::cout << std::setw(10) << "bytes";
+  for (auto kernel : kKernels) {
+    std::cout << std::setw(22) << spw_rmap::crc::getKernelName(kernel);
+  }
+  std::cout << "   [GB/s]\n";
+
+  for (std::size_t size = 8; size <= kMaxSize; size *= 2) {
+    const auto input = std::span<const uint8_t>(data).first(size);
+    const auto expected = spw_rmap::crc::calcCRCWith(Kernel::Reference, input);
+    std::cout << std::setw(10) << size;
+    for (auto kernel : kKernels) {
+      if (!spw_rmap::crc::isKernelSupported(kernel)) {
+        std::cout << std::setw(22) << "n/a";
+        continue;
+      }
+      if (spw_rmap::crc::calcCRCWith(kernel, input) != expected) {
+        std::cerr << "\nCRC mismatch for "
+                  << spw_rmap::crc::getKernelName(kernel) << " at " << size
+                  << " bytes\n";
+        return 1;
+      }
+      std::cout << std::setw(22) << std::fixed << std::setprecision(3)
+                << measure(kernel, input);
+    }
+    std::cout << '\n';
+  }
+  return 0;
+}
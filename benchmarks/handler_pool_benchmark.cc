@@ -0,0 +1,186 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spw_rmap/internal/spw_rmap_tcp_node_impl.hh"
+#include "spw_rmap/packet_builder.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kCommands = 256;  // Distinct commands in the stream
+constexpr std::size_t kReads = 4'000;
+constexpr std::size_t kSlowEvery = 8;  // One command in 8 waits on "disk"
+constexpr auto kSlowFor = 200us;
+
+// Backend that replays a stream of Read commands forever and discards
+// replies, so only the target side of a read is measured.
+class ReplayBackend {
+ public:
+  ReplayBackend(std::string ip, std::string port)
+      : ip_address_(std::move(ip)), port_(std::move(port)) {}
+
+  auto getIpAddress() const noexcept -> const std::string& {
+    return ip_address_;
+  }
+  auto setIpAddress(std::string ip_address) noexcept -> void {
+    ip_address_ = std::move(ip_address);
+  }
+  auto getPort() const noexcept -> const std::string& { return port_; }
+  auto setPort(std::string port) noexcept -> void { port_ = std::move(port); }
+
+  auto setSendTimeout(std::chrono::microseconds /*timeout*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  auto sendAll(std::span<const uint8_t> /*data*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  auto sendAllv(std::span<const std::span<const uint8_t>> /*buffers*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  auto recvSome(std::span<uint8_t> buffer) noexcept
+      -> std::expected<std::size_t, std::error_code> {
+    const auto count = std::min(buffer.size(), stream_.size() - read_pos_);
+    std::copy_n(stream_.begin() + static_cast<std::ptrdiff_t>(read_pos_),
+                count, buffer.begin());
+    read_pos_ = (read_pos_ + count) % stream_.size();
+    return count;
+  }
+
+  auto shutdown() noexcept -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  void replay(std::vector<uint8_t> stream) {
+    stream_ = std::move(stream);
+    read_pos_ = 0;
+  }
+
+ private:
+  std::string ip_address_;
+  std::string port_;
+  std::vector<uint8_t> stream_;
+  std::size_t read_pos_ = 0;
+};
+
+class ReplayNode
+    : public spw_rmap::internal::SpwRmapTCPNodeImpl<ReplayBackend> {
+  using Base = spw_rmap::internal::SpwRmapTCPNodeImpl<ReplayBackend>;
+
+ public:
+  explicit ReplayNode(spw_rmap::SpwRmapTCPNodeConfig config)
+      : Base(std::move(config)) {}
+
+  auto backend() -> ReplayBackend& { return *getBackend_(); }
+
+  auto shutdown() noexcept
+      -> std::expected<std::monostate, std::error_code> override {
+    return std::monostate{};
+  }
+
+  auto isShutdowned() noexcept -> bool override { return false; }
+};
+
+auto readCommands() -> std::vector<uint8_t> {
+  std::vector<uint8_t> stream;
+  const std::array<uint8_t, 1> reply_address{0x01};
+  spw_rmap::ReadPacketBuilder builder;
+  for (std::size_t i = 0; i < kCommands; ++i) {
+    const auto config = spw_rmap::ReadPacketConfig{
+        .replyAddress = reply_address,
+        .targetLogicalAddress = 0xFE,
+        .initiatorLogicalAddress = 0x34,
+        .transactionID = static_cast<uint16_t>(i),
+        .address = static_cast<uint32_t>(i),
+        .dataLength = 16,
+    };
+    const auto size = builder.getTotalSize(config);
+    const auto offset = stream.size();
+    stream.resize(offset + 12 + size, 0);
+    for (std::size_t b = 0; b < 8; ++b) {
+      stream[offset + 4 + b] =
+          static_cast<uint8_t>(static_cast<uint64_t>(size) >> (56 - 8 * b));
+    }
+    std::ignore = builder.build(
+        config, std::span(stream).subspan(offset + 12, size));
+  }
+  return stream;
+}
+
+struct Result {
+  double commands_per_second = 0.0;
+  double max_poll_us = 0.0;  // Longest a single poll kept the link waiting
+};
+
+auto run(std::size_t handler_threads) -> Result {
+  spw_rmap::SpwRmapTCPNodeConfig config;
+  config.ip_address = "127.0.0.1";
+  config.port = "0";
+  config.handler_threads = handler_threads;
+  config.recv_pool_size = 64;
+  ReplayNode node(config);
+  node.registerOnReadInto(
+      [](spw_rmap::Packet packet, std::span<uint8_t> data) {
+        if (packet.address % kSlowEvery == 0) {
+          std::this_thread::sleep_for(kSlowFor);
+        }
+        std::ranges::fill(data, static_cast<uint8_t>(packet.address));
+        return spw_rmap::PacketStatusCode::CommandExecutedSuccessfully;
+      });
+  node.backend().replay(readCommands());
+
+  Result result;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kReads; ++i) {
+    const auto poll_start = Clock::now();
+    if (!node.poll().has_value()) {
+      std::cerr << "poll failed\n";
+      return {};
+    }
+    const std::chrono::duration<double, std::micro> poll_time =
+        Clock::now() - poll_start;
+    result.max_poll_us = std::max(result.max_poll_us, poll_time.count());
+  }
+  while (node.getIoStatistics().packets_sent < kReads) {
+    std::this_thread::yield();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  result.commands_per_second = kReads / elapsed.count();
+  return result;
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << "One Read command in " << kSlowEvery << " takes "
+            << kSlowFor.count() << " us to serve\n"
+            << "handler_threads  commands/s  max poll (us)\n"
+            << std::fixed << std::setprecision(1);
+  for (const std::size_t threads : {0U, 1U, 4U, 16U}) {
+    const auto result = run(threads);
+    std::cout << std::setw(15) << threads << std::setw(12)
+              << result.commands_per_second << std::setw(15)
+              << result.max_poll_us << "\n";
+  }
+  return 0;
+}
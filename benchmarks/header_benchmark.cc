@@ -0,0 +1,82 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "spw_rmap/packet_builder.hh"
+#include "spw_rmap/static_packet.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kIterations = 20'000'000;
+
+template <class F>
+auto measure(F&& f) -> double {
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kIterations; ++i) {
+    f(static_cast<uint16_t>(i));
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() -
+                                                                start);
+  return elapsed.count() / static_cast<double>(kIterations);
+}
+
+}  // namespace
+
+auto main() -> int {
+  const spw_rmap::TargetNodeDynamic target(0xFE, {0x03, 0x05, 0x07},
+                                           {0x02, 0x04, 0x06});
+  const spw_rmap::TargetNodeBase& base = target;
+  constexpr auto command = spw_rmap::makeReadCommand(
+      std::array<uint8_t, 3>{0x03, 0x05, 0x07},
+      std::array<uint8_t, 3>{0x02, 0x04, 0x06}, 0xFE, 0x44A00010, 4);
+  std::vector<uint8_t> out(256);
+  static volatile uint8_t sink = 0;
+
+  spw_rmap::ReadPacketBuilder builder;
+  const auto built = measure([&](uint16_t transaction_id) {
+    auto config = spw_rmap::ReadPacketConfig{
+        .targetSpaceWireAddress = base.getTargetSpaceWireAddress(),
+        .replyAddress = base.getReplyAddress(),
+        .targetLogicalAddress = base.getTargetLogicalAddress(),
+        .transactionID = transaction_id,
+        .address = 0x44A00010,
+        .dataLength = 4,
+    };
+    auto res = builder.build(config, out);
+    sink = res.has_value() ? out[*res - 1] : 0;
+  });
+
+  const auto templated = measure([&](uint16_t transaction_id) {
+    const auto path = base.getTargetSpaceWireAddress();
+    std::ranges::copy(path, out.begin());
+    const auto size = base.getCommandHeader().writeTo(
+        std::span(out).subspan(path.size()),
+        spw_rmap::CommandHeaderTemplate::Kind::Read, 0xFE, transaction_id,
+        0x00, 0x44A00010, 4);
+    sink = out[path.size() + size - 1];
+  });
+
+  const auto prebuilt = measure([&](uint16_t transaction_id) {
+    sink = out[command.writeTo(out, transaction_id) - 1];
+  });
+
+  std::cout << "read command header, ns per packet\n\n";
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << std::setw(28) << "ReadPacketBuilder::build" << std::setw(10)
+            << built << '\n';
+  std::cout << std::setw(28) << "CommandHeaderTemplate" << std::setw(10)
+            << templated << '\n';
+  std::cout << std::setw(28) << "StaticReadCommand" << std::setw(10)
+            << prebuilt << '\n';
+  return 0;
+}
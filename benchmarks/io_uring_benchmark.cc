@@ -0,0 +1,204 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <iostream>
+
+#ifdef __linux__
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/internal/io_uring_client.hh"
+#include "spw_rmap/internal/tcp_client.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kPingPongCount = 20'000;
+constexpr std::size_t kMessageSize = 24;  // A write reply in its frame
+constexpr std::size_t kStreamCount = 1'000'000;
+
+enum class Mode : uint8_t {
+  Echo,    // Send every received byte back
+  Stream,  // Send kStreamCount messages, then close
+};
+
+struct Result {
+  double wall_us_per_message;
+  double sys_us_per_message;
+};
+
+auto threadSystemTime() -> std::chrono::duration<double, std::micro> {
+  rusage usage{};
+  ::getrusage(RUSAGE_THREAD, &usage);
+  return std::chrono::seconds(usage.ru_stime.tv_sec) +
+         std::chrono::microseconds(usage.ru_stime.tv_usec);
+}
+
+// Loopback peer serving one connection in `mode`.
+class Peer {
+ public:
+  explicit Peer(Mode mode) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t sl = sizeof(sin);
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+           sizeof(sin));
+    ::listen(listen_fd_, 1);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                  &sl);
+    port_ = std::to_string(ntohs(sin.sin_port));
+    thread_ = std::thread([this, mode] { serve(mode); });
+  }
+
+  Peer(const Peer&) = delete;
+  auto operator=(const Peer&) -> Peer& = delete;
+
+  ~Peer() {
+    thread_.join();
+    ::close(listen_fd_);
+  }
+
+  [[nodiscard]] auto port() const -> const std::string& { return port_; }
+
+ private:
+  auto serve(Mode mode) const -> void {
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (mode == Mode::Echo) {
+      std::array<uint8_t, 4096> buf{};
+      for (;;) {
+        const auto n = ::recv(fd, buf.data(), buf.size(), 0);
+        if (n <= 0 || ::send(fd, buf.data(), static_cast<std::size_t>(n),
+                             MSG_NOSIGNAL) != n) {
+          break;
+        }
+      }
+    } else {
+      std::vector<uint8_t> burst(kMessageSize * 256, 0x5A);
+      for (std::size_t sent = 0; sent < kStreamCount; sent += 256) {
+        if (::send(fd, burst.data(), burst.size(), MSG_NOSIGNAL) < 0) {
+          break;
+        }
+      }
+    }
+    ::close(fd);
+  }
+
+  int listen_fd_ = -1;
+  std::string port_;
+  std::thread thread_;
+};
+
+template <class Client>
+auto recvExact(Client& client, std::span<uint8_t> buf) -> bool {
+  while (!buf.empty()) {
+    auto res = client.recvSome(buf);
+    if (!res.has_value()) {
+      return false;
+    }
+    buf = buf.subspan(*res);
+  }
+  return true;
+}
+
+// Round trip of one message, as in a blocking `write`.
+template <class Client>
+auto pingPong() -> Result {
+  Peer peer(Mode::Echo);
+  Client client("127.0.0.1", peer.port());
+  if (!client.connect().has_value()) {
+    return {};
+  }
+  std::array<uint8_t, kMessageSize> message{};
+  std::array<uint8_t, kMessageSize> reply{};
+  const auto sys_start = threadSystemTime();
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kPingPongCount; ++i) {
+    message[0] = static_cast<uint8_t>(i);
+    if (!client.sendAll(message).has_value() || !recvExact(client, reply)) {
+      return {};
+    }
+  }
+  const std::chrono::duration<double, std::micro> wall = Clock::now() - start;
+  const auto sys = threadSystemTime() - sys_start;
+  client.disconnect();
+  return {wall.count() / kPingPongCount, sys.count() / kPingPongCount};
+}
+
+// Receiving a stream of replies message by message, as the receive thread
+// does under a write storm.
+template <class Client>
+auto stream() -> Result {
+  Peer peer(Mode::Stream);
+  Client client("127.0.0.1", peer.port());
+  if (!client.connect().has_value()) {
+    return {};
+  }
+  std::array<uint8_t, kMessageSize> message{};
+  const auto sys_start = threadSystemTime();
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kStreamCount; ++i) {
+    if (!recvExact(client, message)) {
+      return {};
+    }
+  }
+  const std::chrono::duration<double, std::micro> wall = Clock::now() - start;
+  const auto sys = threadSystemTime() - sys_start;
+  client.disconnect();
+  return {wall.count() / kStreamCount, sys.count() / kStreamCount};
+}
+
+auto print(const char* name, const Result& result) -> void {
+  std::cout << std::left << std::setw(28) << name << std::right
+            << std::setw(10) << result.wall_us_per_message << " us/msg"
+            << std::setw(10) << result.sys_us_per_message << " sys us/msg\n";
+}
+
+}  // namespace
+
+auto main() -> int {
+  using spw_rmap::internal::IoUringClient;
+  using spw_rmap::internal::TCPClient;
+
+  std::cout << std::fixed << std::setprecision(3);
+  print("ping-pong TCPClient", pingPong<TCPClient>());
+  if (IoUringClient::isSupported()) {
+    print("ping-pong IoUringClient", pingPong<IoUringClient>());
+  }
+  print("stream TCPClient", stream<TCPClient>());
+  if (IoUringClient::isSupported()) {
+    print("stream IoUringClient", stream<IoUringClient>());
+  } else {
+    std::cout << "io_uring is not available, skipped IoUringClient\n";
+  }
+  return 0;
+}
+
+#else
+
+auto main() -> int {
+  std::cout << "io_uring is Linux only\n";
+  return 0;
+}
+
+#endif  // __linux__
@@ -0,0 +1,129 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <iostream>
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/spw_rmap_tcp_multi_server.hh"
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kTransactions = 40000;  // Split over the clients
+
+struct Result {
+  double transactions_per_second = 0.0;
+  double mean_latency_us = 0.0;
+  std::size_t failures = 0;
+};
+
+// Every client reads a 4-byte register back to back; the clients run
+// concurrently against one server with `workers` epoll workers.
+auto run(std::size_t clients, std::size_t workers) -> Result {
+  spw_rmap::SpwRmapTCPMultiServer server(
+      {.ip_address = "127.0.0.1", .port = "0", .worker_threads = workers});
+  server.registerOnRead([](spw_rmap::Packet packet) {
+    return std::vector<uint8_t>(packet.dataLength,
+                                static_cast<uint8_t>(packet.address));
+  });
+  if (!server.start().has_value()) {
+    return {};
+  }
+
+  const auto per_client = kTransactions / clients;
+  std::atomic<std::size_t> ready{0};
+  std::atomic<bool> go{false};
+  std::atomic<std::size_t> failures{0};
+  std::vector<std::thread> threads;
+  threads.reserve(clients);
+  for (std::size_t c = 0; c < clients; ++c) {
+    threads.emplace_back([&, c] {
+      spw_rmap::SpwRmapTCPClient client(
+          {.ip_address = "127.0.0.1", .port = server.getPort()});
+      while (!client.connect(100ms).has_value()) {
+        std::this_thread::sleep_for(1ms);
+      }
+      std::thread loop([&client] { std::ignore = client.runLoop(); });
+      auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+          0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+      std::array<uint8_t, 4> value{};
+      ready.fetch_add(1);
+      while (!go.load()) {
+        std::this_thread::yield();
+      }
+      for (std::size_t i = 0; i < per_client; ++i) {
+        if (!client.read(target, static_cast<uint32_t>(c * 4), value, 1s)
+                 .has_value()) {
+          failures.fetch_add(1);
+        }
+      }
+      std::ignore = client.shutdown();
+      loop.join();
+    });
+  }
+  while (ready.load() < clients) {
+    std::this_thread::sleep_for(1ms);
+  }
+  const auto start = Clock::now();
+  go.store(true);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  std::ignore = server.shutdown();
+
+  const auto total = static_cast<double>(per_client * clients);
+  return {
+      .transactions_per_second = total / elapsed.count(),
+      // Each client has one transaction in flight at a time.
+      .mean_latency_us =
+          elapsed.count() * 1e6 * static_cast<double>(clients) / total,
+      .failures = failures.load(),
+  };
+}
+
+}  // namespace
+
+auto main() -> int {
+  const std::size_t workers =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  std::cout << std::fixed << std::setprecision(1) << workers
+            << " epoll workers, " << kTransactions
+            << " 4-byte reads in total\n";
+  for (const std::size_t clients : {1, 8, 64}) {
+    const auto result = run(clients, workers);
+    std::cout << std::setw(3) << clients << " clients " << std::setw(10)
+              << result.transactions_per_second << " reads/s "
+              << std::setw(8) << result.mean_latency_us << " us/read";
+    if (result.failures != 0) {
+      std::cout << " (" << result.failures << " failed)";
+    }
+    std::cout << "\n";
+  }
+  return 0;
+}
+
+#else
+
+auto main() -> int {
+  std::cout << "The multi-client server is Linux only\n";
+  return 0;
+}
+
+#endif  // __linux__
@@ -0,0 +1,196 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spw_rmap/internal/spw_rmap_tcp_node_impl.hh"
+#include "spw_rmap/memory_target.hh"
+#include "spw_rmap/packet_builder.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kCommands = 256;  // Distinct commands in the stream
+constexpr std::size_t kReads = 200'000;
+
+// Backend that replays a stream of Read commands forever and discards
+// replies, so only the target side of a read is measured.
+class ReplayBackend {
+ public:
+  ReplayBackend(std::string ip, std::string port)
+      : ip_address_(std::move(ip)), port_(std::move(port)) {}
+
+  auto getIpAddress() const noexcept -> const std::string& {
+    return ip_address_;
+  }
+  auto setIpAddress(std::string ip_address) noexcept -> void {
+    ip_address_ = std::move(ip_address);
+  }
+  auto getPort() const noexcept -> const std::string& { return port_; }
+  auto setPort(std::string port) noexcept -> void { port_ = std::move(port); }
+
+  auto setSendTimeout(std::chrono::microseconds /*timeout*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  auto sendAll(std::span<const uint8_t> data) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    sent_bytes_ += data.size();
+    return std::monostate{};
+  }
+
+  auto sendAllv(std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    for (const auto& buffer : buffers) {
+      sent_bytes_ += buffer.size();
+    }
+    return std::monostate{};
+  }
+
+  auto recvSome(std::span<uint8_t> buffer) noexcept
+      -> std::expected<std::size_t, std::error_code> {
+    const auto count = std::min(buffer.size(), stream_.size() - read_pos_);
+    std::copy_n(stream_.begin() + static_cast<std::ptrdiff_t>(read_pos_),
+                count, buffer.begin());
+    read_pos_ = (read_pos_ + count) % stream_.size();
+    return count;
+  }
+
+  auto shutdown() noexcept -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  void replay(std::vector<uint8_t> stream) {
+    stream_ = std::move(stream);
+    read_pos_ = 0;
+  }
+
+  [[nodiscard]] auto sentBytes() const noexcept -> std::size_t {
+    return sent_bytes_;
+  }
+
+ private:
+  std::string ip_address_;
+  std::string port_;
+  std::vector<uint8_t> stream_;
+  std::size_t read_pos_ = 0;
+  std::size_t sent_bytes_ = 0;
+};
+
+class ReplayNode
+    : public spw_rmap::internal::SpwRmapTCPNodeImpl<ReplayBackend> {
+  using Base = spw_rmap::internal::SpwRmapTCPNodeImpl<ReplayBackend>;
+
+ public:
+  explicit ReplayNode(spw_rmap::SpwRmapTCPNodeConfig config)
+      : Base(std::move(config)) {}
+
+  auto backend() -> ReplayBackend& { return *getBackend_(); }
+
+  auto shutdown() noexcept
+      -> std::expected<std::monostate, std::error_code> override {
+    return std::monostate{};
+  }
+
+  auto isShutdowned() noexcept -> bool override { return false; }
+};
+
+auto readCommands(uint32_t length) -> std::vector<uint8_t> {
+  std::vector<uint8_t> stream;
+  const std::array<uint8_t, 1> reply_address{0x01};
+  spw_rmap::ReadPacketBuilder builder;
+  for (std::size_t i = 0; i < kCommands; ++i) {
+    const auto config = spw_rmap::ReadPacketConfig{
+        .replyAddress = reply_address,
+        .targetLogicalAddress = 0xFE,
+        .initiatorLogicalAddress = 0x34,
+        .transactionID = static_cast<uint16_t>(i),
+        .address = static_cast<uint32_t>(i * length),
+        .dataLength = length,
+    };
+    const auto size = builder.getTotalSize(config);
+    const auto offset = stream.size();
+    stream.resize(offset + 12 + size, 0);
+    for (std::size_t b = 0; b < 8; ++b) {
+      stream[offset + 4 + b] =
+          static_cast<uint8_t>(static_cast<uint64_t>(size) >> (56 - 8 * b));
+    }
+    std::ignore = builder.build(
+        config, std::span(stream).subspan(offset + 12, size));
+  }
+  return stream;
+}
+
+enum class Handler { Read, ReadInto, MemoryTarget };
+
+// Nanoseconds per Read command served by `poll` for reads of `length`
+// bytes from a register file.
+auto run(uint32_t length, Handler handler) -> double {
+  std::vector<uint8_t> registers(kCommands * length);
+  for (std::size_t i = 0; i < registers.size(); ++i) {
+    registers[i] = static_cast<uint8_t>(i);
+  }
+  spw_rmap::SpwRmapTCPNodeConfig config;
+  config.ip_address = "127.0.0.1";
+  config.port = "0";
+  ReplayNode node(config);
+  auto memory = std::make_shared<spw_rmap::MemoryTarget>();
+  if (handler == Handler::MemoryTarget) {
+    if (!memory->addRegion({.size = registers.size()}).has_value()) {
+      return 0.0;
+    }
+    std::ranges::copy(registers, memory->view(0, 0, registers.size()).begin());
+    node.registerTarget(memory);
+  } else if (handler == Handler::ReadInto) {
+    node.registerOnReadInto(
+        [&registers](spw_rmap::Packet packet, std::span<uint8_t> data) {
+          std::copy_n(registers.begin() + packet.address, data.size(),
+                      data.begin());
+          return spw_rmap::PacketStatusCode::CommandExecutedSuccessfully;
+        });
+  } else {
+    node.registerOnRead([&registers](spw_rmap::Packet packet) {
+      const auto begin = registers.begin() + packet.address;
+      return std::vector<uint8_t>(begin, begin + packet.dataLength);
+    });
+  }
+  node.backend().replay(readCommands(length));
+
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kReads; ++i) {
+    if (!node.poll().has_value()) {
+      std::cerr << "poll failed\n";
+      return 0.0;
+    }
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      Clock::now() - start;
+  return elapsed.count() / kReads;
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(1)
+            << "length  registerOnRead  registerOnReadInto  MemoryTarget"
+               "  (ns/read)\n";
+  for (const uint32_t length : {4U, 256U, 4096U}) {
+    std::cout << std::setw(6) << length << std::setw(16)
+              << run(length, Handler::Read) << std::setw(20)
+              << run(length, Handler::ReadInto) << std::setw(14)
+              << run(length, Handler::MemoryTarget) << "\n";
+  }
+  return 0;
+}
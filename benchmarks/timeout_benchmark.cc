@@ -0,0 +1,145 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kTransactions = 10'000;
+constexpr auto kTimeout = 500us;
+
+// Loopback peer that accepts one connection and never replies.
+class SilentPeer {
+ public:
+  SilentPeer() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t sl = sizeof(sin);
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+           sizeof(sin));
+    ::listen(listen_fd_, 1);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                  &sl);
+    port_ = std::to_string(ntohs(sin.sin_port));
+    thread_ = std::thread([this] {
+      const int fd = ::accept(listen_fd_, nullptr, nullptr);
+      std::array<uint8_t, 64 * 1024> buf{};
+      while (fd >= 0 && ::recv(fd, buf.data(), buf.size(), 0) > 0) {
+      }
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    });
+  }
+
+  SilentPeer(const SilentPeer&) = delete;
+  auto operator=(const SilentPeer&) -> SilentPeer& = delete;
+
+  ~SilentPeer() {
+    thread_.join();
+    ::close(listen_fd_);
+  }
+
+  [[nodiscard]] auto port() const -> const std::string& { return port_; }
+
+ private:
+  int listen_fd_ = -1;
+  std::string port_;
+  std::thread thread_;
+};
+
+auto percentile(std::vector<double>& values, double p) -> double {
+  const auto n = static_cast<std::size_t>(
+      p * static_cast<double>(values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + n, values.end());
+  return values[n];
+}
+
+}  // namespace
+
+auto main() -> int {
+  SilentPeer peer;
+  spw_rmap::SpwRmapTCPClient client({
+      .ip_address = "127.0.0.1",
+      .port = peer.port(),
+      .transaction_id_min = 0x0000,
+      .transaction_id_max = kTransactions,
+      .timeout_resolution = 100us,
+  });
+  if (!client.connect(1s).has_value()) {
+    std::cerr << "connect failed\n";
+    return 1;
+  }
+  std::thread loop_thread([&client] { std::ignore = client.runLoop(); });
+  client.setTimeout(kTimeout);
+
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+  const std::array<uint8_t, 4> payload{};
+  std::vector<Clock::time_point> deadlines(kTransactions);
+  std::vector<std::future<std::expected<std::monostate, std::error_code>>>
+      futures(kTransactions);
+  std::atomic<std::size_t> issued{0};
+
+  // Deadlines are in issue order, so waiting in order observes each expiry
+  // no earlier than it happened; the lateness is an upper bound.
+  std::vector<double> late_us;
+  std::size_t timed_out = 0;
+  std::thread observer([&] {
+    for (std::size_t i = 0; i < kTransactions; ++i) {
+      while (issued.load(std::memory_order_acquire) <= i) {
+        std::this_thread::yield();
+      }
+      auto res = futures[i].get();
+      const std::chrono::duration<double, std::micro> late =
+          Clock::now() - deadlines[i];
+      late_us.push_back(late.count());
+      timed_out += !res.has_value() && res.error() == std::errc::timed_out;
+    }
+  });
+
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kTransactions; ++i) {
+    deadlines[i] = Clock::now() + kTimeout;
+    futures[i] = client.writeAsync(target, 0, payload,
+                                   [](const spw_rmap::Packet&) {});
+    issued.store(i + 1, std::memory_order_release);
+  }
+  const std::chrono::duration<double, std::milli> issue = Clock::now() - start;
+  observer.join();
+
+  std::ignore = client.shutdown();
+  loop_thread.join();
+
+  std::cout << std::fixed << std::setprecision(1) << kTransactions
+            << " transactions, " << kTimeout.count()
+            << " us timeout, issued in " << issue.count() << " ms\n"
+            << "timed out: " << timed_out << "\n"
+            << "lateness p50 " << percentile(late_us, 0.5) << " us, p99 "
+            << percentile(late_us, 0.99) << " us, max "
+            << *std::ranges::max_element(late_us) << " us\n";
+  return 0;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kRegisters = 200;
+constexpr std::size_t kTicks = 200;
+
+enum class Mode { PerRegister, Batch, MergedBatch };
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  ::bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));  // NOLINT
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &sl);   // NOLINT
+  ::close(fd);
+  return std::to_string(ntohs(sin.sin_port));
+}
+
+// Microseconds per housekeeping tick that reads `kRegisters` 4-byte
+// registers from a loopback target. Every fourth register is scattered;
+// the rest come in runs of adjacent registers.
+auto run(Mode mode) -> double {
+  const auto port = pickFreePort();
+  spw_rmap::SpwRmapTCPServer server({.ip_address = "127.0.0.1", .port = port});
+  server.registerOnRead([](spw_rmap::Packet packet) {
+    return std::vector<uint8_t>(packet.dataLength,
+                                static_cast<uint8_t>(packet.address));
+  });
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+  spw_rmap::SpwRmapTCPClient client({.ip_address = "127.0.0.1", .port = port});
+  while (!client.connect(100ms).has_value()) {
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread loop_thread([&client] { std::ignore = client.runLoop(); });
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+
+  std::vector<std::array<uint8_t, 4>> values(kRegisters);
+  std::vector<spw_rmap::ReadRequest> requests(kRegisters);
+  for (std::size_t i = 0; i < kRegisters; ++i) {
+    const auto address =
+        i % 4 == 0 ? 0x10000 + i * 0x100 : 0x1000 + i * values[i].size();
+    requests[i] = {.memory_address = static_cast<uint32_t>(address),
+                   .data = values[i]};
+  }
+
+  bool ok = true;
+  const auto start = Clock::now();
+  for (std::size_t tick = 0; tick < kTicks && ok; ++tick) {
+    if (mode == Mode::PerRegister) {
+      for (const auto& request : requests) {
+        ok = ok && client
+                       .read(target, request.memory_address, request.data,
+                             1s)
+                       .has_value();
+      }
+    } else {
+      ok = client
+               .readMany(target, requests, {},
+                         /*merge_adjacent=*/mode == Mode::MergedBatch)
+               .has_value();
+    }
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      Clock::now() - start;
+
+  std::ignore = client.shutdown();
+  loop_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+  if (!ok) {
+    std::cerr << "register read failed\n";
+  }
+  return elapsed.count() / kTicks;
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(1) << kRegisters
+            << " registers per tick\n"
+            << "read per register " << std::setw(9) << run(Mode::PerRegister)
+            << " us/tick\n"
+            << "readMany          " << std::setw(9) << run(Mode::Batch)
+            << " us/tick\n"
+            << "readMany merged   " << std::setw(9)
+            << run(Mode::MergedBatch) << " us/tick\n";
+  return 0;
+}
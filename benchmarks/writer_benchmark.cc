@@ -0,0 +1,124 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kWritesPerThread = 5'000;
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  ::bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));  // NOLINT
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &sl);   // NOLINT
+  ::close(fd);
+  return std::to_string(ntohs(sin.sin_port));
+}
+
+struct Result {
+  double transactions_per_second;
+  double frames_per_send;
+};
+
+// `threads` application threads issuing blocking 8-byte writes through one
+// client against a loopback target.
+auto run(std::size_t threads, bool use_writer_thread) -> Result {
+  const auto port = pickFreePort();
+  spw_rmap::SpwRmapTCPServer server({.ip_address = "127.0.0.1", .port = port});
+  server.registerOnWrite([](spw_rmap::Packet) {});
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+
+  spw_rmap::SpwRmapTCPClient client({
+      .ip_address = "127.0.0.1",
+      .port = port,
+      .transaction_id_min = 0x0020,
+      .transaction_id_max = 0x0120,
+      .use_writer_thread = use_writer_thread,
+  });
+  while (!client.connect(100ms).has_value()) {
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread loop_thread([&client] { std::ignore = client.runLoop(); });
+
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+  std::atomic<std::size_t> failures{0};
+  client.resetIoStatistics();
+  const auto start = Clock::now();
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::array<uint8_t, 8> payload{};
+      for (std::size_t i = 0; i < kWritesPerThread; ++i) {
+        payload[0] = static_cast<uint8_t>(i);
+        const auto address = static_cast<uint32_t>(t * 8);
+        if (!client.write(target, address, payload, 1000ms).has_value()) {
+          failures.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  const auto stats = client.getIoStatistics();
+
+  std::ignore = client.shutdown();
+  loop_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+  if (failures.load() > 0) {
+    std::cerr << failures.load() << " writes failed\n";
+  }
+  return {
+      static_cast<double>(threads * kWritesPerThread) / elapsed.count(),
+      stats.send_calls == 0 ? 0.0
+                            : static_cast<double>(stats.packets_sent) /
+                                  static_cast<double>(stats.send_calls),
+  };
+}
+
+}  // namespace
+
+auto main() -> int {
+  std::cout << std::fixed << std::setprecision(1);
+  for (const std::size_t threads : {1UZ, 4UZ, 16UZ, 32UZ}) {
+    for (const bool writer : {false, true}) {
+      const auto result = run(threads, writer);
+      std::cout << std::setw(3) << threads << " threads "
+                << (writer ? "writer thread" : "inline send  ") << std::setw(12)
+                << result.transactions_per_second << " transactions/s"
+                << std::setw(8) << result.frames_per_send
+                << " frames/send\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/rmap_target.hh"
+
+namespace spw_rmap {
+
+/**
+ * @class CallbackTarget
+ * @brief RmapTarget that forwards each command type to a callback.
+ *
+ * A missing callback answers its commands as not implemented.
+ */
+class CallbackTarget final : public RmapTarget {
+ public:
+  struct Callbacks {
+    std::function<PacketStatusCode(const Packet&)> on_write = nullptr;
+    std::function<PacketStatusCode(const Packet&, std::span<uint8_t>)>
+        on_read = nullptr;
+    std::function<PacketStatusCode(const Packet&, std::span<uint8_t>)>
+        on_read_modify_write = nullptr;
+  };
+
+  explicit CallbackTarget(Callbacks callbacks) noexcept
+      : callbacks_(std::move(callbacks)) {}
+
+  auto write(const Packet& packet) -> PacketStatusCode override {
+    if (!callbacks_.on_write) {
+      return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+    }
+    return callbacks_.on_write(packet);
+  }
+
+  auto read(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override {
+    if (!callbacks_.on_read) {
+      return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+    }
+    return callbacks_.on_read(packet, data);
+  }
+
+  auto readModifyWrite(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override {
+    if (!callbacks_.on_read_modify_write) {
+      return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+    }
+    return callbacks_.on_read_modify_write(packet, data);
+  }
+
+ private:
+  Callbacks callbacks_;
+};
+
+struct AddressRoute {
+  uint8_t extended_address = 0;
+  uint32_t address = 0;
+  uint64_t size = 0;  // Up to the end of the 32-bit address space
+  std::shared_ptr<RmapTarget> target = nullptr;
+};
+
+/**
+ * @class AddressMap
+ * @brief RmapTarget that routes each command to the target of the address
+ *        range it falls in.
+ *
+ * The ranges are kept sorted, so a command is routed with one binary
+ * search however many there are. Targets see the packet unchanged, with
+ * its full address. A command that is not entirely inside one range is
+ * answered as not authorised.
+ *
+ * The routes can be replaced while a node is serving: `assign`, `add` and
+ * `remove` build a new table and swap it in. Commands already routed
+ * finish on the old table, which keeps its targets alive until then.
+ * Reads are always copied into the reply (no `readView`), because a
+ * target may be dropped from the map while its data is being sent.
+ */
+class AddressMap final : public RmapTarget {
+ public:
+  AddressMap() = default;
+
+  /**
+   * @brief Replace every route. Fails, leaving the routes as they were,
+   *        if two ranges overlap or one is empty, lies past the end of
+   *        the address space or has no target.
+   */
+  auto assign(std::vector<AddressRoute> routes) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Add one route, which must not overlap the others.
+   */
+  auto add(AddressRoute route) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Remove the route starting at `address`; fails if there is none.
+   */
+  auto remove(uint8_t extended_address, uint32_t address) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+  auto write(const Packet& packet) -> PacketStatusCode override;
+
+  auto read(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override;
+
+  auto readModifyWrite(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override;
+
+ private:
+  struct Table {
+    // Start of each range as extended_address << 32 | address, sorted;
+    // kept apart from the rest so the search touches few cache lines.
+    std::vector<uint64_t> begins;
+    std::vector<uint64_t> ends;
+    std::vector<std::shared_ptr<RmapTarget>> targets;
+  };
+
+  // Replaced, never modified, once published; null until the first.
+  std::atomic<std::shared_ptr<const Table>> table_{nullptr};
+  std::mutex update_mtx_;  // Serialises rebuilds
+
+  [[nodiscard]] auto snapshot_() const noexcept
+      -> std::shared_ptr<const Table>;
+
+  auto publish_(std::vector<AddressRoute> routes) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief The routes of `table`, with room for `extra` more.
+   * @throws std::bad_alloc
+   */
+  static auto routesOf_(const Table* table, std::size_t extra)
+      -> std::vector<AddressRoute>;
+
+  /**
+   * @brief The target whose range holds all `size` bytes at the packet's
+   *        address, or nullptr.
+   */
+  static auto route_(const Table* table, const Packet& packet,
+                     std::size_t size) noexcept -> RmapTarget*;
+};
+
+}  // namespace spw_rmap
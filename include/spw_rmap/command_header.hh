@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "spw_rmap/crc.hh"
+#include "spw_rmap/rmap_packet_type.hh"
+
+namespace spw_rmap {
+
+/**
+ * @class CommandHeaderTemplate
+ * @brief Precomputed command header of one target.
+ *
+ * Holds the header bytes that only depend on the target (logical address,
+ * protocol ID, instruction, key and padded reply address) together with the
+ * CRC state after them, for each kind of command the node sends. Writing a
+ * header then copies those bytes and CRCs only the 11 per-call bytes:
+ * initiator logical address, transaction ID, extended address, address and
+ * data length.
+ *
+ * The target SpaceWire address is not part of the template; it precedes the
+ * header and is not covered by the CRC.
+ */
+class CommandHeaderTemplate {
+ public:
+  enum class Kind : uint8_t {
+    Read = 0,         // Read with reply, incrementing address
+    Write = 1,        // Write with reply, incrementing address
+    WriteVerify = 2,  // Write with reply and verify, incrementing address
+  };
+
+ private:
+  static constexpr size_t kKindCount = 3;
+  static constexpr size_t kInstructionOffset = 2;
+
+  std::array<uint8_t, 16> prefix_{};
+  std::array<uint8_t, kKindCount> instruction_{};
+  std::array<uint8_t, kKindCount> crc_{};
+  uint8_t prefix_length_{0};
+  bool valid_{false};
+
+ public:
+  constexpr CommandHeaderTemplate() noexcept = default;
+
+  /**
+   * @brief Build the template. Reply addresses longer than 12 bytes can not
+   *        be encoded; the template is left invalid in that case.
+   */
+  constexpr CommandHeaderTemplate(uint8_t target_logical_address,
+                                  std::span<const uint8_t> reply_address,
+                                  uint8_t key = 0x00) noexcept {
+    if (reply_address.size() > 12) {
+      return;
+    }
+    const size_t reply_field_length = (reply_address.size() + 3) / 4 * 4;
+    size_t head = 0;
+    prefix_[head++] = target_logical_address;
+    prefix_[head++] = RMAPProtocolIdentifier;
+    head++;  // Instruction, filled in per kind
+    prefix_[head++] = key;
+    head += reply_field_length - reply_address.size();
+    for (const auto& byte : reply_address) {
+      prefix_[head++] = byte;
+    }
+    prefix_length_ = static_cast<uint8_t>(head);
+
+    uint8_t read = 0;
+    read |= std::to_underlying(RMAPPacketType::Command);
+    read |= std::to_underlying(RMAPCommandCode::Reply);
+    read |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+    read |= static_cast<uint8_t>(reply_field_length >> 2);
+    const uint8_t write = read | std::to_underlying(RMAPCommandCode::Write);
+    const uint8_t verify =
+        write | std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite);
+    instruction_[std::to_underlying(Kind::Read)] = read;
+    instruction_[std::to_underlying(Kind::Write)] = write;
+    instruction_[std::to_underlying(Kind::WriteVerify)] = verify;
+
+    auto prefix = std::span<uint8_t>(prefix_).first(prefix_length_);
+    for (size_t kind = 0; kind < kKindCount; ++kind) {
+      prefix[kInstructionOffset] = instruction_[kind];
+      crc_[kind] = crc::calcCRC(prefix);
+    }
+    prefix[kInstructionOffset] = 0x00;
+    valid_ = true;
+  }
+
+  [[nodiscard]] constexpr auto isValid() const noexcept -> bool {
+    return valid_;
+  }
+
+  /**
+   * @brief Header length from the target logical address through the header
+   *        CRC.
+   */
+  [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+    return prefix_length_ + 12;
+  }
+
+  /**
+   * @brief Write the header into `out`, which must hold at least `size()`
+   *        bytes.
+   *
+   * @return size_t The number of bytes written.
+   */
+  constexpr auto writeTo(std::span<uint8_t> out, Kind kind,
+                         uint8_t initiator_logical_address,
+                         uint16_t transaction_id, uint8_t extended_address,
+                         uint32_t address, uint32_t data_length) const noexcept
+      -> size_t {
+    const auto k = std::to_underlying(kind);
+    const std::array<uint8_t, 11> tail = {
+        initiator_logical_address,
+        static_cast<uint8_t>(transaction_id >> 8),
+        static_cast<uint8_t>(transaction_id & 0xFF),
+        extended_address,
+        static_cast<uint8_t>((address >> 24) & 0xFF),
+        static_cast<uint8_t>((address >> 16) & 0xFF),
+        static_cast<uint8_t>((address >> 8) & 0xFF),
+        static_cast<uint8_t>((address >> 0) & 0xFF),
+        static_cast<uint8_t>((data_length >> 16) & 0xFF),
+        static_cast<uint8_t>((data_length >> 8) & 0xFF),
+        static_cast<uint8_t>((data_length >> 0) & 0xFF),
+    };
+    // size() >= prefix_.size(), so copying the whole array is in bounds and
+    // lets the copy be a fixed 16-byte move; the tail overwrites the excess.
+    std::ranges::copy(prefix_, out.begin());
+    out[kInstructionOffset] = instruction_[k];
+    std::ranges::copy(tail, out.begin() + prefix_length_);
+    // CRC the argument values rather than the stored bytes, so the lookups
+    // do not wait on the stores.
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+    const auto& t = crc::SLICING_TABLES;
+    out[prefix_length_ + tail.size()] =
+        t[10][crc_[k] ^ initiator_logical_address] ^
+        t[9][(transaction_id >> 8) & 0xFF] ^ t[8][transaction_id & 0xFF] ^
+        t[7][extended_address] ^ t[6][(address >> 24) & 0xFF] ^
+        t[5][(address >> 16) & 0xFF] ^ t[4][(address >> 8) & 0xFF] ^
+        t[3][address & 0xFF] ^ t[2][(data_length >> 16) & 0xFF] ^
+        t[1][(data_length >> 8) & 0xFF] ^ t[0][data_length & 0xFF];
+    // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+    return size();
+  }
+};
+
+};  // namespace spw_rmap
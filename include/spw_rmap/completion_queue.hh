@@ -0,0 +1,194 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include "spw_rmap/target_node.hh"
+
+namespace spw_rmap {
+
+enum class RmapOperation : uint8_t { Write, Read };
+
+/**
+ * @brief One transaction submitted through `SpwRmapTCPNodeImpl::submit`.
+ *
+ * `write_data` is sent for writes; reads fill `read_data` and request
+ * `read_data.size()` bytes. Either span must stay valid until the
+ * transaction's completion has been reaped.
+ */
+struct RmapRequest {
+  RmapOperation operation = RmapOperation::Write;
+  std::shared_ptr<TargetNodeBase> target_node;
+  uint32_t memory_address = 0;
+  std::span<const uint8_t> write_data{};
+  std::span<uint8_t> read_data{};
+  uint64_t user_data = 0;
+};
+
+/**
+ * @brief One register range of `SpwRmapTCPNodeImpl::readMany`; fills
+ *        `data` from `memory_address` onwards.
+ */
+struct ReadRequest {
+  uint32_t memory_address = 0;
+  std::span<uint8_t> data{};
+};
+
+/**
+ * @brief One register range of `SpwRmapTCPNodeImpl::writeMany`.
+ */
+struct WriteRequest {
+  uint32_t memory_address = 0;
+  std::span<const uint8_t> data{};
+};
+
+/**
+ * @brief How a submitted transaction ended.
+ *
+ * `error` is empty when a reply arrived; `status` is then the RMAP status
+ * byte of that reply, which may itself report a failure at the target.
+ */
+struct RmapCompletion {
+  uint64_t user_data = 0;
+  std::error_code error{};
+  uint8_t status = 0;
+};
+
+/**
+ * @class CompletionQueue
+ * @brief Ring that collects the completions of submitted transactions.
+ *
+ * Replies, timeouts and send failures are pushed from the node's threads
+ * without locks; one consumer reaps them in batches. Every accepted
+ * submission produces exactly one completion, and `submit` accepts no more
+ * than there is room for, so the ring never overflows. A producer only
+ * touches the futex when the consumer is asleep in `reap`.
+ */
+class CompletionQueue {
+ private:
+  struct Cell {
+    std::atomic<uint64_t> sequence{0};
+    RmapCompletion completion{};
+  };
+
+  std::size_t capacity_;
+  std::unique_ptr<Cell[]> cells_;  // NOLINT
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) std::atomic<std::size_t> outstanding_{0};
+  alignas(64) uint64_t head_ = 0;
+  std::atomic<bool> sleeping_{false};
+
+ public:
+  /**
+   * @param capacity Most transactions in flight or waiting to be reaped;
+   *        rounded up to a power of two.
+   */
+  explicit CompletionQueue(std::size_t capacity)
+      : capacity_(std::bit_ceil(std::max<std::size_t>(capacity, 1))),
+        cells_(std::make_unique<Cell[]>(capacity_)) {  // NOLINT
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  CompletionQueue(const CompletionQueue&) = delete;
+  auto operator=(const CompletionQueue&) -> CompletionQueue& = delete;
+  CompletionQueue(CompletionQueue&&) = delete;
+  auto operator=(CompletionQueue&&) -> CompletionQueue& = delete;
+
+  ~CompletionQueue() = default;
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+    return capacity_;
+  }
+
+  /**
+   * @brief Transactions submitted whose completion has not been reaped.
+   */
+  [[nodiscard]] auto outstanding() const noexcept -> std::size_t {
+    return outstanding_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Move up to `out.size()` completions into `out`, first blocking
+   *        until at least `min_complete` are available. Single consumer.
+   *
+   * `min_complete` is capped at `outstanding()`, so this cannot wait for
+   * completions that will never come.
+   * @return Number of completions written.
+   */
+  auto reap(std::span<RmapCompletion> out,
+            std::size_t min_complete = 0) noexcept -> std::size_t {
+    min_complete = std::min({min_complete, out.size(), outstanding()});
+    std::size_t count = 0;
+    while (count < out.size()) {
+      auto& cell = cells_[head_ & (capacity_ - 1)];
+      if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+        if (count >= min_complete) {
+          break;
+        }
+        waitFor_(cell);
+        continue;
+      }
+      out[count++] = cell.completion;
+      cell.sequence.store(head_ + capacity_, std::memory_order_release);
+      ++head_;
+    }
+    outstanding_.fetch_sub(count, std::memory_order_acq_rel);
+    return count;
+  }
+
+  /**
+   * @brief Claim room for up to `count` completions. Called by the node
+   *        before it starts transactions.
+   * @return How many were granted.
+   */
+  auto reserve(std::size_t count) noexcept -> std::size_t {
+    auto used = outstanding_.load(std::memory_order_relaxed);
+    std::size_t granted = 0;
+    do {
+      granted = std::min(count, capacity_ - used);
+    } while (granted != 0 &&
+             !outstanding_.compare_exchange_weak(used, used + granted,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+    return granted;
+  }
+
+  /**
+   * @brief Publish one completion into reserved room. Called by the node
+   *        from any thread.
+   */
+  auto push(const RmapCompletion& completion) noexcept -> void {
+    const auto pos = tail_.fetch_add(1, std::memory_order_relaxed);
+    auto& cell = cells_[pos & (capacity_ - 1)];
+    // Reservations keep producers a full lap from the consumer, so this
+    // only spins while the consumer finishes copying the previous lap.
+    while (cell.sequence.load(std::memory_order_acquire) != pos) {
+      std::this_thread::yield();
+    }
+    cell.completion = completion;
+    cell.sequence.store(pos + 1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+      cell.sequence.notify_one();
+    }
+  }
+
+ private:
+  auto waitFor_(Cell& cell) noexcept -> void {
+    sleeping_.store(true, std::memory_order_seq_cst);
+    cell.sequence.wait(head_, std::memory_order_seq_cst);
+    sleeping_.store(false, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace spw_rmap
@@ -0,0 +1,326 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "spw_rmap/crc.hh"
+#include "spw_rmap/packet_builder.hh"
+#include "spw_rmap/rmap_packet_type.hh"
+
+namespace spw_rmap {
+
+/**
+ * @class InlinePacketBuilder
+ * @brief Non-virtual counterpart of PacketBuilderBase.
+ *
+ * Same configs and output as the builders in packet_builder.hh, but every
+ * member is static and defined in this header, so size computation and byte
+ * emission inline into the caller. Derived classes provide `totalSize_` and
+ * `emit_`.
+ *
+ * @tparam Derived The concrete builder.
+ * @tparam ConfigT The type of the configuration used to build the packet.
+ */
+template <class Derived, class ConfigT>
+class InlinePacketBuilder {
+ public:
+  /**
+   * @brief Calculate the total size of the packet based on the configuration.
+   */
+  [[nodiscard]] static auto getTotalSize(const ConfigT& config) noexcept
+      -> size_t {
+    return Derived::totalSize_(config);
+  }
+
+  /**
+   * @brief Build the packet into `out`.
+   *
+   * @return std::expected<size_t, std::error_code> The size of the built
+   *         packet, or `no_buffer_space` if `out` is smaller than
+   *         `getTotalSize(config)`.
+   */
+  [[nodiscard]] static auto build(const ConfigT& config,
+                                  std::span<uint8_t> out) noexcept
+      -> std::expected<size_t, std::error_code> {
+    if (out.size() < Derived::totalSize_(config)) {
+      return std::unexpected{std::make_error_code(std::errc::no_buffer_space)};
+    }
+    return Derived::emit_(config, out);
+  }
+};
+
+namespace internal {
+
+/**
+ * @brief Encode the reply address field length into instruction bits and
+ *        return the padded field length.
+ */
+inline auto encodeReplyAddressLength(size_t reply_address_size,
+                                     uint8_t& instruction) noexcept -> size_t {
+  if (reply_address_size == 0) {
+    return 0;
+  }
+  assert(reply_address_size <= 12);
+  const size_t field_length = ((reply_address_size - 1) & 0x0C) + 0x04;
+  instruction |= static_cast<uint8_t>(field_length >> 2);
+  return field_length;
+}
+
+}  // namespace internal
+
+class InlineReadPacketBuilder final
+    : public InlinePacketBuilder<InlineReadPacketBuilder, ReadPacketConfig> {
+  friend InlinePacketBuilder<InlineReadPacketBuilder, ReadPacketConfig>;
+
+  static auto totalSize_(const ReadPacketConfig& config) noexcept -> size_t {
+    return config.targetSpaceWireAddress.size() + 4 +
+           ((config.replyAddress.size() + 3) / 4 * 4) + 12;
+  }
+
+  static auto emit_(const ReadPacketConfig& config,
+                    std::span<uint8_t> out) noexcept -> size_t {
+    size_t head = 0;
+    for (const auto& byte : config.targetSpaceWireAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.targetLogicalAddress;
+    out[head++] = RMAPProtocolIdentifier;
+    uint8_t instruction = 0;
+    instruction |= std::to_underlying(RMAPPacketType::Command);
+    instruction |= std::to_underlying(RMAPCommandCode::Reply);
+    if (config.incrementMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+    }
+    const auto reply_field_length = internal::encodeReplyAddressLength(
+        config.replyAddress.size(), instruction);
+    out[head++] = instruction;
+    out[head++] = config.key;
+    for (size_t i = config.replyAddress.size(); i < reply_field_length; ++i) {
+      out[head++] = 0x00;
+    }
+    for (const auto& byte : config.replyAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.initiatorLogicalAddress;
+    out[head++] = static_cast<uint8_t>(config.transactionID >> 8);
+    out[head++] = static_cast<uint8_t>(config.transactionID & 0xFF);
+    out[head++] = config.extendedAddress;
+    out[head++] = static_cast<uint8_t>((config.address >> 24) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 16) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 8) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 0) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.dataLength >> 16) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.dataLength >> 8) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.dataLength >> 0) & 0xFF);
+    const auto path_length = config.targetSpaceWireAddress.size();
+    out[head] = crc::calcCRC(out.subspan(path_length, head - path_length));
+    return head + 1;
+  }
+};
+
+class InlineWritePacketBuilder final
+    : public InlinePacketBuilder<InlineWritePacketBuilder, WritePacketConfig> {
+  friend InlinePacketBuilder<InlineWritePacketBuilder, WritePacketConfig>;
+
+  static auto totalSize_(const WritePacketConfig& config) noexcept -> size_t {
+    return config.targetSpaceWireAddress.size() + 4 +
+           ((config.replyAddress.size() + 3) / 4 * 4) + 12 +
+           config.data.size() + 1;
+  }
+
+  static auto emit_(const WritePacketConfig& config,
+                    std::span<uint8_t> out) noexcept -> size_t {
+    size_t head = 0;
+    for (const auto& byte : config.targetSpaceWireAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.targetLogicalAddress;
+    out[head++] = RMAPProtocolIdentifier;
+    uint8_t instruction = 0;
+    instruction |= std::to_underlying(RMAPPacketType::Command);
+    instruction |= std::to_underlying(RMAPCommandCode::Write);
+    if (config.reply) {
+      instruction |= std::to_underlying(RMAPCommandCode::Reply);
+    }
+    if (config.verifyMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite);
+    }
+    if (config.incrementMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+    }
+    const auto reply_field_length = internal::encodeReplyAddressLength(
+        config.replyAddress.size(), instruction);
+    out[head++] = instruction;
+    out[head++] = config.key;
+    for (size_t i = config.replyAddress.size(); i < reply_field_length; ++i) {
+      out[head++] = 0x00;
+    }
+    for (const auto& byte : config.replyAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.initiatorLogicalAddress;
+    out[head++] = static_cast<uint8_t>(config.transactionID >> 8);
+    out[head++] = static_cast<uint8_t>(config.transactionID & 0xFF);
+    out[head++] = config.extendedAddress;
+    out[head++] = static_cast<uint8_t>((config.address >> 24) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 16) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 8) & 0xFF);
+    out[head++] = static_cast<uint8_t>((config.address >> 0) & 0xFF);
+    const auto data_length = config.data.size();
+    out[head++] = static_cast<uint8_t>((data_length >> 16) & 0xFF);
+    out[head++] = static_cast<uint8_t>((data_length >> 8) & 0xFF);
+    out[head++] = static_cast<uint8_t>((data_length >> 0) & 0xFF);
+    const auto path_length = config.targetSpaceWireAddress.size();
+    out[head] = crc::calcCRC(out.subspan(path_length, head - path_length));
+    head++;
+
+    out[head + data_length] =
+        crc::copyAndCalcCRC(config.data, out.subspan(head));
+    return head + data_length + 1;
+  }
+};
+
+class InlineWriteReplyPacketBuilder final
+    : public InlinePacketBuilder<InlineWriteReplyPacketBuilder,
+                                 WriteReplyPacketConfig> {
+  friend InlinePacketBuilder<InlineWriteReplyPacketBuilder,
+                             WriteReplyPacketConfig>;
+
+  static auto totalSize_(const WriteReplyPacketConfig& config) noexcept
+      -> size_t {
+    return config.replyAddress.size() + 8;
+  }
+
+  static auto emit_(const WriteReplyPacketConfig& config,
+                    std::span<uint8_t> out) noexcept -> size_t {
+    size_t head = 0;
+    for (const auto& byte : config.replyAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.initiatorLogicalAddress;
+    out[head++] = RMAPProtocolIdentifier;
+    uint8_t instruction = 0;
+    instruction |= std::to_underlying(RMAPPacketType::Reply);
+    instruction |= std::to_underlying(RMAPCommandCode::Write);
+    instruction |= std::to_underlying(RMAPCommandCode::Reply);
+    if (config.verifyMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite);
+    }
+    if (config.incrementMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+    }
+    out[head++] = instruction;
+    out[head++] = config.status;
+    out[head++] = config.targetLogicalAddress;
+    out[head++] = static_cast<uint8_t>(config.transactionID >> 8);
+    out[head++] = static_cast<uint8_t>(config.transactionID & 0xFF);
+    const auto path_length = config.replyAddress.size();
+    out[head] = crc::calcCRC(out.subspan(path_length, head - path_length));
+    return head + 1;
+  }
+};
+
+class InlineReadReplyPacketBuilder final
+    : public InlinePacketBuilder<InlineReadReplyPacketBuilder,
+                                 ReadReplyPacketConfig> {
+  friend InlinePacketBuilder<InlineReadReplyPacketBuilder,
+                             ReadReplyPacketConfig>;
+
+  static auto totalSize_(const ReadReplyPacketConfig& config) noexcept
+      -> size_t {
+    return config.replyAddress.size() + 12 + config.data.size() + 1;
+  }
+
+  /**
+   * @brief Write everything before the data field; returns its length.
+   */
+  static auto emitHead_(const ReadReplyPacketConfig& config,
+                        std::span<uint8_t> out) noexcept -> size_t {
+    size_t head = 0;
+    for (const auto& byte : config.replyAddress) {
+      out[head++] = byte;
+    }
+    out[head++] = config.initiatorLogicalAddress;
+    out[head++] = RMAPProtocolIdentifier;
+    uint8_t instruction = 0;
+    instruction |= std::to_underlying(RMAPPacketType::Reply);
+    instruction |= std::to_underlying(RMAPCommandCode::Reply);
+    if (config.verifyMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite);
+    }
+    if (config.incrementMode) {
+      instruction |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+    }
+    out[head++] = instruction;
+    out[head++] = config.status;
+    out[head++] = config.targetLogicalAddress;
+    out[head++] = static_cast<uint8_t>(config.transactionID >> 8);
+    out[head++] = static_cast<uint8_t>(config.transactionID & 0xFF);
+    out[head++] = 0x00;  // Reserved byte
+    const auto data_length = config.data.size();
+    out[head++] = static_cast<uint8_t>((data_length >> 16) & 0xFF);
+    out[head++] = static_cast<uint8_t>((data_length >> 8) & 0xFF);
+    out[head++] = static_cast<uint8_t>((data_length >> 0) & 0xFF);
+    const auto path_length = config.replyAddress.size();
+    out[head] = crc::calcCRC(out.subspan(path_length, head - path_length));
+    return head + 1;
+  }
+
+  static auto emit_(const ReadReplyPacketConfig& config,
+                    std::span<uint8_t> out) noexcept -> size_t {
+    const auto head = emitHead_(config, out);
+    const auto data_length = config.data.size();
+    out[head + data_length] =
+        crc::copyAndCalcCRC(config.data, out.subspan(head));
+    return head + data_length + 1;
+  }
+
+ public:
+  /**
+   * @brief Offset of the data field in the reply built from `config`.
+   */
+  [[nodiscard]] static auto getDataOffset(
+      const ReadReplyPacketConfig& config) noexcept -> size_t {
+    return config.replyAddress.size() + 12;
+  }
+
+  /**
+   * @brief Build the reply up to the data field, which the caller sends
+   *        from `config.data` followed by its CRC; returns its length.
+   */
+  [[nodiscard]] static auto buildHeader(const ReadReplyPacketConfig& config,
+                                        std::span<uint8_t> out) noexcept
+      -> std::expected<size_t, std::error_code> {
+    if (out.size() < getDataOffset(config)) {
+      return std::unexpected{std::make_error_code(std::errc::no_buffer_space)};
+    }
+    return emitHead_(config, out);
+  }
+
+  /**
+   * @brief Build the reply around data that is already in place.
+   *
+   * `config.data` must be `out.subspan(getDataOffset(config))` cut to the
+   * data length, e.g. after a handler filled it there; it is not copied.
+   */
+  [[nodiscard]] static auto buildInPlace(const ReadReplyPacketConfig& config,
+                                         std::span<uint8_t> out) noexcept
+      -> std::expected<size_t, std::error_code> {
+    if (out.size() < totalSize_(config)) {
+      return std::unexpected{std::make_error_code(std::errc::no_buffer_space)};
+    }
+    const auto head = emitHead_(config, out);
+    assert(config.data.data() == out.data() + head);
+    out[head + config.data.size()] = crc::calcCRC(config.data);
+    return head + config.data.size() + 1;
+  }
+};
+
+};  // namespace spw_rmap
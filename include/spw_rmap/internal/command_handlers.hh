@@ -0,0 +1,295 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+#include "spw_rmap/inline_packet_builder.hh"
+#include "spw_rmap/internal/debug.hh"
+#include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/rmap_target.hh"
+
+namespace spw_rmap::internal {
+
+/**
+ * @struct CommandHandlers
+ * @brief What the target side of a node or server answers commands with:
+ *        a target, or else the registered callbacks.
+ */
+struct CommandHandlers {
+  std::function<void(Packet)> on_write = nullptr;
+  std::function<std::vector<uint8_t>(Packet)> on_read = nullptr;
+  std::function<PacketStatusCode(Packet, std::span<uint8_t>)> on_read_into =
+      nullptr;
+  std::shared_ptr<RmapTarget> target = nullptr;
+};
+
+/**
+ * @brief Answer a Read or RMW command with a reply carrying `data_length`
+ *        bytes, which `fill` writes into the data field where the reply is
+ *        built before returning the reply's status; a failure status is
+ *        sent without data. See `serveCommand` for `emit`.
+ */
+template <class Fill, class Emit>
+auto replyReadInto(const Packet& packet, uint32_t data_length,
+                   bool verify_mode, Fill&& fill, Emit& emit) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto config = ReadReplyPacketConfig{
+      .replyAddress = packet.replyAddress,
+      .initiatorLogicalAddress = packet.targetLogicalAddress,
+      .status =
+          static_cast<uint8_t>(PacketStatusCode::CommandExecutedSuccessfully),
+      .targetLogicalAddress = packet.initiatorLogicalAddress,
+      .transactionID = packet.transactionID,
+      .data = {},
+      .incrementMode = true,
+      .verifyMode = verify_mode,
+  };
+  const auto data_offset = InlineReadReplyPacketBuilder::getDataOffset(config);
+  auto status = PacketStatusCode::CommandExecutedSuccessfully;
+  auto send_res = emit(
+      data_offset + data_length + 1,
+      [&fill, &config, &status, data_offset,
+       data_length](std::span<uint8_t> out) noexcept
+          -> std::expected<std::monostate, std::error_code> {
+        const auto data = out.subspan(data_offset, data_length);
+        config.data = data;
+        try {
+          status = fill(data);
+        } catch (const std::exception& e) {
+          spw_rmap::debug::debug("Exception in read handler: ", e.what());
+          return std::unexpected{
+              std::make_error_code(std::errc::operation_canceled)};
+        }
+        if (status != PacketStatusCode::CommandExecutedSuccessfully) {
+          // Answered below without data.
+          return std::unexpected{
+              std::make_error_code(std::errc::operation_canceled)};
+        }
+        auto res = InlineReadReplyPacketBuilder::buildInPlace(config, out);
+        if (!res.has_value()) {
+          spw_rmap::debug::debug("Failed to build Read Reply Packet: ",
+                                 res.error().message());
+          return std::unexpected{res.error()};
+        }
+        return {};
+      },
+      std::nullopt);
+  if (status != PacketStatusCode::CommandExecutedSuccessfully) {
+    config.status = static_cast<uint8_t>(status);
+    config.data = {};
+    send_res = emit(
+        InlineReadReplyPacketBuilder::getTotalSize(config),
+        [&config](std::span<uint8_t> out) noexcept
+            -> std::expected<std::monostate, std::error_code> {
+          auto res = InlineReadReplyPacketBuilder::build(config, out);
+          if (!res.has_value()) {
+            return std::unexpected{res.error()};
+          }
+          return {};
+        },
+        std::nullopt);
+  }
+  if (!send_res.has_value()) {
+    spw_rmap::debug::debug("Failed to send Read Reply Packet: ",
+                           send_res.error().message());
+    return std::unexpected{send_res.error()};
+  }
+  return {};
+}
+
+/**
+ * @brief Answer a Read command with `data` sent as the reply's payload,
+ *        straight from where the target keeps it.
+ */
+template <class Emit>
+auto replyReadView(const Packet& packet, std::span<const uint8_t> data,
+                   Emit& emit) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto config = ReadReplyPacketConfig{
+      .replyAddress = packet.replyAddress,
+      .initiatorLogicalAddress = packet.targetLogicalAddress,
+      .status =
+          static_cast<uint8_t>(PacketStatusCode::CommandExecutedSuccessfully),
+      .targetLogicalAddress = packet.initiatorLogicalAddress,
+      .transactionID = packet.transactionID,
+      .data = data,
+      .incrementMode = true,
+      .verifyMode = false,
+  };
+  auto send_res = emit(
+      InlineReadReplyPacketBuilder::getDataOffset(config),
+      [&config](std::span<uint8_t> out) noexcept
+          -> std::expected<std::monostate, std::error_code> {
+        auto res = InlineReadReplyPacketBuilder::buildHeader(config, out);
+        if (!res.has_value()) {
+          return std::unexpected{res.error()};
+        }
+        return {};
+      },
+      data);
+  if (!send_res.has_value()) {
+    spw_rmap::debug::debug("Failed to send Read Reply Packet: ",
+                           send_res.error().message());
+    return std::unexpected{send_res.error()};
+  }
+  return {};
+}
+
+/**
+ * @brief Answer a Read, RMW or Write command with `handlers`; other
+ *        packets are ignored.
+ *
+ * The reply goes out through `emit(size, fill, payload)`, which provides
+ * `size` bytes for `fill(std::span<uint8_t>)` to build the reply in,
+ * followed, if `payload` is given, by a copy of the payload and its CRC,
+ * and sends or keeps the result. When `fill` fails, nothing is sent and
+ * `emit` returns its error. With `allow_view`, a Read is answered from
+ * `RmapTarget::readView` where the target offers one.
+ */
+template <class Emit>
+auto serveCommand(const CommandHandlers& handlers, const Packet& packet,
+                  bool allow_view, Emit&& emit) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  switch (packet.type) {
+    case PacketType::Read: {
+      if (handlers.target) {
+        if (allow_view) {
+          auto view = handlers.target->readView(packet);
+          if (view.has_value() && view->size() == packet.dataLength) {
+            return replyReadView(packet, *view, emit);
+          }
+        }
+        return replyReadInto(
+            packet, packet.dataLength, false,
+            [&handlers, &packet](std::span<uint8_t> data) {
+              return handlers.target->read(packet, data);
+            },
+            emit);
+      }
+      if (handlers.on_read_into) {
+        return replyReadInto(
+            packet, packet.dataLength, false,
+            [&handlers, &packet](std::span<uint8_t> data) {
+              return handlers.on_read_into(packet, data);
+            },
+            emit);
+      }
+      std::vector<uint8_t> data{};
+      if (handlers.on_read) {
+        try {
+          data = handlers.on_read(packet);
+        } catch (const std::exception& e) {
+          spw_rmap::debug::debug("Exception in on_read_callback_: ", e.what());
+          return std::unexpected{
+              std::make_error_code(std::errc::operation_canceled)};
+        }
+      }
+      if (data.size() != packet.dataLength) {
+        std::cerr << "on_read_callback_ returned data with incorrect length: "
+                  << data.size() << " (expected " << packet.dataLength
+                  << ")\n";
+      }
+      auto config = ReadReplyPacketConfig{
+          .replyAddress = packet.replyAddress,
+          .initiatorLogicalAddress = packet.targetLogicalAddress,
+          .status = static_cast<uint8_t>(
+              PacketStatusCode::CommandExecutedSuccessfully),
+          .targetLogicalAddress = packet.initiatorLogicalAddress,
+          .transactionID = packet.transactionID,
+          .data = data,
+          .incrementMode = true,
+          .verifyMode = false,
+      };
+      auto send_res = emit(
+          InlineReadReplyPacketBuilder::getTotalSize(config),
+          [&config](std::span<uint8_t> out) noexcept
+              -> std::expected<std::monostate, std::error_code> {
+            auto res = InlineReadReplyPacketBuilder::build(config, out);
+            if (!res.has_value()) {
+              spw_rmap::debug::debug("Failed to build Read Reply Packet: ",
+                                     res.error().message());
+              return std::unexpected{res.error()};
+            }
+            return {};
+          },
+          std::nullopt);
+      if (!send_res.has_value()) {
+        spw_rmap::debug::debug("Failed to send Read Reply Packet: ",
+                               send_res.error().message());
+        return std::unexpected{send_res.error()};
+      }
+      return {};
+    }
+    case PacketType::ReadModifyWrite: {
+      // The reply carries the old contents, half the data and mask.
+      return replyReadInto(
+          packet, handlers.target ? packet.dataLength / 2 : 0, true,
+          [&handlers, &packet](std::span<uint8_t> data) {
+            return handlers.target
+                       ? handlers.target->readModifyWrite(packet, data)
+                       : PacketStatusCode::
+                             RMAPCommandNotImplementedOrNotAuthorised;
+          },
+          emit);
+    }
+    case PacketType::Write: {
+      auto status = PacketStatusCode::CommandExecutedSuccessfully;
+      try {
+        if (handlers.target) {
+          status = handlers.target->write(packet);
+        } else if (handlers.on_write) {
+          handlers.on_write(packet);
+        }
+      } catch (const std::exception& e) {
+        spw_rmap::debug::debug("Exception in write handler: ", e.what());
+        return std::unexpected{
+            std::make_error_code(std::errc::operation_canceled)};
+      }
+      auto config = WriteReplyPacketConfig{
+          .replyAddress = packet.replyAddress,
+          .initiatorLogicalAddress = packet.targetLogicalAddress,
+          .status = static_cast<uint8_t>(status),
+          .targetLogicalAddress = packet.initiatorLogicalAddress,
+          .transactionID = packet.transactionID,
+          .incrementMode = true,
+          .verifyMode = true,
+      };
+      auto send_res = emit(
+          InlineWriteReplyPacketBuilder::getTotalSize(config),
+          [&config](std::span<uint8_t> out) noexcept
+              -> std::expected<std::monostate, std::error_code> {
+            auto res = InlineWriteReplyPacketBuilder::build(config, out);
+            if (!res.has_value()) {
+              spw_rmap::debug::debug("Failed to build Write Reply Packet: ",
+                                     res.error().message());
+              return std::unexpected{res.error()};
+            }
+            return {};
+          },
+          std::nullopt);
+      if (!send_res.has_value()) {
+        spw_rmap::debug::debug("Failed to send Write Reply Packet: ",
+                               send_res.error().message());
+        return std::unexpected{send_res.error()};
+      }
+      return {};
+    }
+    default:
+      // Replies are not expected by a target.
+      return {};
+  }
+}
+
+}  // namespace spw_rmap::internal
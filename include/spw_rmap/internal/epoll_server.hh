@@ -0,0 +1,123 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace spw_rmap::internal {
+
+/**
+ * @class EpollServer
+ * @brief TCP server for RMAP over TCP that serves many connections at once.
+ *
+ * Every worker thread owns an epoll instance. The listening socket is
+ * registered with all of them (`EPOLLEXCLUSIVE`), so whichever worker wakes
+ * accepts, and hands each new connection to the workers in turn. A
+ * connection then stays with its worker: it is non-blocking and
+ * edge-triggered, and all of its frames are parsed, handled and answered on
+ * that thread. Replies are queued on the connection the command came from
+ * and written out once the worker has drained what was received.
+ *
+ * A connection whose replies are not being read stops being read itself
+ * until they drain. Linux only.
+ */
+class EpollServer {
+ public:
+  /**
+   * @brief Called with every packet received, on its connection's worker.
+   *
+   * Appends the reply packet, without the frame header, to the empty
+   * `reply`; nothing appended sends nothing. Returning false closes the
+   * connection. Runs concurrently for connections on different workers.
+   */
+  using Handler = std::function<bool(std::span<const uint8_t> packet,
+                                     std::vector<uint8_t>& reply)>;
+
+ private:
+  struct Connection;
+  struct Worker;
+
+  std::string bind_address_;
+  std::string port_;
+  std::size_t worker_count_;
+  std::size_t max_packet_size_;
+  Handler handler_;
+  int listen_fd_ = -1;
+  int stop_fd_ = -1;  // eventfd; readable once stop() was called
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<std::size_t> next_worker_{0};
+  std::atomic<std::size_t> connection_count_{0};
+
+ public:
+  EpollServer() = delete;
+  EpollServer(const EpollServer&) = delete;
+  auto operator=(const EpollServer&) -> EpollServer& = delete;
+  EpollServer(EpollServer&&) = delete;
+  auto operator=(EpollServer&&) -> EpollServer& = delete;
+
+  /**
+   * @param worker_threads Number of epoll workers; at least one is used.
+   * @param max_packet_size Longest packet, summed over its frames, that a
+   *        client may send; a connection announcing more is closed.
+   */
+  EpollServer(std::string bind_address, std::string port,
+              std::size_t worker_threads, std::size_t max_packet_size,
+              Handler handler) noexcept;
+
+  ~EpollServer() noexcept;
+
+  /**
+   * @brief Bind, listen and start the workers. Returns once the server
+   *        accepts connections.
+   */
+  [[nodiscard]] auto start() noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Stop the workers and close every connection and the listening
+   *        socket. Safe to call more than once, but not from a handler.
+   */
+  auto stop() noexcept -> void;
+
+  [[nodiscard]] auto connectionCount() const noexcept -> std::size_t {
+    return connection_count_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto getIpAddress() const noexcept -> const std::string& {
+    return bind_address_;
+  }
+
+  /**
+   * @brief The bound port once started, so port "0" picks a free one.
+   */
+  [[nodiscard]] auto getPort() const noexcept -> const std::string& {
+    return port_;
+  }
+
+ private:
+  auto listen_() noexcept -> std::expected<std::monostate, std::error_code>;
+  auto run_(Worker& worker) noexcept -> void;
+  auto acceptAll_() noexcept -> void;
+  auto onEvents_(Worker& worker, Connection& connection,
+                 uint32_t events) noexcept -> void;
+  auto receive_(Worker& worker, Connection& connection) noexcept -> bool;
+  auto consumeFrames_(Worker& worker, Connection& connection) noexcept
+      -> bool;
+  auto handlePacket_(Worker& worker, Connection& connection,
+                     std::span<const uint8_t> packet) noexcept -> bool;
+  static auto flush_(Connection& connection) noexcept -> bool;
+  auto close_(Worker& worker, Connection& connection) noexcept -> void;
+};
+
+}  // namespace spw_rmap::internal
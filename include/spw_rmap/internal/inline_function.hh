@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace spw_rmap::internal {
+
+template <class Signature, std::size_t Capacity>
+class InlineFunction;
+
+/**
+ * @class InlineFunction
+ * @brief Move-only callable wrapper that never allocates.
+ *
+ * Like `std::move_only_function`, but the target is always stored in an
+ * in-object buffer of `Capacity` bytes; a callable that does not fit, is
+ * over-aligned or may throw on move is rejected at compile time instead of
+ * being moved to the heap.
+ */
+template <class R, class... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+ private:
+  enum class Op : uint8_t { Move, Destroy };
+
+  alignas(alignof(void*)) std::byte storage_[Capacity];
+  R (*invoke_)(void*, Args&&...) = nullptr;
+  void (*manage_)(Op, void*, void*) noexcept = nullptr;
+
+ public:
+  InlineFunction() noexcept = default;
+  InlineFunction(std::nullptr_t) noexcept {}  // NOLINT
+
+  template <class F, class D = std::decay_t<F>>
+    requires(!std::is_same_v<D, InlineFunction> &&
+             std::is_invocable_r_v<R, D&, Args...>)
+  InlineFunction(F&& f) noexcept(  // NOLINT
+      std::is_nothrow_constructible_v<D, F&&>) {
+    static_assert(sizeof(D) <= Capacity,
+                  "Callable does not fit in InlineFunction");
+    static_assert(alignof(D) <= alignof(void*),
+                  "Callable is over-aligned for InlineFunction");
+    static_assert(std::is_nothrow_move_constructible_v<D>,
+                  "Callable must be nothrow move constructible");
+    ::new (static_cast<void*>(storage_)) D(std::forward<F>(f));
+    invoke_ = [](void* target, Args&&... args) -> R {
+      return std::invoke(*static_cast<D*>(target),
+                         std::forward<Args>(args)...);
+    };
+    manage_ = [](Op op, void* dst, void* src) noexcept {
+      if (op == Op::Move) {
+        ::new (dst) D(std::move(*static_cast<D*>(src)));
+      }
+      static_cast<D*>(src)->~D();
+    };
+  }
+
+  InlineFunction(InlineFunction&& other) noexcept { moveFrom_(other); }
+
+  auto operator=(InlineFunction&& other) noexcept -> InlineFunction& {
+    if (this != &other) {
+      reset_();
+      moveFrom_(other);
+    }
+    return *this;
+  }
+
+  auto operator=(std::nullptr_t) noexcept -> InlineFunction& {
+    reset_();
+    return *this;
+  }
+
+  InlineFunction(const InlineFunction&) = delete;
+  auto operator=(const InlineFunction&) -> InlineFunction& = delete;
+
+  ~InlineFunction() { reset_(); }
+
+  explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+  auto operator()(Args... args) -> R {
+    return invoke_(static_cast<void*>(storage_), std::forward<Args>(args)...);
+  }
+
+ private:
+  auto moveFrom_(InlineFunction& other) noexcept -> void {
+    if (other.invoke_ == nullptr) {
+      return;
+    }
+    other.manage_(Op::Move, storage_, other.storage_);
+    invoke_ = std::exchange(other.invoke_, nullptr);
+    manage_ = std::exchange(other.manage_, nullptr);
+  }
+
+  auto reset_() noexcept -> void {
+    if (invoke_ == nullptr) {
+      return;
+    }
+    manage_(Op::Destroy, nullptr, storage_);
+    invoke_ = nullptr;
+    manage_ = nullptr;
+  }
+};
+
+}  // namespace spw_rmap::internal
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+
+#include "spw_rmap/internal/tcp_client.hh"
+
+namespace spw_rmap::internal {
+
+using namespace std::chrono_literals;
+
+/**
+ * @class IoUringClient
+ * @brief TCP client doing its socket I/O through io_uring.
+ *
+ * Drop-in replacement for `TCPClient` as a `TcpBackend`. The connection is
+ * set up by a `TCPClient`; after that two rings are used so the receive
+ * thread and senders never share a submission queue:
+ *
+ * - The receive ring keeps one multishot `recv` armed that picks buffers
+ *   from a provided buffer ring. Everything that arrived while the receive
+ *   thread was busy is reaped by one `io_uring_enter`, and `recvSome` only
+ *   enters the kernel when the completion queue is empty.
+ * - The send ring first submits a non-blocking `sendmsg`. Only when the
+ *   socket buffer is full is it resubmitted linked to a timeout, so a
+ *   blocked send still honours `setSendTimeout` in one `io_uring_enter`.
+ *
+ * The rings are driven with raw system calls; liburing is not needed. Use
+ * `isSupported` to check whether the running kernel provides the required
+ * features (Linux 6.0 or later).
+ */
+class IoUringClient {
+ private:
+  class Ring;
+  class ProvidedBuffers;
+
+  TCPClient socket_;
+  std::unique_ptr<Ring> recv_ring_;
+  std::unique_ptr<ProvidedBuffers> recv_buffers_;
+  std::unique_ptr<Ring> send_ring_;
+  std::mutex send_mtx_;
+  std::chrono::microseconds send_timeout_{0};
+
+  bool recv_armed_ = false;
+  uint16_t recv_buffer_id_ = 0;
+  std::size_t recv_offset_ = 0;
+  std::size_t recv_remaining_ = 0;
+
+ public:
+  IoUringClient() = delete;
+  IoUringClient(const IoUringClient&) = delete;
+  auto operator=(const IoUringClient&) -> IoUringClient& = delete;
+  IoUringClient(IoUringClient&&) = delete;
+  auto operator=(IoUringClient&&) -> IoUringClient& = delete;
+
+  IoUringClient(std::string ip_address, std::string port);
+
+  ~IoUringClient();
+
+  /**
+   * @brief Check whether io_uring with provided buffer rings is usable.
+   *
+   * Fails on old kernels and where io_uring is disabled, e.g. by seccomp or
+   * `kernel.io_uring_disabled`. The result is computed once.
+   */
+  [[nodiscard]] static auto isSupported() noexcept -> bool;
+
+  [[nodiscard]] auto connect(std::chrono::microseconds timeout = 500ms) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  auto disconnect() noexcept -> void;
+
+  /**
+   * @brief Bound each send by `timeout`; zero waits indefinitely.
+   */
+  [[nodiscard]] auto setSendTimeout(std::chrono::microseconds timeout) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  [[nodiscard]] auto sendAll(std::span<const uint8_t> data) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Send `buffers` back to back without joining them first.
+   */
+  [[nodiscard]] auto sendAllv(
+      std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Receive available bytes, blocking until at least one arrives.
+   *        Must only be called from one thread at a time.
+   */
+  [[nodiscard]] auto recvSome(std::span<uint8_t> buf) noexcept
+      -> std::expected<size_t, std::error_code>;
+
+  [[nodiscard]] auto shutdown() noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  [[nodiscard]] auto getIpAddress() const noexcept -> const std::string& {
+    return socket_.getIpAddress();
+  }
+
+  auto setIpAddress(std::string ip_address) noexcept -> void {
+    socket_.setIpAddress(std::move(ip_address));
+  }
+
+  [[nodiscard]] auto getPort() const noexcept -> const std::string& {
+    return socket_.getPort();
+  }
+
+  auto setPort(std::string port) noexcept -> void {
+    socket_.setPort(std::move(port));
+  }
+
+ private:
+  auto setupRings_() noexcept -> std::expected<std::monostate, std::error_code>;
+  auto teardownRings_() noexcept -> void;
+  auto armRecv_() noexcept -> std::expected<std::monostate, std::error_code>;
+  auto sendChunk_(std::span<const std::span<const uint8_t>> buffers,
+                  std::size_t offset, bool wait) noexcept
+      -> std::expected<std::size_t, std::error_code>;
+};
+
+}  // namespace spw_rmap::internal
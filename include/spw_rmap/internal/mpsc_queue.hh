@@ -0,0 +1,90 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <atomic>
+
+namespace spw_rmap::internal {
+
+/**
+ * @brief Link field for elements of an `MpscQueue`; derive from it.
+ */
+struct MpscQueueHook {
+  std::atomic<MpscQueueHook*> mpsc_next{nullptr};
+};
+
+/**
+ * @class MpscQueue
+ * @brief Intrusive lock-free multi-producer single-consumer FIFO.
+ *
+ * Dmitry Vyukov's node-based queue: `push` is one atomic exchange and never
+ * waits, `pop` is for a single consumer thread. The queue does not own its
+ * elements. `pop` can return nullptr for a moment while a producer is
+ * between its exchange and linking the node, even though the queue is not
+ * empty; consumers that know an element is there retry.
+ *
+ * @tparam T Element type, derived from `MpscQueueHook`.
+ */
+template <class T>
+class MpscQueue {
+ private:
+  alignas(64) std::atomic<MpscQueueHook*> head_;  // Last pushed, producers
+  alignas(64) MpscQueueHook* tail_;               // Next to pop, consumer
+  MpscQueueHook stub_;
+
+ public:
+  MpscQueue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+  MpscQueue(const MpscQueue&) = delete;
+  auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+  MpscQueue(MpscQueue&&) = delete;
+  auto operator=(MpscQueue&&) -> MpscQueue& = delete;
+
+  ~MpscQueue() = default;
+
+  /**
+   * @brief Append `element`. Safe from any number of threads.
+   */
+  auto push(T* element) noexcept -> void { push_(element); }
+
+  /**
+   * @brief Remove the oldest element, or return nullptr. Consumer only.
+   */
+  [[nodiscard]] auto pop() noexcept -> T* {
+    MpscQueueHook* tail = tail_;
+    MpscQueueHook* next = tail->mpsc_next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->mpsc_next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return static_cast<T*>(tail);
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return nullptr;  // A producer has not linked its node yet
+    }
+    // `tail` is the last element; put the stub behind it so it can be
+    // unlinked.
+    push_(&stub_);
+    next = tail->mpsc_next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return static_cast<T*>(tail);
+    }
+    return nullptr;
+  }
+
+ private:
+  auto push_(MpscQueueHook* node) noexcept -> void {
+    node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+    MpscQueueHook* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->mpsc_next.store(node, std::memory_order_release);
+  }
+};
+
+}  // namespace spw_rmap::internal
@@ -0,0 +1,133 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace spw_rmap::internal {
+
+/**
+ * @class ReceiveBuffer
+ * @brief User-space staging buffer in front of a stream socket.
+ *
+ * Reads from the socket in chunks of up to `capacity` bytes, so several
+ * small frames that arrive together cost one receive call. Requests at
+ * least as large as the capacity bypass the buffer once it is drained and
+ * are read straight into the destination.
+ */
+class ReceiveBuffer {
+ private:
+  std::vector<uint8_t> buf_;
+  std::size_t begin_ = 0;
+  std::size_t end_ = 0;
+
+ public:
+  explicit ReceiveBuffer(std::size_t capacity) : buf_(capacity) {}
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+    return buf_.size();
+  }
+
+  /**
+   * @brief Bytes received from the socket but not consumed yet.
+   */
+  [[nodiscard]] auto buffered() const noexcept -> std::size_t {
+    return end_ - begin_;
+  }
+
+  /**
+   * @brief Drop buffered bytes, e.g. after reconnecting.
+   */
+  auto clear() noexcept -> void {
+    begin_ = 0;
+    end_ = 0;
+  }
+
+  /**
+   * @brief Copy up to `dst.size()` bytes into `dst`, calling `recv_some`
+   *        at most once.
+   *
+   * @param recv_some Callable with the signature of `TcpBackend::recvSome`.
+   * @return The number of bytes written to `dst`; 0 means end of stream.
+   */
+  template <class RecvSome>
+  auto readSome(std::span<uint8_t> dst, RecvSome&& recv_some)
+      -> std::expected<std::size_t, std::error_code> {
+    if (dst.empty()) {
+      return 0U;
+    }
+    if (buffered() == 0) {
+      if (dst.size() >= buf_.size()) {
+        return recv_some(dst);
+      }
+      auto res = fill_(recv_some);
+      if (!res.has_value() || *res == 0) {
+        return res;
+      }
+    }
+    const auto n = std::min(dst.size(), buffered());
+    std::copy_n(buf_.begin() + static_cast<std::ptrdiff_t>(begin_), n,
+                dst.begin());
+    begin_ += n;
+    return n;
+  }
+
+  /**
+   * @brief Make sure some bytes are buffered, calling `recv_some` into the
+   *        buffer if none are. Unlike `readSome`, never receives into
+   *        caller memory.
+   *
+   * @return The number of bytes buffered; 0 means end of stream.
+   */
+  template <class RecvSome>
+  auto fill(RecvSome&& recv_some)
+      -> std::expected<std::size_t, std::error_code> {
+    if (buffered() != 0) {
+      return buffered();
+    }
+    return fill_(recv_some);
+  }
+
+  /**
+   * @brief Discard up to `n` bytes, calling `recv_some` at most once.
+   *
+   * @return The number of bytes discarded; 0 means end of stream.
+   */
+  template <class RecvSome>
+  auto skip(std::size_t n, RecvSome&& recv_some)
+      -> std::expected<std::size_t, std::error_code> {
+    if (n == 0) {
+      return 0U;
+    }
+    if (buffered() == 0) {
+      auto res = fill_(recv_some);
+      if (!res.has_value() || *res == 0) {
+        return res;
+      }
+    }
+    const auto skipped = std::min(n, buffered());
+    begin_ += skipped;
+    return skipped;
+  }
+
+ private:
+  template <class RecvSome>
+  auto fill_(RecvSome& recv_some)
+      -> std::expected<std::size_t, std::error_code> {
+    begin_ = 0;
+    end_ = 0;
+    auto res = recv_some(std::span(buf_));
+    if (res.has_value()) {
+      end_ = *res;
+    }
+    return res;
+  }
+};
+
+}  // namespace spw_rmap::internal
@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace spw_rmap::internal {
+
+/**
+ * @class RttEstimator
+ * @brief Smoothed round-trip time of one target and the transaction
+ *        timeout derived from it, computed as TCP does (RFC 6298).
+ *
+ * Every reply feeds its round-trip time to `sample`; every transaction
+ * that times out doubles the timeout through `backoff` until the next
+ * sample recomputes it. Not thread safe.
+ */
+class RttEstimator {
+ public:
+  using Duration = std::chrono::nanoseconds;
+
+ private:
+  Duration srtt_{0};
+  Duration rttvar_{0};
+  Duration timeout_{0};
+  uint64_t samples_ = 0;
+  uint64_t timeouts_ = 0;
+
+ public:
+  /**
+   * @param granularity Resolution of the clock that enforces the timeout.
+   */
+  auto sample(Duration rtt, Duration granularity, Duration min_timeout,
+              Duration max_timeout) noexcept -> void {
+    rtt = std::max(rtt, Duration{0});
+    if (samples_ == 0) {
+      srtt_ = rtt;
+      rttvar_ = rtt / 2;
+    } else {
+      // RTTVAR first, so it uses the previous SRTT.
+      const auto deviation = srtt_ > rtt ? srtt_ - rtt : rtt - srtt_;
+      rttvar_ = (3 * rttvar_ + deviation) / 4;
+      srtt_ = (7 * srtt_ + rtt) / 8;
+    }
+    ++samples_;
+    timeout_ = std::clamp(srtt_ + std::max(granularity, 4 * rttvar_),
+                          min_timeout, max_timeout);
+  }
+
+  auto backoff(Duration max_timeout) noexcept -> void {
+    ++timeouts_;
+    timeout_ = std::min(2 * timeout_, max_timeout);
+  }
+
+  [[nodiscard]] auto srtt() const noexcept -> Duration { return srtt_; }
+  [[nodiscard]] auto rttvar() const noexcept -> Duration { return rttvar_; }
+
+  /**
+   * @brief Current timeout; zero until the first sample.
+   */
+  [[nodiscard]] auto timeout() const noexcept -> Duration { return timeout_; }
+
+  [[nodiscard]] auto samples() const noexcept -> uint64_t { return samples_; }
+  [[nodiscard]] auto timeouts() const noexcept -> uint64_t {
+    return timeouts_;
+  }
+};
+
+}  // namespace spw_rmap::internal
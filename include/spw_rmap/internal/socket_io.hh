@@ -0,0 +1,25 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <system_error>
+#include <variant>
+
+namespace spw_rmap::internal {
+
+/**
+ * @brief Send every byte of `buffers`, in order, on the connected socket
+ *        `fd` using scatter-gather `sendmsg` calls.
+ *
+ * Partial writes resume where the kernel stopped, so callers can pass a
+ * small header, a caller-owned payload and a trailer without copying them
+ * into one buffer. Empty buffers are skipped.
+ */
+auto sendAllv(int fd,
+              std::span<const std::span<const uint8_t>> buffers) noexcept
+    -> std::expected<std::monostate, std::error_code>;
+
+}  // namespace spw_rmap::internal
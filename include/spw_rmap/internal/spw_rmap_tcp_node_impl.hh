@@ -1,22 +1,44 @@
 // Copyright (c) 2025 Gen
 // Licensed under the MIT License. See LICENSE file for details.
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <coroutine>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "spw_rmap/command_header.hh"
+#include "spw_rmap/completion_queue.hh"
+#include "spw_rmap/crc.hh"
 #include "spw_rmap/error_code.hh"
+#include "spw_rmap/inline_packet_builder.hh"
+#include "spw_rmap/internal/command_handlers.hh"
 #include "spw_rmap/internal/debug.hh"
+#include "spw_rmap/internal/mpsc_queue.hh"
+#include "spw_rmap/internal/receive_buffer.hh"
+#include "spw_rmap/internal/rtt_estimator.hh"
+#include "spw_rmap/internal/timer_wheel.hh"
+#include "spw_rmap/internal/transaction_id_allocator.hh"
+#include "spw_rmap/internal/transaction_slot.hh"
 #include "spw_rmap/packet_builder.hh"
 #include "spw_rmap/packet_parser.hh"
 #include "spw_rmap/spw_rmap_node_base.hh"
+#include "spw_rmap/static_packet.hh"
+#include "spw_rmap/transaction_completion.hh"
 
 namespace spw_rmap {
 
@@ -32,17 +54,63 @@ struct SpwRmapTCPNodeConfig {
   size_t recv_buffer_size = 4096;
   size_t send_pool_size = 4;
   size_t recv_pool_size = 4;
+  size_t recv_chunk_size = 64 * 1024;  // Bytes requested per recv call
   uint16_t transaction_id_min = 0x0020;
-  uint16_t transaction_id_max = 0x0040;
+  // Exclusive; up to 0x10000. Each ID in the range costs one 64-byte slot.
+  uint32_t transaction_id_max = 0x0040;
+  // Granularity of transaction deadlines.
+  std::chrono::microseconds timeout_resolution{100};
   BufferPolicy buffer_policy = BufferPolicy::AutoResize;
   std::chrono::microseconds send_timeout = std::chrono::milliseconds{500};
+  // Queue built frames to a writer thread that sends them in batches,
+  // instead of sending inline under a lock.
+  bool use_writer_thread = false;
+  size_t writer_max_batch_bytes = 256 * 1024;
+  // How long the writer waits for more frames before sending a batch
+  // smaller than writer_max_batch_bytes; 0 sends whatever is queued.
+  std::chrono::microseconds writer_latency_bound{0};
+  // Derive deadlines from the measured round-trip time of each target
+  // instead of the fixed timeouts, once a reply from it has been timed.
+  bool adaptive_timeout = false;
+  std::chrono::microseconds min_adaptive_timeout = std::chrono::milliseconds{1};
+  std::chrono::microseconds max_adaptive_timeout = std::chrono::seconds{1};
+  // Serve commands and run reply callbacks on this many threads instead of
+  // the one calling poll; 0 keeps them on it. Each packet is copied into
+  // one of recv_pool_size pooled buffers, and poll waits while all are in
+  // use. Replies are sent in the order their commands arrived.
+  size_t handler_threads = 0;
+};
+
+/**
+ * @brief Round-trip time measured for one target logical address, and the
+ *        deadline an adaptive timeout gives its next transaction. All zero
+ *        unless `adaptive_timeout` is on.
+ */
+struct RttEstimate {
+  std::chrono::nanoseconds smoothed_rtt{0};
+  std::chrono::nanoseconds rtt_variation{0};
+  // Zero until the first sample.
+  std::chrono::nanoseconds timeout{0};
+  uint64_t samples = 0;
+  uint64_t timeouts = 0;
+};
+
+/**
+ * @brief Socket call and packet counters of a node.
+ */
+struct SpwRmapIoStatistics {
+  uint64_t recv_calls = 0;
+  uint64_t send_calls = 0;
+  uint64_t packets_received = 0;
+  uint64_t packets_sent = 0;
 };
 
 namespace internal {
 template <class B>
 concept TcpBackend = requires(
     B b, std::string ip, std::string port, std::chrono::microseconds us,
-    std::span<uint8_t> inbuf, std::span<const uint8_t> outbuf) {
+    std::span<uint8_t> inbuf, std::span<const uint8_t> outbuf,
+    std::span<const std::span<const uint8_t>> outbufs) {
   { B(ip, port) };
   { b.getIpAddress() } -> std::same_as<const std::string&>;
   { b.setIpAddress(std::move(ip)) } -> std::same_as<void>;
@@ -55,6 +123,9 @@ concept TcpBackend = requires(
   {
     b.sendAll(outbuf)
   } -> std::same_as<std::expected<std::monostate, std::error_code>>;
+  {
+    b.sendAllv(outbufs)
+  } -> std::same_as<std::expected<std::monostate, std::error_code>>;
 };
 
 template <TcpBackend Backend>
@@ -63,51 +134,197 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
   std::unique_ptr<Backend> tcp_backend_ = nullptr;
 
   std::vector<uint8_t> recv_buf_ = {};
+  ReceiveBuffer recv_stage_;
+  // Held by `poll` while it receives, so a reconnect does not reset the
+  // staged bytes under it.
+  std::mutex recv_mtx_;
 
   std::recursive_mutex send_buf_mtx_;
   std::vector<uint8_t> send_buf_ = {};
 
-  std::vector<std::function<void(Packet)>> reply_callback_ = {};
-  std::vector<std::function<void(std::error_code)>> reply_error_callback_ = {};
-  std::vector<std::unique_ptr<std::mutex>> reply_callback_mtx_;
-  std::vector<bool> available_transaction_ids_ = {};
-  std::vector<std::chrono::steady_clock::time_point> transaction_last_used_ =
-      {};
-  std::mutex transaction_ids_mtx_;
+  std::vector<TransactionSlot> transaction_slots_;
+  // What the reply of an armed slot needs besides the callback; written
+  // before the slot is armed. Padded to a line of its own like the slot,
+  // since neighbouring IDs are usually live at the same time.
+  struct alignas(kCacheLineSize) SlotContext {
+    // Where a read reply's data is copied as it arrives.
+    std::span<uint8_t> reply_sink{};
+    std::chrono::steady_clock::time_point armed_at{};
+    // Timer tick of the deadline; set when the slot is armed.
+    uint64_t deadline_tick = 0;
+    uint8_t target_logical_address = 0;
+  };
+  static_assert(sizeof(SlotContext) == kCacheLineSize);
+  std::vector<SlotContext> slot_contexts_;
+  TransactionIdAllocator transaction_ids_;
+  // Transaction whose reply is being received, and its `kReceiving` state
+  // word; poll thread only.
+  std::optional<std::pair<uint16_t, uint32_t>> receiving_reply_ =
+      std::nullopt;
 
   PacketParser packet_parser_ = {};
-  ReadPacketBuilder read_packet_builder_ = {};
-  WritePacketBuilder write_packet_builder_ = {};
+  StreamingDataCRC data_crc_ = {};
   uint8_t initiator_logical_address_ = 0xFE;
   uint16_t transaction_id_min_;
-  uint16_t transaction_id_max_;
+  uint32_t transaction_id_max_;
   BufferPolicy buffer_policy_ = BufferPolicy::AutoResize;
   std::chrono::microseconds send_timeout_{std::chrono::milliseconds{500}};
 
-  std::chrono::milliseconds transaction_timeout_{std::chrono::seconds(1)};
+  std::chrono::microseconds transaction_timeout_{std::chrono::seconds(1)};
 
   std::atomic<bool> running_{false};
 
-  std::function<void(Packet)> on_write_callback_ = nullptr;
-  std::function<std::vector<uint8_t>(Packet)> on_read_callback_ = nullptr;
+  std::atomic<uint64_t> recv_calls_{0};
+  std::atomic<uint64_t> send_calls_{0};
+  std::atomic<uint64_t> packets_received_{0};
+  std::atomic<uint64_t> packets_sent_{0};
+
+  CommandHandlers handlers_{};
+
+  struct OutgoingFrame : MpscQueueHook {
+    std::vector<uint8_t> bytes;  // Empty frames only wake the writer
+    std::optional<uint16_t> transaction_id;
+  };
+
+  bool use_writer_thread_ = false;
+  size_t writer_max_batch_bytes_ = 256 * 1024;
+  std::chrono::microseconds writer_latency_bound_{0};
+  MpscQueue<OutgoingFrame> send_queue_;
+  std::atomic<uint32_t> send_queue_size_{0};
+  std::atomic<bool> writer_stop_{false};
+  std::thread writer_thread_;
+  // Lets the writer sleep while it waits for a batch to fill up.
+  std::mutex writer_mtx_;
+  std::condition_variable writer_cv_;
+  std::atomic<bool> writer_lingering_{false};
+  // Sent frames kept for reuse, so queuing one does not allocate.
+  static constexpr size_t kFramePoolSize = 64;
+  std::mutex frame_pool_mtx_;
+  std::vector<std::unique_ptr<OutgoingFrame>> frame_pool_;
+
+  // Transaction deadlines; timer_wheel_ counts ticks of timeout_resolution_
+  // since timer_epoch_. Started with the first transaction.
+  std::mutex timer_mtx_;
+  std::condition_variable timer_cv_;
+  TimerWheel timer_wheel_;
+  std::chrono::steady_clock::duration timeout_resolution_;
+  std::chrono::steady_clock::time_point timer_epoch_ =
+      std::chrono::steady_clock::now();
+  uint64_t timer_wake_tick_ = std::numeric_limits<uint64_t>::max();
+  bool timer_stop_ = false;
+  std::once_flag timer_started_;
+  std::thread timer_thread_;
+  // (slot index, armed state) due this round; timer thread only.
+  std::vector<std::pair<uint32_t, uint32_t>> timer_expired_;
+
+  // Round-trip times per target logical address, each under its own lock;
+  // allocated only with adaptive timeouts.
+  std::chrono::steady_clock::duration min_adaptive_timeout_;
+  std::chrono::steady_clock::duration max_adaptive_timeout_;
+  struct alignas(kCacheLineSize) TargetRtt {
+    std::mutex mtx;
+    RttEstimator estimator;
+    // Timer sweep of the last backoff, so a burst of expiries backs the
+    // target off once.
+    uint64_t backoff_sweep = 0;
+  };
+  std::unique_ptr<TargetRtt[]> target_rtts_;
+  // Rounds of the timer thread that expired something.
+  std::atomic<uint64_t> timer_sweep_{0};
+
+  // A packet handed to the handler threads. The one with sequence number
+  // s lives in handler_jobs_[s % handler_jobs_.size()] until its reply is
+  // sent, so the buffers are reused rather than reallocated.
+  struct HandlerJob {
+    std::vector<uint8_t> bytes;  // What the spans of `packet` point into
+    Packet packet{};
+    TransactionCallback on_complete = nullptr;  // Set for a reply
+    std::vector<uint8_t> reply;                 // Frame to send, if any
+    bool done = false;  // Guarded by reply_order_mtx_
+  };
+  std::vector<HandlerJob> handler_jobs_;
+  std::vector<std::thread> handler_threads_;
+  std::mutex handler_mtx_;
+  std::condition_variable handler_work_cv_;
+  std::condition_variable handler_free_cv_;
+  // Sequence numbers, guarded by handler_mtx_: jobs up to dispatched are
+  // filled, up to taken are with a thread, up to committed are sent.
+  uint64_t handler_dispatched_ = 0;
+  uint64_t handler_taken_ = 0;
+  uint64_t handler_committed_ = 0;
+  bool handler_stop_ = false;
+  std::error_code handler_error_{};  // First failure, for poll to return
+  std::mutex reply_order_mtx_;       // Held while sending replies in order
+  uint64_t reply_next_ = 0;          // Guarded by reply_order_mtx_
 
  public:
   explicit SpwRmapTCPNodeImpl(SpwRmapTCPNodeConfig config) noexcept
       : tcp_backend_(std::make_unique<Backend>(std::move(config.ip_address),
                                                std::move(config.port))),
         recv_buf_(config.recv_buffer_size),
+        recv_stage_(config.recv_chunk_size),
         send_buf_(config.send_buffer_size),
+        transaction_slots_(transactionIdCount_(config)),
+        slot_contexts_(transactionIdCount_(config)),
+        transaction_ids_(transactionIdCount_(config)),
         transaction_id_min_(config.transaction_id_min),
-        transaction_id_max_(config.transaction_id_max),
+        transaction_id_max_(config.transaction_id_min +
+                            transactionIdCount_(config)),
         buffer_policy_(config.buffer_policy),
-        send_timeout_(config.send_timeout) {
-    for (uint32_t i = 0; i < transaction_id_max_ - transaction_id_min_; ++i) {
-      available_transaction_ids_.emplace_back(true);
-      reply_callback_.emplace_back(nullptr);
-      reply_error_callback_.emplace_back(nullptr);
-      reply_callback_mtx_.emplace_back(std::make_unique<std::mutex>());
-      transaction_last_used_.emplace_back(
-          std::chrono::steady_clock::time_point::min());
+        send_timeout_(config.send_timeout),
+        use_writer_thread_(config.use_writer_thread),
+        writer_max_batch_bytes_(config.writer_max_batch_bytes),
+        writer_latency_bound_(config.writer_latency_bound),
+        timer_wheel_(transactionIdCount_(config)),
+        timeout_resolution_(std::max<std::chrono::steady_clock::duration>(
+            config.timeout_resolution, std::chrono::microseconds{1})),
+        min_adaptive_timeout_(config.min_adaptive_timeout),
+        max_adaptive_timeout_(std::max(config.max_adaptive_timeout,
+                                       config.min_adaptive_timeout)),
+        target_rtts_(config.adaptive_timeout
+                         ? std::make_unique<TargetRtt[]>(256)
+                         : nullptr),
+        handler_jobs_(config.handler_threads == 0
+                          ? 0
+                          : std::max<size_t>(config.recv_pool_size, 1)) {
+    if (use_writer_thread_) {
+      frame_pool_.reserve(kFramePoolSize);
+      writer_thread_ = std::thread([this]() noexcept { writerLoop_(); });
+    }
+    for (size_t i = 0; i < config.handler_threads; ++i) {
+      handler_threads_.emplace_back([this]() noexcept { handlerLoop_(); });
+    }
+  }
+
+  SpwRmapTCPNodeImpl(const SpwRmapTCPNodeImpl&) = delete;
+  auto operator=(const SpwRmapTCPNodeImpl&) -> SpwRmapTCPNodeImpl& = delete;
+  SpwRmapTCPNodeImpl(SpwRmapTCPNodeImpl&&) = delete;
+  auto operator=(SpwRmapTCPNodeImpl&&) -> SpwRmapTCPNodeImpl& = delete;
+
+  ~SpwRmapTCPNodeImpl() override {
+    if (!handler_threads_.empty()) {
+      // Jobs already dispatched are still served, before the writer stops.
+      {
+        std::lock_guard<std::mutex> lock(handler_mtx_);
+        handler_stop_ = true;
+      }
+      handler_work_cv_.notify_all();
+      for (auto& thread : handler_threads_) {
+        thread.join();
+      }
+    }
+    if (writer_thread_.joinable()) {
+      writer_stop_.store(true, std::memory_order_release);
+      enqueueFrame_(acquireFrame_());
+      writer_thread_.join();
+    }
+    if (timer_thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(timer_mtx_);
+        timer_stop_ = true;
+      }
+      timer_cv_.notify_one();
+      timer_thread_.join();
     }
   }
 
@@ -116,6 +333,49 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     initiator_logical_address_ = address;
   }
 
+  /**
+   * @brief Counters of socket calls and packets since construction or the
+   *        last `resetIoStatistics`.
+   */
+  [[nodiscard]] auto getIoStatistics() const noexcept -> SpwRmapIoStatistics {
+    return {
+        .recv_calls = recv_calls_.load(std::memory_order_relaxed),
+        .send_calls = send_calls_.load(std::memory_order_relaxed),
+        .packets_received = packets_received_.load(std::memory_order_relaxed),
+        .packets_sent = packets_sent_.load(std::memory_order_relaxed),
+    };
+  }
+
+  auto resetIoStatistics() noexcept -> void {
+    recv_calls_.store(0, std::memory_order_relaxed);
+    send_calls_.store(0, std::memory_order_relaxed);
+    packets_received_.store(0, std::memory_order_relaxed);
+    packets_sent_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Round-trip time measured for `target_logical_address`.
+   *
+   * With `adaptive_timeout`, every reply is timed from the arming of its
+   * transaction; otherwise nothing is measured and the estimate is empty.
+   */
+  [[nodiscard]] auto getRttEstimate(uint8_t target_logical_address) const
+      -> RttEstimate {
+    if (!target_rtts_) {
+      return {};
+    }
+    auto& target = target_rtts_[target_logical_address];
+    std::lock_guard<std::mutex> lock(target.mtx);
+    const auto& estimator = target.estimator;
+    return {
+        .smoothed_rtt = estimator.srtt(),
+        .rtt_variation = estimator.rttvar(),
+        .timeout = estimator.timeout(),
+        .samples = estimator.samples(),
+        .timeouts = estimator.timeouts(),
+    };
+  }
+
  protected:
   auto getBackend_() noexcept -> std::unique_ptr<Backend>& {
     return tcp_backend_;
@@ -141,6 +401,15 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     return send_timeout_;
   }
 
+  /**
+   * @brief Drop bytes staged from the previous connection. Waits for a
+   *        `poll` still receiving on another thread to return first.
+   */
+  auto resetReceiveBuffer_() noexcept -> void {
+    std::lock_guard<std::mutex> lock(recv_mtx_);
+    recv_stage_.clear();
+  }
+
   auto setSendTimeoutInternal_(std::chrono::microseconds timeout) noexcept
       -> std::expected<std::monostate, std::error_code> {
     if (timeout < std::chrono::microseconds::zero()) {
@@ -157,6 +426,21 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
   }
 
  private:
+  /**
+   * @brief `recvSome` of the backend, counted in the I/O statistics.
+   */
+  auto recvSomeFn_() noexcept {
+    return [this](std::span<uint8_t> buffer) {
+      recv_calls_.fetch_add(1, std::memory_order_relaxed);
+      return tcp_backend_->recvSome(buffer);
+    };
+  }
+
+  /**
+   * Receive exactly `buffer.size()` bytes. Reads go through `recv_stage_`, so
+   * the frame header, data and following frames usually come from one
+   * `recvSome`.
+   */
   auto recvExact_(std::span<uint8_t> buffer)
       -> std::expected<std::size_t, std::error_code> {
     if (!tcp_backend_) {
@@ -165,7 +449,7 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     }
     size_t total_length = buffer.size();
     while (!buffer.empty()) {
-      auto res = tcp_backend_->recvSome(buffer);
+      auto res = recv_stage_.readSome(buffer, recvSomeFn_());
       if (!res.has_value()) {
         return std::unexpected(res.error());
       }
@@ -177,6 +461,32 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     return total_length;
   }
 
+  /**
+   * Receive exactly `length` bytes into recv_buf_ at `offset`, feeding each
+   * chunk to data_crc_ as soon as it arrives.
+   */
+  auto recvPacketData_(std::size_t offset, std::size_t length)
+      -> std::expected<std::size_t, std::error_code> {
+    if (!tcp_backend_) {
+      spw_rmap::debug::debug(" Not connected");
+      return std::unexpected{std::make_error_code(std::errc::not_connected)};
+    }
+    auto buffer = std::span(recv_buf_).subspan(offset, length);
+    std::size_t received = 0;
+    while (received < length) {
+      auto res = recv_stage_.readSome(buffer.subspan(received), recvSomeFn_());
+      if (!res.has_value()) {
+        return std::unexpected(res.error());
+      }
+      if (res.value() == 0) {
+        return 0;
+      }
+      received += res.value();
+      data_crc_.advance(std::span(recv_buf_).first(offset + received));
+    }
+    return length;
+  }
+
   static inline auto calculateDataLength(
       const std::span<const uint8_t> header) noexcept
       -> std::expected<size_t, std::error_code> {
@@ -197,162 +507,514 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     return data_length;
   }
 
-  std::mutex recv_mtx_;
+  using PromiseType =
+      std::promise<std::expected<std::monostate, std::error_code>>;
 
-  struct AsyncOperation {
-    std::future<std::expected<std::monostate, std::error_code>> future;
-    std::optional<uint16_t> transaction_id;
+  // State of a future-returning transaction; too big for a slot, so the
+  // slot holds it by pointer.
+  struct FutureCompletion {
+    PromiseType promise;
+    std::function<void(Packet)> on_complete;
   };
 
-  using PromiseType =
-      std::promise<std::expected<std::monostate, std::error_code>>;
+  /**
+   * @brief Slot completion that passes a reply to the user callback and
+   *        settles the promise of `state`.
+   */
+  static auto makeFutureCallback_(
+      std::unique_ptr<FutureCompletion> state) noexcept
+      -> TransactionCallback {
+    return [state = std::move(state)](TransactionResult result) noexcept {
+      if (result.has_value()) {
+        try {
+          state->on_complete(**result);
+        } catch (const std::exception& e) {
+          spw_rmap::debug::debug("Exception in reply callback: ", e.what());
+          result = std::unexpected{
+              std::make_error_code(std::errc::operation_canceled)};
+        } catch (...) {
+          spw_rmap::debug::debug("Unknown exception in reply callback");
+          result = std::unexpected{
+              std::make_error_code(std::errc::operation_canceled)};
+        }
+      }
+      if (result.has_value()) {
+        state->promise.set_value({});
+      } else {
+        state->promise.set_value(std::unexpected{result.error()});
+      }
+    };
+  }
 
-  auto cancelTransaction_(uint16_t transaction_id) noexcept -> void {
-    if (transaction_id < transaction_id_min_ ||
-        transaction_id >= transaction_id_max_) {
-      return;
+  /**
+   * @brief Slot completion that copies read data to `data` and signals
+   *        `completion`. Allocation free.
+   */
+  static auto makeReadCallback_(TransactionCompletion* completion,
+                                std::span<uint8_t> data) noexcept
+      -> TransactionCallback {
+    return [completion, data](TransactionResult result) noexcept {
+      if (!result.has_value()) {
+        completion->complete(result.error());
+        return;
+      }
+      const auto& packet = **result;
+      if (packet.data.size() != data.size()) {
+        completion->complete(std::make_error_code(std::errc::bad_message));
+        return;
+      }
+      // Skipped when the reply was already copied into `data`.
+      if (packet.data.data() != data.data()) {
+        std::ranges::copy(packet.data, data.begin());
+      }
+      completion->complete({});
+    };
+  }
+
+  /**
+   * @brief Slot completion that signals `completion`. Allocation free.
+   */
+  static auto makeWriteCallback_(TransactionCompletion* completion) noexcept
+      -> TransactionCallback {
+    return [completion](TransactionResult result) noexcept {
+      completion->complete(result.has_value() ? std::error_code{}
+                                              : result.error());
+    };
+  }
+
+  /**
+   * @brief Slot completion that pushes the end of `request` to `queue`. A
+   *        successful read reply is copied to `request.read_data` first,
+   *        unless it was already copied there as it arrived.
+   */
+  static auto makeQueueCallback_(CompletionQueue* queue,
+                                 const RmapRequest& request) noexcept
+      -> TransactionCallback {
+    return [queue, user_data = request.user_data, data = request.read_data,
+            is_read = request.operation == RmapOperation::Read](
+               TransactionResult result) noexcept {
+      RmapCompletion completion{.user_data = user_data};
+      if (!result.has_value()) {
+        completion.error = result.error();
+      } else {
+        const auto& packet = **result;
+        completion.status = packet.status;
+        if (is_read && packet.status == 0) {
+          if (packet.data.size() != data.size()) {
+            completion.error = std::make_error_code(std::errc::bad_message);
+          } else if (packet.data.data() != data.data()) {
+            std::ranges::copy(packet.data, data.begin());
+          }
+        }
+      }
+      queue->push(completion);
+    };
+  }
+
+  /**
+   * @brief Run `count` transactions through `submit`, keeping up to
+   *        `window` of them in flight.
+   *
+   * `make(index)` builds transaction `index`. One that times out or finds
+   * no free transaction ID is started again, up to `retry_count` attempts
+   * in all. One that found no ID waits, with nothing new started, until
+   * a transaction of this run ends and frees one, or, with none in
+   * flight, for a backoff that doubles up to the transaction timeout.
+   * `finish(index, ec)` then gets the outcome of each transaction,
+   * with a non-zero RMAP status reported as `PacketStatusError`; once it
+   * returns false, nothing new is started and the rest are only drained.
+   * @throws std::bad_alloc
+   */
+  template <class MakeFn, class FinishFn>
+  auto runTransactions_(std::size_t count, std::size_t window,
+                        std::size_t retry_count, MakeFn&& make,
+                        FinishFn&& finish) -> void {
+    window = std::clamp<std::size_t>(window, 1, transaction_ids_.capacity());
+    retry_count = std::max<std::size_t>(retry_count, 1);
+    CompletionQueue queue(window);
+    std::vector<RmapRequest> requests(window);
+    std::vector<RmapCompletion> completions(window);
+    std::vector<std::size_t> retries;
+    std::vector<std::size_t> starved;  // Retries waiting for a free ID
+    std::vector<uint8_t> attempts(count, 0);
+    auto backoff = std::min<std::chrono::microseconds>(
+        std::chrono::milliseconds{1}, transaction_timeout_);
+    std::size_t next = 0;
+    std::size_t done = 0;
+    bool stopped = false;
+    while (done < count) {
+      std::size_t batch = 0;
+      while (!stopped && starved.empty() &&
+             queue.outstanding() + batch < window &&
+             (!retries.empty() || next < count)) {
+        std::size_t index = 0;
+        if (!retries.empty()) {
+          index = retries.back();
+          retries.pop_back();
+        } else {
+          index = next++;
+        }
+        auto& request = requests[batch++];
+        request = make(index);
+        request.user_data = index;
+      }
+      // Room was checked above, so the whole batch is accepted.
+      std::ignore = submit(queue, std::span(requests).first(batch));
+      if (queue.outstanding() == 0) {
+        if (starved.empty() || stopped) {
+          break;
+        }
+        // The IDs are all held elsewhere; none of ours will free one.
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, transaction_timeout_);
+        retries.insert(retries.end(), starved.begin(), starved.end());
+        starved.clear();
+        continue;
+      }
+      const auto reaped = queue.reap(completions, 1);
+      bool freed = false;
+      for (std::size_t i = 0; i < reaped; ++i) {
+        const auto& completion = completions[i];
+        const auto index = static_cast<std::size_t>(completion.user_data);
+        auto ec = completion.error;
+        if (!ec && completion.status != 0) {
+          ec = make_error_code(PacketParser::Status::PacketStatusError);
+        }
+        const bool no_id = ec == std::errc::resource_unavailable_try_again;
+        // Only a transaction that got an ID gives one back.
+        freed = freed || !no_id;
+        if ((no_id || ec == std::errc::timed_out) &&
+            ++attempts[index] < retry_count && !stopped) {
+          (no_id ? starved : retries).push_back(index);
+          continue;
+        }
+        ++done;
+        if (!finish(index, ec)) {
+          stopped = true;
+        }
+      }
+      if (freed && !starved.empty()) {
+        retries.insert(retries.end(), starved.begin(), starved.end());
+        starved.clear();
+      }
     }
-    const auto idx = transaction_id - transaction_id_min_;
-    {
-      std::lock_guard<std::mutex> lock(*reply_callback_mtx_[idx]);
-      reply_callback_[idx] = nullptr;
-      reply_error_callback_[idx] = nullptr;
+  }
+
+  /**
+   * @brief Body of `bulkWrite` / `bulkRead`: one transaction per chunk.
+   *        Reads fill `read_data`, which aliases `data`.
+   */
+  auto bulkTransfer_(RmapOperation operation,
+                     std::shared_ptr<TargetNodeBase> target_node,
+                     uint32_t memory_address, std::span<const uint8_t> data,
+                     std::span<uint8_t> read_data, std::size_t chunk_size,
+                     std::size_t window, std::size_t retry_count) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (data.empty()) {
+      return {};
     }
-    releaseTransactionID_(transaction_id);
+    // The last chunk's address would wrap past the 32-bit address space.
+    if (data.size() > std::size_t{0x100000000} - memory_address) {
+      return std::unexpected{
+          std::make_error_code(std::errc::invalid_argument)};
+    }
+    // The RMAP data length field is 24 bits wide.
+    chunk_size = std::clamp<std::size_t>(chunk_size, 1, 0xFFFFFF);
+    const auto chunks = (data.size() + chunk_size - 1) / chunk_size;
+    std::error_code error{};
+    try {
+      runTransactions_(
+          chunks, window, retry_count,
+          [&](std::size_t chunk) {
+            const auto offset = chunk * chunk_size;
+            const auto size = std::min(chunk_size, data.size() - offset);
+            RmapRequest request{
+                .operation = operation,
+                .target_node = target_node,
+                .memory_address =
+                    memory_address + static_cast<uint32_t>(offset)};
+            if (operation == RmapOperation::Read) {
+              request.read_data = read_data.subspan(offset, size);
+            } else {
+              request.write_data = data.subspan(offset, size);
+            }
+            return request;
+          },
+          [&](std::size_t /*chunk*/, std::error_code ec) {
+            if (ec && !error) {
+              spw_rmap::debug::debug("Bulk transfer chunk failed: ",
+                                     ec.message());
+              error = ec;
+            }
+            return !error;
+          });
+    } catch (const std::bad_alloc&) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    if (error) {
+      return std::unexpected{error};
+    }
+    return {};
   }
 
-  auto startWriteAsyncOperation_(
-      std::shared_ptr<TargetNodeBase> target_node, uint32_t memory_address,
-      const std::span<const uint8_t> data,
-      std::function<void(Packet)> on_complete) noexcept -> AsyncOperation {
-    AsyncOperation op{};
-    auto promise = std::make_shared<PromiseType>();
-    op.future = promise->get_future();
+  /**
+   * @brief Requests of a `readMany` / `writeMany` sent as one transaction:
+   *        `order[first, first + count)`, which lie in `length` bytes from
+   *        `memory_address`. A run of several is staged at `staging`.
+   */
+  struct BatchRun {
+    uint32_t memory_address = 0;
+    std::size_t length = 0;
+    std::size_t first = 0;
+    std::size_t count = 0;
+    std::size_t staging = 0;
+  };
 
-    auto transaction_id_res = getAvailableTransactionID_();
-    if (!transaction_id_res.has_value()) {
-      spw_rmap::debug::debug(
-          "Failed to get available Transaction ID for writeAsync");
-      promise->set_value(std::unexpected{transaction_id_res.error()});
-      return op;
-    }
-    op.transaction_id = transaction_id_res.value();
-    const auto transaction_id = *op.transaction_id;
-    const auto tx_index = transaction_id - transaction_id_min_;
-    {
-      std::lock_guard<std::mutex> lock(*reply_callback_mtx_[tx_index]);
-      reply_error_callback_[tx_index] =
-          [this, promise, transaction_id,
-           tx_index](std::error_code ec) mutable noexcept -> void {
-        promise->set_value(std::unexpected{ec});
-        releaseTransactionID_(transaction_id);
-        reply_error_callback_[tx_index] = nullptr;
-      };
-      reply_callback_[tx_index] =
-          [this, on_complete = std::move(on_complete), promise, transaction_id,
-           tx_index](const Packet& packet) mutable noexcept -> void {
-        try {
-          on_complete(packet);
-        } catch (const std::exception& e) {
-          spw_rmap::debug::debug("Exception in writeAsync callback: ", e.what());
-          promise->set_value(std::unexpected{
-              std::make_error_code(std::errc::operation_canceled)});
-          releaseTransactionID_(transaction_id);
-          reply_error_callback_[tx_index] = nullptr;
-          return;
-        } catch (...) {
-          spw_rmap::debug::debug("Unknown exception in writeAsync callback");
-          promise->set_value(std::unexpected{
-              std::make_error_code(std::errc::operation_canceled)});
-          releaseTransactionID_(transaction_id);
-          reply_error_callback_[tx_index] = nullptr;
-          return;
+  /**
+   * @brief Group the non-empty `requests` into runs, listing their indices
+   *        run by run in `order`.
+   *
+   * With `merge`, requests sorted by address join the previous run while
+   * they continue it exactly and the run stays within
+   * `kDefaultBulkChunkSize` bytes. Overlapping requests are never merged:
+   * a read would touch the shared registers once for several requests,
+   * and a write would depend on the order of the copies.
+   * @return The staging bytes needed by runs of more than one request.
+   * @throws std::bad_alloc
+   */
+  template <class Request>
+  static auto planRuns_(std::span<const Request> requests, bool merge,
+                        std::vector<std::size_t>& order,
+                        std::vector<BatchRun>& runs) -> std::size_t {
+    order.clear();
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+      if (!requests[i].data.empty()) {
+        order.push_back(i);
+      }
+    }
+    if (merge) {
+      std::ranges::stable_sort(order, {}, [&](std::size_t i) {
+        return requests[i].memory_address;
+      });
+    }
+    runs.clear();
+    std::size_t staging = 0;
+    for (std::size_t pos = 0; pos < order.size(); ++pos) {
+      const auto& request = requests[order[pos]];
+      const uint64_t begin = request.memory_address;
+      const uint64_t end = begin + request.data.size();
+      if (merge && !runs.empty()) {
+        auto& run = runs.back();
+        const uint64_t run_end = run.memory_address + run.length;
+        if (begin == run_end &&
+            end - run.memory_address <= kDefaultBulkChunkSize) {
+          run.length = static_cast<std::size_t>(end - run.memory_address);
+          ++run.count;
+          continue;
         }
-        promise->set_value({});
-        releaseTransactionID_(transaction_id);
-        reply_error_callback_[tx_index] = nullptr;
-      };
+      }
+      runs.push_back({.memory_address = request.memory_address,
+                      .length = request.data.size(),
+                      .first = pos,
+                      .count = 1});
+    }
+    for (auto& run : runs) {
+      if (run.count > 1) {
+        run.staging = staging;
+        staging += run.length;
+      }
     }
+    return staging;
+  }
 
-    auto res = sendWritePacket_(std::move(target_node), transaction_id,
-                                memory_address, data);
-    if (!res.has_value()) {
-      {
-        std::lock_guard<std::mutex> lock(*reply_callback_mtx_[tx_index]);
-        reply_callback_[tx_index] = nullptr;
-        reply_error_callback_[tx_index] = nullptr;
+  /**
+   * @brief Body of `readMany` / `writeMany`: one transaction per run of
+   *        `planRuns_`, all in flight together.
+   */
+  template <class Request>
+  auto transferMany_(RmapOperation operation,
+                     std::shared_ptr<TargetNodeBase> target_node,
+                     std::span<const Request> requests,
+                     std::span<std::error_code> results, bool merge,
+                     std::size_t retry_count) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (!results.empty() && results.size() != requests.size()) {
+      return std::unexpected{
+          std::make_error_code(std::errc::invalid_argument)};
+    }
+    std::ranges::fill(results, std::error_code{});
+    const bool is_read = operation == RmapOperation::Read;
+    std::error_code error{};
+    std::size_t error_item = requests.size();
+    try {
+      std::vector<std::size_t> order;
+      std::vector<BatchRun> runs;
+      std::vector<uint8_t> staging(
+          planRuns_(requests, merge, order, runs));
+      const auto items = [&](const BatchRun& run) {
+        return std::span(order).subspan(run.first, run.count);
+      };
+      const auto placeOf = [&](const BatchRun& run, std::size_t item) {
+        return std::span(staging).subspan(
+            run.staging + (requests[item].memory_address - run.memory_address),
+            requests[item].data.size());
+      };
+      for (const auto& run : runs) {
+        if (!is_read && run.count > 1) {
+          for (const auto item : items(run)) {
+            std::ranges::copy(requests[item].data, placeOf(run, item).begin());
+          }
+        }
       }
-      promise->set_value(std::unexpected{res.error()});
-      releaseTransactionID_(transaction_id);
-      op.transaction_id.reset();
+      runTransactions_(
+          runs.size(), runs.size(), retry_count,
+          [&](std::size_t index) {
+            const auto& run = runs[index];
+            RmapRequest request{.operation = operation,
+                                .target_node = target_node,
+                                .memory_address = run.memory_address};
+            const auto data =
+                run.count > 1
+                    ? std::span(staging).subspan(run.staging, run.length)
+                    : std::span<uint8_t>{};
+            if constexpr (std::is_same_v<Request, ReadRequest>) {
+              request.read_data =
+                  run.count > 1 ? data : requests[order[run.first]].data;
+            } else {
+              request.write_data =
+                  run.count > 1 ? std::span<const uint8_t>(data)
+                                : requests[order[run.first]].data;
+            }
+            return request;
+          },
+          [&](std::size_t index, std::error_code ec) {
+            const auto& run = runs[index];
+            for (const auto item : items(run)) {
+              if constexpr (std::is_same_v<Request, ReadRequest>) {
+                if (!ec && run.count > 1) {
+                  std::ranges::copy(placeOf(run, item),
+                                    requests[item].data.begin());
+                }
+              }
+              if (!results.empty()) {
+                results[item] = ec;
+              }
+              if (ec && item < error_item) {
+                error = ec;
+                error_item = item;
+              }
+            }
+            return true;
+          });
+    } catch (const std::bad_alloc&) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    if (error) {
+      return std::unexpected{error};
     }
-    return op;
+    return {};
   }
 
-  auto startReadAsyncOperation_(
-      std::shared_ptr<TargetNodeBase> target_node, uint32_t memory_address,
-      uint32_t data_length, std::function<void(Packet)> on_complete) noexcept
-      -> AsyncOperation {
-    AsyncOperation op{};
-    auto promise = std::make_shared<PromiseType>();
-    op.future = promise->get_future();
+  /**
+   * @brief Run `start(completion)` and wait for the completion, again while
+   *        it times out, up to `retry_count` attempts.
+   */
+  template <class StartFn>
+  static auto retry_(std::size_t retry_count, StartFn&& start) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    retry_count = retry_count == 0 ? 1 : retry_count;
+    std::error_code last_error = std::make_error_code(std::errc::timed_out);
+    for (std::size_t attempt = 0; attempt < retry_count; ++attempt) {
+      TransactionCompletion completion;
+      start(completion);
+      auto res = completion.result();
+      if (res.has_value()) {
+        return {};
+      }
+      if (res.error() != std::errc::timed_out) {
+        return std::unexpected{res.error()};
+      }
+      last_error = res.error();
+    }
+    return std::unexpected{last_error};
+  }
 
+  /**
+   * @brief Allocate an ID, arm it with `on_complete` and a deadline of
+   *        `timeout`, and send the command. `on_complete` runs exactly
+   *        once, with an error if the transaction could not be started.
+   *
+   * @param target_logical_address Whose round-trip times the transaction
+   *        is timed against.
+   * @param send Called with the allocated transaction ID; sends the command.
+   * @param timeout Used as is unless adaptive timeouts are on.
+   * @param reply_sink Where the data of a read reply of exactly its size
+   *        is copied from the receive buffer as it arrives, so it need not
+   *        fit `recv_buf_`; empty for none.
+   */
+  template <class SendFn>
+  auto startTransaction_(uint8_t target_logical_address, SendFn&& send,
+                         TransactionCallback on_complete,
+                         std::chrono::steady_clock::duration timeout,
+                         std::span<uint8_t> reply_sink = {}) noexcept
+      -> void {
     auto transaction_id_res = getAvailableTransactionID_();
     if (!transaction_id_res.has_value()) {
-      promise->set_value(std::unexpected{transaction_id_res.error()});
-      return op;
+      spw_rmap::debug::debug("No Transaction ID available");
+      on_complete(std::unexpected{transaction_id_res.error()});
+      return;
     }
-    op.transaction_id = transaction_id_res.value();
-    const auto transaction_id = *op.transaction_id;
-    const auto tx_index = transaction_id - transaction_id_min_;
-    {
-      std::lock_guard<std::mutex> lock(*reply_callback_mtx_[tx_index]);
-      reply_error_callback_[tx_index] =
-          [this, promise, transaction_id,
-           tx_index](std::error_code ec) mutable noexcept -> void {
-        promise->set_value(std::unexpected{ec});
-        releaseTransactionID_(transaction_id);
-        reply_error_callback_[tx_index] = nullptr;
-      };
-      reply_callback_[tx_index] =
-          [this, on_complete = std::move(on_complete), promise, transaction_id,
-           tx_index](const Packet& packet) mutable noexcept -> void {
-        try {
-          on_complete(packet);
-        } catch (const std::exception& e) {
-          spw_rmap::debug::debug("Exception in readAsync callback: ", e.what());
-          promise->set_value(std::unexpected{
-              std::make_error_code(std::errc::operation_canceled)});
-          releaseTransactionID_(transaction_id);
-          reply_error_callback_[tx_index] = nullptr;
-          return;
-        } catch (...) {
-          spw_rmap::debug::debug("Unknown exception in readAsync callback");
-          promise->set_value(std::unexpected{
-              std::make_error_code(std::errc::operation_canceled)});
-          releaseTransactionID_(transaction_id);
-          reply_error_callback_[tx_index] = nullptr;
-          return;
-        }
-        promise->set_value({});
-        releaseTransactionID_(transaction_id);
-        reply_error_callback_[tx_index] = nullptr;
-      };
+    const auto transaction_id = static_cast<uint16_t>(*transaction_id_res);
+    const auto armed =
+        armTransaction_(transaction_id, std::move(on_complete),
+                        timeoutFor_(target_logical_address, timeout),
+                        {.reply_sink = reply_sink,
+                         .target_logical_address = target_logical_address});
+    auto res = std::forward<SendFn>(send)(transaction_id);
+    if (!res.has_value()) {
+      // Unless the reply or the deadline got there first.
+      completeTransaction_(transaction_id, armed, std::unexpected{res.error()});
     }
+  }
 
-    auto res = sendReadPacket_(std::move(target_node), transaction_id,
-                               memory_address, data_length);
-    if (!res.has_value()) {
-      {
-        std::lock_guard<std::mutex> lock(*reply_callback_mtx_[tx_index]);
-        reply_callback_[tx_index] = nullptr;
-        reply_error_callback_[tx_index] = nullptr;
-      }
-      promise->set_value(std::unexpected{res.error()});
-      releaseTransactionID_(transaction_id);
-      op.transaction_id.reset();
+  /**
+   * @brief Run the completion of `transaction_id` with `result` if the
+   *        armed transaction of generation `armed` is still pending.
+   */
+  auto completeTransaction_(uint16_t transaction_id, uint32_t armed,
+                            TransactionResult result) noexcept -> void {
+    auto& slot = transaction_slots_[transaction_id - transaction_id_min_];
+    if (slot.claim(armed)) {
+      finishClaimed_(transaction_id, result);
     }
-    return op;
+  }
+
+  /**
+   * @brief Free a claimed transaction, then run its completion; the ID is
+   *        reusable by the time anyone waiting on it wakes up.
+   */
+  auto finishClaimed_(uint16_t transaction_id,
+                      TransactionResult result) noexcept -> void {
+    auto on_complete = takeClaimed_(transaction_id);
+    on_complete(result);
+  }
+
+  /**
+   * @brief Free a claimed transaction and return its completion, to be
+   *        run elsewhere.
+   *
+   * The ID is free from here on, before the completion has run. A new
+   * transaction may reuse it at once, and that one's reply may be
+   * completed while the old completion is still running on a handler
+   * thread; completions must not assume they see their ID's last reply.
+   */
+  auto takeClaimed_(uint16_t transaction_id) noexcept -> TransactionCallback {
+    auto& slot = transaction_slots_[transaction_id - transaction_id_min_];
+    auto on_complete = std::move(slot.on_complete);
+    releaseTransactionID_(transaction_id);
+    return on_complete;
   }
 
   auto recvAndParseOnePacket_() -> std::expected<std::size_t, std::error_code> {
@@ -363,6 +1025,7 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     size_t total_size = 0;
     auto eof = false;
     auto recv_buffer = std::span(recv_buf_);
+    data_crc_.reset();
     while (!eof) {
       std::array<uint8_t, 12> header{};
       auto res = recvExact_(header);
@@ -394,6 +1057,22 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
         spw_rmap::debug::debug("Received packet with zero data length");
         return std::unexpected{std::make_error_code(std::errc::bad_message)};
       }
+      ReplyHead head{};
+      if (header.at(0) == 0x00 && total_size == 0) {
+        auto res = recvReplyHead_(*dataLength);
+        if (!res.has_value()) {
+          return std::unexpected(res.error());
+        }
+        if (res->dropped) {
+          packets_received_.fetch_add(1, std::memory_order_relaxed);
+          return recvAndParseOnePacket_();
+        }
+        if (res->delivered) {
+          packets_received_.fetch_add(1, std::memory_order_relaxed);
+          return *dataLength;
+        }
+        head = *res;
+      }
       if (*dataLength > recv_buffer.size()) {
         if (buffer_policy_ == BufferPolicy::Fixed) {
           spw_rmap::debug::debug(
@@ -407,13 +1086,14 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
       }
       switch (header.at(0)) {
         case 0x00: {
-          auto res = recvExact_(recv_buffer.first(*dataLength));
+          auto res = recvPacketData_(total_size + head.consumed,
+                                     *dataLength - head.consumed);
           if (!res.has_value()) {
             spw_rmap::debug::debug(
                 "Failed to receive packet data of type 0x00");
             return std::unexpected(res.error());
           }
-          total_size += *res;
+          total_size += head.consumed + *res;
           eof = true;
         } break;
         case 0x01: {
@@ -425,7 +1105,7 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
           return recvAndParseOnePacket_();
         } break;
         case 0x02: {
-          auto res = recvExact_(recv_buffer.first(*dataLength));
+          auto res = recvPacketData_(total_size, *dataLength);
           if (!res.has_value()) {
             spw_rmap::debug::debug(
                 "Failed to receive packet data of type 0x02");
@@ -464,14 +1144,164 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
           return std::unexpected{std::make_error_code(std::errc::bad_message)};
       }
     }
-    auto status = packet_parser_.parse(std::span(recv_buf_).first(total_size));
+    const auto packet = std::span<const uint8_t>(recv_buf_).first(total_size);
+    auto status = packet_parser_.parse(packet, data_crc_.result(packet));
     if (status != PacketParser::Status::Success) {
       spw_rmap::debug::debug("Failed to parse received packet");
       return std::unexpected{make_error_code(status)};
     }
+    packets_received_.fetch_add(1, std::memory_order_relaxed);
     return total_size;
   }
 
+  struct ReplyHead {
+    std::size_t consumed = 0;
+    bool delivered = false;
+    bool dropped = false;
+  };
+
+  /**
+   * @brief Receive the head of a single-frame packet of `frame_size` bytes
+   *        into `recv_buf_`; if it is the read reply of a pending
+   *        transaction, mark the transaction receiving and, when it
+   *        registered a reply sink of the reply's data length, receive the
+   *        data into the sink.
+   *
+   * The transaction is left in `receiving_reply_` for `poll`, which claims
+   * it and completes it with the packet or with the error that ended its
+   * reception; a bad data CRC leaves the sink overwritten. Its deadline
+   * stays in force meanwhile. Data is copied into the sink only while the
+   * transaction is claimed, and the socket is waited on with the claim
+   * handed back, so a peer that stalls mid-reply cannot hold the caller
+   * past its deadline. Once the deadline has taken the transaction, the
+   * rest of the reply is dropped. The data CRC is computed chunk by chunk
+   * as the data lands. Bytes of any other packet stay in `recv_buf_` for
+   * the regular path.
+   * @return The bytes consumed and whether the whole reply was delivered,
+   *         or dropped after its transaction timed out.
+   */
+  auto recvReplyHead_(std::size_t frame_size)
+      -> std::expected<ReplyHead, std::error_code> {
+    ReplyHead head{};
+    const auto limit = std::min(frame_size, recv_buf_.size());
+    // The reply address bytes before the header are all below 0x20.
+    do {
+      if (head.consumed + 12 > limit) {
+        return head;
+      }
+      auto res = recvExact_(std::span(recv_buf_).subspan(head.consumed, 1));
+      if (!res.has_value()) {
+        return std::unexpected(res.error());
+      }
+      if (*res == 0) {
+        return std::unexpected{
+            std::make_error_code(std::errc::connection_aborted)};
+      }
+      ++head.consumed;
+    } while (recv_buf_[head.consumed - 1] < 0x20);
+    auto res = recvExact_(std::span(recv_buf_).subspan(head.consumed, 11));
+    if (!res.has_value()) {
+      return std::unexpected(res.error());
+    }
+    if (*res == 0) {
+      return std::unexpected{
+          std::make_error_code(std::errc::connection_aborted)};
+    }
+    head.consumed += 11;
+
+    const auto head_bytes = std::span<const uint8_t>(recv_buf_).first(
+        head.consumed);
+    if (packet_parser_.parseReadReplyHeader(head_bytes, {}) !=
+        PacketParser::Status::Success) {
+      return head;
+    }
+    const auto& packet = packet_parser_.getPacket();
+    const auto transaction_id = packet.transactionID;
+    if (frame_size != head.consumed + packet.dataLength + 1 ||
+        transaction_id < transaction_id_min_ ||
+        transaction_id >= transaction_id_max_) {
+      return head;
+    }
+    const auto index = transaction_id - transaction_id_min_;
+    auto& slot = transaction_slots_[index];
+    if (!slot.claim()) {
+      return head;
+    }
+    // The context is only stable while the transaction is claimed.
+    const auto sink = slot_contexts_[index].reply_sink;
+    const auto deadline_tick = slot_contexts_[index].deadline_tick;
+    const auto receiving = slot.receiving();
+    receiving_reply_ = {transaction_id, receiving};
+    if (sink.empty() || sink.size() != packet.dataLength) {
+      return head;
+    }
+
+    crc::CRCAccumulator data_crc{};
+    std::size_t received = 0;
+    while (received < sink.size()) {
+      if (recv_stage_.buffered() == 0 && timerTick_() >= deadline_tick) {
+        // The timer may have found the transaction claimed for a copy.
+        if (slot.claim(receiving)) {
+          expireClaimed_(index);
+        }
+        return dropReply_(frame_size - head.consumed - received);
+      }
+      auto res = recv_stage_.fill(recvSomeFn_());
+      if (!res.has_value()) {
+        return std::unexpected(res.error());
+      }
+      if (*res == 0) {
+        return std::unexpected{
+            std::make_error_code(std::errc::connection_aborted)};
+      }
+      if (!slot.claim(receiving)) {
+        return dropReply_(frame_size - head.consumed - received);
+      }
+      // Only copies what `fill` buffered; the caller's memory is never
+      // the target of a blocking receive.
+      const auto copied =
+          recv_stage_.readSome(sink.subspan(received), recvSomeFn_());
+      if (copied.has_value()) {
+        data_crc.update(sink.subspan(received, *copied));
+        received += *copied;
+      }
+      slot.receiving();
+    }
+    std::array<uint8_t, 1> crc_byte{};
+    auto crc_res = recvExact_(crc_byte);
+    if (!crc_res.has_value()) {
+      return std::unexpected(crc_res.error());
+    }
+    if (*crc_res == 0) {
+      return std::unexpected{
+          std::make_error_code(std::errc::connection_aborted)};
+    }
+    data_crc.update(crc_byte);
+    if (data_crc.value() != 0x00) {
+      spw_rmap::debug::debug("Read reply data CRC mismatch, TID: ",
+                             transaction_id);
+      return std::unexpected{
+          make_error_code(PacketParser::Status::DataCRCError)};
+    }
+    std::ignore = packet_parser_.parseReadReplyHeader(head_bytes, sink);
+    return ReplyHead{.consumed = frame_size, .delivered = true};
+  }
+
+  /**
+   * @brief Skip the last `remaining` bytes of a reply whose transaction
+   *        timed out while it was being received.
+   */
+  auto dropReply_(std::size_t remaining)
+      -> std::expected<ReplyHead, std::error_code> {
+    spw_rmap::debug::debug("Dropping read reply received past its deadline");
+    receiving_reply_.reset();
+    auto res = ignoreNBytes_(remaining);
+    if (!res.has_value()) {
+      return std::unexpected(res.error());
+    }
+    return ReplyHead{.consumed = 0, .delivered = false, .dropped = true};
+  }
+
   auto ignoreNBytes_(std::size_t n)
       -> std::expected<std::size_t, std::error_code> {
     if (!tcp_backend_) {
@@ -479,9 +1309,8 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
       return std::unexpected{std::make_error_code(std::errc::not_connected)};
     }
     const size_t requested_size = n;
-    std::array<uint8_t, 16> ignore_buffer{};
-    while (n > ignore_buffer.size()) {
-      auto res = tcp_backend_->recvSome(ignore_buffer);
+    while (n > 0) {
+      auto res = recv_stage_.skip(n, recvSomeFn_());
       if (!res.has_value()) {
         spw_rmap::debug::debug("Failed to receive data to ignore");
         return std::unexpected{res.error()};
@@ -493,19 +1322,23 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
       }
       n -= res.value();
     }
-    if (n > 0) {
-      auto res = recvExact_(std::span(ignore_buffer).first(n));
-      if (!res.has_value()) {
-        spw_rmap::debug::debug("Failed to receive data to ignore");
-        return std::unexpected{res.error()};
-      }
-    }
     return requested_size;
   }
 
   auto send_(size_t total_size)
       -> std::expected<std::monostate, std::error_code> {
-    auto send_buffer = std::span(send_buf_);
+    writeFrameHeader_(send_buf_, total_size);
+    countSend_();
+    return tcp_backend_->sendAll(std::span(send_buf_).first(total_size + 12));
+  }
+
+  auto countSend_() noexcept -> void {
+    send_calls_.fetch_add(1, std::memory_order_relaxed);
+    packets_sent_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static auto writeFrameHeader_(std::span<uint8_t> send_buffer,
+                                size_t total_size) noexcept -> void {
     send_buffer[0] = 0x00;
     send_buffer[1] = 0x00;
     send_buffer[2] = 0x00;
@@ -518,34 +1351,292 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     send_buffer[9] = static_cast<uint8_t>((total_size >> 16) & 0xFF);
     send_buffer[10] = static_cast<uint8_t>((total_size >> 8) & 0xFF);
     send_buffer[11] = static_cast<uint8_t>((total_size >> 0) & 0xFF);
-    return tcp_backend_->sendAll(std::span(send_buf_).first(total_size + 12));
   }
 
-  auto sendReadPacket_(std::shared_ptr<TargetNodeBase> target_node,
-                       uint16_t transaction_id, uint32_t memory_address,
-                       uint32_t data_length) noexcept
+  /**
+   * @brief Send the `header_size` bytes after the frame header in
+   *        `send_buf_`, then `payload` and its CRC, in one scatter-gather
+   *        write. The payload is never copied into `send_buf_`. Caller holds
+   *        `send_buf_mtx_`.
+   */
+  auto sendWithPayload_(size_t header_size, std::span<const uint8_t> payload)
       -> std::expected<std::monostate, std::error_code> {
-    if (!tcp_backend_) {
-      spw_rmap::debug::debug("Not connected");
-      return std::unexpected{std::make_error_code(std::errc::not_connected)};
-    }
-    auto expected_length = target_node->getTargetSpaceWireAddress().size() +
-                           (target_node->getReplyAddress().size() + 3) / 4 * 4 +
-                           4 + 12 + 1;
-    std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
-    auto send_buffer = std::span(send_buf_);
-    if (expected_length > send_buffer.size()) {
-      if (buffer_policy_ == BufferPolicy::Fixed) {
-        spw_rmap::debug::debug("Send buffer too small for Read Packet");
-        return std::unexpected{
-            std::make_error_code(std::errc::no_buffer_space)};
-      } else {
-        send_buf_.resize(expected_length);
-        send_buffer = std::span(send_buf_);
+    writeFrameHeader_(send_buf_, header_size + payload.size() + 1);
+    const std::array<uint8_t, 1> payload_crc = {crc::calcCRC(payload)};
+    const std::array<std::span<const uint8_t>, 3> buffers = {
+        std::span<const uint8_t>(send_buf_).first(header_size + 12), payload,
+        payload_crc};
+    countSend_();
+    return tcp_backend_->sendAllv(buffers);
+  }
+
+  /**
+   * @brief Send one frame. `fill` writes the `size` bytes after the frame
+   *        header; `payload` and its CRC follow when given.
+   *
+   * Without a writer thread the frame is built in `send_buf_` and sent under
+   * `send_buf_mtx_`. With one it is built in its own buffer and queued, so
+   * callers do not serialise on the mutex or the socket. A failed send is
+   * then reported through the error callback of `transaction_id`.
+   *
+   * @param fill Callable taking `std::span<uint8_t>` and returning
+   *        `std::expected<std::monostate, std::error_code>`.
+   */
+  template <class Fill>
+  auto sendFrame_(std::size_t size, Fill&& fill,
+                  std::optional<std::span<const uint8_t>> payload,
+                  std::optional<uint16_t> transaction_id) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (!use_writer_thread_) {
+      std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
+      if (auto res = reserveSendBuffer_(size + 12); !res.has_value()) {
+        spw_rmap::debug::debug("Send buffer too small for frame");
+        return std::unexpected{res.error()};
       }
+      if (auto res = fill(std::span(send_buf_).subspan(12, size));
+          !res.has_value()) {
+        return std::unexpected{res.error()};
+      }
+      if (!payload.has_value()) {
+        return send_(size);
+      }
+      return sendWithPayload_(size, *payload);
+    }
+    auto frame = acquireFrame_();
+    frame->transaction_id = transaction_id;
+    if (auto res = buildFrame_(frame->bytes, size, fill, payload);
+        !res.has_value()) {
+      return std::unexpected{res.error()};
     }
+    enqueueFrame_(std::move(frame));
+    return {};
+  }
 
-    auto config = ReadPacketConfig{
+  /**
+   * @brief Build a whole frame, as `sendFrame_` describes it, into `bytes`;
+   *        left empty if `fill` fails.
+   */
+  template <class Fill>
+  auto buildFrame_(std::vector<uint8_t>& bytes, std::size_t size, Fill&& fill,
+                   std::optional<std::span<const uint8_t>> payload) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (buffer_policy_ == BufferPolicy::Fixed && size + 12 > send_buf_.size()) {
+      spw_rmap::debug::debug("Send buffer too small for frame");
+      return std::unexpected{std::make_error_code(std::errc::no_buffer_space)};
+    }
+    const auto total_size =
+        size + (payload.has_value() ? payload->size() + 1 : 0);
+    bytes.resize(total_size + 12);
+    auto out = std::span(bytes);
+    writeFrameHeader_(out, total_size);
+    if (auto res = fill(out.subspan(12, size)); !res.has_value()) {
+      bytes.clear();
+      return std::unexpected{res.error()};
+    }
+    if (payload.has_value()) {
+      out.back() = crc::copyAndCalcCRC(*payload, out.subspan(12 + size));
+    }
+    return {};
+  }
+
+  /**
+   * @brief Send the reply to a command, or, for a command served by a
+   *        handler thread, build it into `job` to be sent in order.
+   */
+  template <class Fill>
+  auto sendReply_(std::size_t size, Fill&& fill,
+                  std::optional<std::span<const uint8_t>> payload,
+                  HandlerJob* job) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (job == nullptr) {
+      return sendFrame_(size, std::forward<Fill>(fill), payload,
+                        std::nullopt);
+    }
+    return buildFrame_(job->reply, size, std::forward<Fill>(fill), payload);
+  }
+
+  auto enqueueFrame_(std::unique_ptr<OutgoingFrame> frame) noexcept -> void {
+    send_queue_.push(frame.release());
+    if (send_queue_size_.fetch_add(1) == 0) {
+      send_queue_size_.notify_one();
+      if (writer_lingering_.load()) {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        writer_cv_.notify_one();
+      }
+    }
+  }
+
+  /**
+   * @brief An empty frame, from the pool if one is there. Its buffer keeps
+   *        the capacity it had.
+   */
+  auto acquireFrame_() noexcept -> std::unique_ptr<OutgoingFrame> {
+    {
+      std::lock_guard<std::mutex> lock(frame_pool_mtx_);
+      if (!frame_pool_.empty()) {
+        auto frame = std::move(frame_pool_.back());
+        frame_pool_.pop_back();
+        return frame;
+      }
+    }
+    return std::make_unique<OutgoingFrame>();
+  }
+
+  /**
+   * @brief Return the frames of a sent batch to the pool; frames beyond its
+   *        size, or larger than a batch, are freed.
+   */
+  auto recycleFrames_(
+      std::vector<std::unique_ptr<OutgoingFrame>>& batch) noexcept -> void {
+    std::lock_guard<std::mutex> lock(frame_pool_mtx_);
+    for (auto& frame : batch) {
+      if (frame_pool_.size() < kFramePoolSize &&
+          frame->bytes.capacity() <= writer_max_batch_bytes_) {
+        frame->bytes.clear();
+        frame->transaction_id.reset();
+        frame_pool_.push_back(std::move(frame));
+      }
+    }
+    batch.clear();
+  }
+
+  /**
+   * @brief Body of the writer thread: take every queued frame, up to
+   *        `writer_max_batch_bytes_`, and send them with one `sendAllv`.
+   */
+  auto writerLoop_() noexcept -> void {
+    std::vector<std::unique_ptr<OutgoingFrame>> batch;
+    std::vector<std::span<const uint8_t>> buffers;
+    for (;;) {
+      auto queued = send_queue_size_.load(std::memory_order_acquire);
+      if (queued == 0) {
+        if (writer_stop_.load(std::memory_order_acquire)) {
+          return;
+        }
+        send_queue_size_.wait(0, std::memory_order_acquire);
+        continue;
+      }
+      const auto batch_start = std::chrono::steady_clock::now();
+      std::size_t batch_bytes = 0;
+      for (;;) {
+        while (queued > 0 && batch_bytes < writer_max_batch_bytes_) {
+          OutgoingFrame* frame = send_queue_.pop();
+          if (frame == nullptr) {
+            std::this_thread::yield();  // Counted but not linked yet
+            continue;
+          }
+          send_queue_size_.fetch_sub(1, std::memory_order_acq_rel);
+          --queued;
+          batch_bytes += frame->bytes.size();
+          batch.emplace_back(frame);
+        }
+        const auto deadline = batch_start + writer_latency_bound_;
+        if (batch_bytes >= writer_max_batch_bytes_ ||
+            std::chrono::steady_clock::now() >= deadline) {
+          break;
+        }
+        {
+          // enqueueFrame_ notifies while this is set, under the mutex, so
+          // a frame queued before the wait starts is not missed.
+          std::unique_lock<std::mutex> lock(writer_mtx_);
+          writer_lingering_.store(true);
+          writer_cv_.wait_until(lock, deadline, [this] {
+            return send_queue_size_.load() != 0;
+          });
+          writer_lingering_.store(false);
+        }
+        queued = send_queue_size_.load(std::memory_order_acquire);
+      }
+      sendBatch_(batch, buffers);
+    }
+  }
+
+  auto sendBatch_(std::vector<std::unique_ptr<OutgoingFrame>>& batch,
+                  std::vector<std::span<const uint8_t>>& buffers) noexcept
+      -> void {
+    buffers.clear();
+    for (const auto& frame : batch) {
+      if (!frame->bytes.empty()) {
+        buffers.emplace_back(frame->bytes);
+      }
+    }
+    if (!buffers.empty()) {
+      send_calls_.fetch_add(1, std::memory_order_relaxed);
+      packets_sent_.fetch_add(buffers.size(), std::memory_order_relaxed);
+      std::expected<std::monostate, std::error_code> res =
+          std::unexpected{std::make_error_code(std::errc::not_connected)};
+      if (tcp_backend_) {
+        res = tcp_backend_->sendAllv(buffers);
+      }
+      if (!res.has_value()) {
+        spw_rmap::debug::debug("Writer thread failed to send: ",
+                               res.error().message());
+        for (const auto& frame : batch) {
+          if (frame->transaction_id.has_value()) {
+            failTransaction_(*frame->transaction_id, res.error());
+          }
+        }
+      }
+    }
+    recycleFrames_(batch);
+  }
+
+  /**
+   * @brief Complete a pending transaction with `ec`, if it still is pending.
+   */
+  auto failTransaction_(uint16_t transaction_id, std::error_code ec) noexcept
+      -> void {
+    if (transaction_id < transaction_id_min_ ||
+        transaction_id >= transaction_id_max_) {
+      return;
+    }
+    auto& slot = transaction_slots_[transaction_id - transaction_id_min_];
+    if (slot.claim()) {
+      finishClaimed_(transaction_id, std::unexpected{ec});
+    }
+  }
+
+  /**
+   * @brief Make `send_buf_` hold at least `size` bytes, growing it unless the
+   *        buffer policy is fixed. Caller holds `send_buf_mtx_`.
+   */
+  auto reserveSendBuffer_(std::size_t size) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (send_buf_.size() >= size) {
+      return {};
+    }
+    if (buffer_policy_ == BufferPolicy::Fixed) {
+      return std::unexpected{std::make_error_code(std::errc::no_buffer_space)};
+    }
+    send_buf_.resize(size);
+    return {};
+  }
+
+  auto sendReadPacket_(std::shared_ptr<TargetNodeBase> target_node,
+                       uint16_t transaction_id, uint32_t memory_address,
+                       uint32_t data_length) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (!tcp_backend_) {
+      spw_rmap::debug::debug("Not connected");
+      return std::unexpected{std::make_error_code(std::errc::not_connected)};
+    }
+    if (const auto& header = target_node->getCommandHeader();
+        header.isValid()) {
+      const auto path = target_node->getTargetSpaceWireAddress();
+      return sendFrame_(
+          path.size() + header.size(),
+          [&](std::span<uint8_t> out) noexcept
+              -> std::expected<std::monostate, std::error_code> {
+            std::ranges::copy(path, out.begin());
+            header.writeTo(out.subspan(path.size()),
+                           CommandHeaderTemplate::Kind::Read,
+                           initiator_logical_address_, transaction_id, 0x00,
+                           memory_address, data_length);
+            return {};
+          },
+          std::nullopt, transaction_id);
+    }
+    auto config = ReadPacketConfig{
         .targetSpaceWireAddress = target_node->getTargetSpaceWireAddress(),
         .replyAddress = target_node->getReplyAddress(),
         .targetLogicalAddress = target_node->getTargetLogicalAddress(),
@@ -555,24 +1646,37 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
         .address = memory_address,
         .dataLength = data_length,
     };
+    return sendFrame_(
+        InlineReadPacketBuilder::getTotalSize(config),
+        [&config](std::span<uint8_t> out) noexcept
+            -> std::expected<std::monostate, std::error_code> {
+          auto res = InlineReadPacketBuilder::build(config, out);
+          if (!res.has_value()) {
+            spw_rmap::debug::debug("Failed to build Read Packet: ",
+                                   res.error().message());
+            return std::unexpected{res.error()};
+          }
+          return {};
+        },
+        std::nullopt, transaction_id);
+  }
 
-    auto res = read_packet_builder_.build(config, send_buffer.subspan(12));
-    if (!res.has_value()) {
-      spw_rmap::debug::debug("Failed to build Read Packet: ",
-                             res.error().message());
-      return std::unexpected{res.error()};
-    }
-    if (send_buffer.size() < read_packet_builder_.getTotalSize(config) + 12) {
-      if (buffer_policy_ == BufferPolicy::Fixed) {
-        spw_rmap::debug::debug("Send buffer too small for Read Packet");
-        return std::unexpected{
-            std::make_error_code(std::errc::no_buffer_space)};
-      } else {
-        send_buf_.resize(read_packet_builder_.getTotalSize(config) + 12);
-        send_buffer = std::span(send_buf_);
-      }
+  template <size_t Size>
+  auto sendReadCommand_(const StaticReadCommand<Size>& command,
+                        uint16_t transaction_id) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (!tcp_backend_) {
+      spw_rmap::debug::debug("Not connected");
+      return std::unexpected{std::make_error_code(std::errc::not_connected)};
     }
-    return send_(read_packet_builder_.getTotalSize(config));
+    return sendFrame_(
+        Size,
+        [&](std::span<uint8_t> out) noexcept
+            -> std::expected<std::monostate, std::error_code> {
+          command.writeTo(out, transaction_id);
+          return {};
+        },
+        std::nullopt, transaction_id);
   }
 
   auto sendWritePacket_(std::shared_ptr<TargetNodeBase> target_node,
@@ -583,101 +1687,431 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
       spw_rmap::debug::debug("Not connected");
       return std::unexpected{std::make_error_code(std::errc::not_connected)};
     }
-    auto expected_length = target_node->getTargetSpaceWireAddress().size() +
-                           (target_node->getReplyAddress().size() + 3) / 4 * 4 +
-                           4 + 12 + 1 + data.size();
-    std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
-    auto send_buffer = std::span(send_buf_);
-    if (expected_length + 12 > send_buffer.size()) {
-      if (buffer_policy_ == BufferPolicy::Fixed) {
-        spw_rmap::debug::debug("Send buffer too small for Write Packet");
-        return std::unexpected{
-            std::make_error_code(std::errc::no_buffer_space)};
-      } else {
-        send_buf_.resize(expected_length + 12);
-        send_buffer = std::span(send_buf_);
-      }
+    // Targets that did not precompute a header get one built here.
+    const auto& cached = target_node->getCommandHeader();
+    const auto header =
+        cached.isValid()
+            ? cached
+            : CommandHeaderTemplate(target_node->getTargetLogicalAddress(),
+                                    target_node->getReplyAddress());
+    if (!header.isValid()) {
+      spw_rmap::debug::debug("Reply address too long for Write Packet");
+      return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
     }
+    const auto path = target_node->getTargetSpaceWireAddress();
+    return sendFrame_(
+        path.size() + header.size(),
+        [&](std::span<uint8_t> out) noexcept
+            -> std::expected<std::monostate, std::error_code> {
+          std::ranges::copy(path, out.begin());
+          header.writeTo(
+              out.subspan(path.size()),
+              isVerifyMode() ? CommandHeaderTemplate::Kind::WriteVerify
+                             : CommandHeaderTemplate::Kind::Write,
+              initiator_logical_address_, transaction_id, 0x00,
+              memory_address, static_cast<uint32_t>(data.size()));
+          return {};
+        },
+        data, transaction_id);
+  }
 
-    auto config = WritePacketConfig{
-        .targetSpaceWireAddress = target_node->getTargetSpaceWireAddress(),
-        .replyAddress = target_node->getReplyAddress(),
-        .targetLogicalAddress = target_node->getTargetLogicalAddress(),
-        .initiatorLogicalAddress = initiator_logical_address_,
-        .transactionID = transaction_id,
-        .extendedAddress = 0x00,
-        .address = memory_address,
-        .verifyMode = isVerifyMode(),
-        .data = data,
-    };
-
-    auto res = write_packet_builder_.build(config, send_buffer.subspan(12));
-    if (!res.has_value()) {
-      spw_rmap::debug::debug("Failed to build Write Packet: ",
-                             res.error().message());
-      return std::unexpected{res.error()};
-    }
-    return send_(write_packet_builder_.getTotalSize(config));
+  static auto transactionIdCount_(const SpwRmapTCPNodeConfig& config) noexcept
+      -> std::size_t {
+    const auto max = std::min<uint32_t>(config.transaction_id_max, 0x10000);
+    return max > config.transaction_id_min ? max - config.transaction_id_min
+                                           : 0;
   }
 
   auto getAvailableTransactionID_() noexcept
       -> std::expected<uint32_t, std::error_code> {
-    const auto total_ids = transaction_id_max_ - transaction_id_min_;
-    while (true) {
-      std::optional<std::size_t> expired_index{};
-      {
-        std::lock_guard<std::mutex> lock(transaction_ids_mtx_);
-        const auto now = std::chrono::steady_clock::now();
-        for (std::size_t i = 0; i < total_ids; ++i) {
-          if (available_transaction_ids_[i]) {
-            available_transaction_ids_[i] = false;
-            transaction_last_used_[i] = now;
-            return transaction_id_min_ + static_cast<uint32_t>(i);
-          }
-          if (!expired_index.has_value() && !available_transaction_ids_[i]) {
-            const auto elapsed = now - transaction_last_used_[i];
-            if (elapsed > transaction_timeout_) {
-              expired_index = i;
+    const auto index = transaction_ids_.acquire();
+    if (!index.has_value()) {
+      return std::unexpected{
+          std::make_error_code(std::errc::resource_unavailable_try_again)};
+    }
+    return transaction_id_min_ + static_cast<uint32_t>(*index);
+  }
+
+  /**
+   * @brief Publish the just allocated `transaction_id` with `on_complete`
+   *        and a deadline `timeout` from now, after which it fails with
+   *        `timed_out`.
+   * @return The armed slot state, for `completeTransaction_`.
+   */
+  auto armTransaction_(uint16_t transaction_id, TransactionCallback on_complete,
+                       std::chrono::steady_clock::duration timeout,
+                       SlotContext context) noexcept -> uint32_t {
+    context.armed_at = std::chrono::steady_clock::now();
+    const auto tick = deadlineTick_(context.armed_at, timeout);
+    uint32_t armed = 0;
+    bool wake = false;
+    {
+      std::lock_guard<std::mutex> lock(timer_mtx_);
+      wake = tick < timer_wake_tick_;
+      armed = armLocked_(transaction_id - transaction_id_min_,
+                         std::move(on_complete), tick, context);
+    }
+    if (wake) {
+      timer_cv_.notify_one();
+    }
+    return armed;
+  }
+
+  /**
+   * @brief Timer tick at which a deadline `timeout` after `now` expires.
+   *        Starts the timer thread on first use.
+   */
+  auto deadlineTick_(std::chrono::steady_clock::time_point now,
+                     std::chrono::steady_clock::duration timeout) noexcept
+      -> uint64_t {
+    std::call_once(timer_started_, [this] {
+      timer_thread_ = std::thread([this]() noexcept { timerLoop_(); });
+    });
+    const auto deadline = now + timeout;
+    // Round up, so the timer never fires before the deadline.
+    return static_cast<uint64_t>((deadline - timer_epoch_ +
+                                  timeout_resolution_ -
+                                  std::chrono::steady_clock::duration{1}) /
+                                 timeout_resolution_);
+  }
+
+  /**
+   * @brief Arm slot `index` and schedule its timer for `tick`. Caller holds
+   *        `timer_mtx_` and wakes the timer thread if `tick` is earlier
+   *        than `timer_wake_tick_` was.
+   *
+   * Completion does not take the timer lock: releasing the slot advances
+   * its generation and leaves the timer in the wheel. Such a stale timer
+   * is dropped when it expires, as the slot is no longer armed or its
+   * claim is for an old generation, or replaced here when the ID is armed
+   * again first.
+   */
+  auto armLocked_(uint32_t index, TransactionCallback on_complete,
+                  uint64_t tick, const SlotContext& context) noexcept
+      -> uint32_t {
+    slot_contexts_[index] = context;
+    slot_contexts_[index].deadline_tick = tick;
+    const auto armed = transaction_slots_[index].arm(std::move(on_complete));
+    timer_wheel_.schedule(index, tick);
+    timer_wake_tick_ = std::min(timer_wake_tick_, tick);
+    return armed;
+  }
+
+  auto timerLoop_() noexcept -> void {
+    std::unique_lock<std::mutex> lock(timer_mtx_);
+    while (!timer_stop_) {
+      const auto next = timer_wheel_.nextTick();
+      timer_wake_tick_ = next.value_or(std::numeric_limits<uint64_t>::max());
+      if (next.has_value()) {
+        const auto ticks = static_cast<std::chrono::steady_clock::rep>(*next);
+        timer_cv_.wait_until(lock, timer_epoch_ + ticks * timeout_resolution_);
+      } else {
+        timer_cv_.wait(lock);
+      }
+      // Deadlines armed from here on are picked up by the next round.
+      timer_wake_tick_ = 0;
+      const auto now = std::chrono::steady_clock::now();
+      timer_wheel_.advance(
+          static_cast<uint64_t>((now - timer_epoch_) / timeout_resolution_),
+          [this](uint32_t index) {
+            const auto word =
+                transaction_slots_[index].state.load(std::memory_order_relaxed);
+            const auto phase = TransactionSlot::phase(word);
+            if (phase == TransactionSlot::kArmed ||
+                phase == TransactionSlot::kReceiving) {
+              timer_expired_.emplace_back(index, word);
             }
-          }
-        }
-        if (!expired_index.has_value()) {
-          return std::unexpected{
-              std::make_error_code(std::errc::resource_unavailable_try_again)};
+          });
+      if (timer_expired_.empty()) {
+        continue;
+      }
+      lock.unlock();
+      timer_sweep_.fetch_add(1, std::memory_order_relaxed);
+      for (const auto& [index, armed] : timer_expired_) {
+        if (transaction_slots_[index].claim(armed)) {
+          expireClaimed_(index);
         }
       }
-      forceReleaseTransaction_(*expired_index);
+      timer_expired_.clear();
+      lock.lock();
+    }
+  }
+
+  /**
+   * @brief Fail the claimed transaction of slot `index` with `timed_out`.
+   */
+  auto expireClaimed_(uint32_t index) noexcept -> void {
+    // Back off before a retry started on completion reads the timeout.
+    if (target_rtts_) {
+      auto& target = target_rtts_[slot_contexts_[index].target_logical_address];
+      const auto sweep = timer_sweep_.load(std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lock(target.mtx);
+      if (target.backoff_sweep != sweep) {
+        target.backoff_sweep = sweep;
+        target.estimator.backoff(max_adaptive_timeout_);
+      }
     }
+    finishClaimed_(static_cast<uint16_t>(transaction_id_min_ + index),
+                   std::unexpected{std::make_error_code(std::errc::timed_out)});
   }
 
+  /**
+   * @brief The current timer tick, comparable with a deadline tick.
+   */
+  auto timerTick_() const noexcept -> uint64_t {
+    return static_cast<uint64_t>(
+        (std::chrono::steady_clock::now() - timer_epoch_) /
+        timeout_resolution_);
+  }
+
+  /**
+   * @brief Deadline for a new transaction to `target_logical_address`:
+   *        `timeout`, or with adaptive timeouts the target's estimate once
+   *        it has one.
+   */
+  auto timeoutFor_(uint8_t target_logical_address,
+                   std::chrono::steady_clock::duration timeout) const noexcept
+      -> std::chrono::steady_clock::duration {
+    if (!target_rtts_) {
+      return timeout;
+    }
+    auto& target = target_rtts_[target_logical_address];
+    std::lock_guard<std::mutex> lock(target.mtx);
+    const auto estimate = target.estimator.timeout();
+    return estimate > std::chrono::steady_clock::duration::zero() ? estimate
+                                                                  : timeout;
+  }
+
+  /**
+   * @brief Feed the round-trip time of the claimed `transaction_id`, which
+   *        was just answered, to its target's estimator.
+   */
+  auto sampleRtt_(uint16_t transaction_id) noexcept -> void {
+    if (!target_rtts_) {
+      return;
+    }
+    const auto& context = slot_contexts_[transaction_id - transaction_id_min_];
+    const auto rtt = std::chrono::steady_clock::now() - context.armed_at;
+    auto& target = target_rtts_[context.target_logical_address];
+    std::lock_guard<std::mutex> lock(target.mtx);
+    target.estimator.sample(
+        rtt, timeout_resolution_, min_adaptive_timeout_,
+        max_adaptive_timeout_);
+  }
+
+  /**
+   * @brief Return a claimed `transaction_id` to the free pool.
+   */
   auto releaseTransactionID_(uint16_t transaction_id) noexcept -> void {
     if (transaction_id < transaction_id_min_ ||
         transaction_id >= transaction_id_max_) {
       assert(false && "Transaction ID out of range");
       return;
     }
-    std::lock_guard<std::mutex> lock(transaction_ids_mtx_);
     const auto index = transaction_id - transaction_id_min_;
-    available_transaction_ids_[index] = true;
-    transaction_last_used_[index] =
-        std::chrono::steady_clock::time_point::min();
+    // The timer stays in the wheel; see `armLocked_`.
+    transaction_slots_[index].release();
+    transaction_ids_.release(index);
   }
 
-  auto forceReleaseTransaction_(std::size_t index) noexcept -> void {
-    std::function<void(std::error_code)> error_handler = nullptr;
+  /**
+   * @brief Answer a Read, RMW or Write command. With `job`, the reply is
+   *        built into it instead of being sent. Handler threads serve
+   *        concurrently, so only the loop thread sends from a view.
+   */
+  auto serve_(const Packet& packet, HandlerJob* job) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return serveCommand(
+        handlers_, packet, /*allow_view=*/job == nullptr,
+        [this, job](std::size_t size, auto&& fill,
+                    std::optional<std::span<const uint8_t>> payload) {
+          return sendReply_(size, std::forward<decltype(fill)>(fill), payload,
+                            job);
+        });
+  }
+
+  /**
+   * @brief Copy `packet` into the next handler job and wake a handler
+   *        thread for it; waits while every job is still in use. The job
+   *        runs `on_complete` with the packet if set, and serves it
+   *        otherwise.
+   */
+  auto dispatch_(const Packet& packet, TransactionCallback on_complete) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    std::unique_lock<std::mutex> lock(handler_mtx_);
+    handler_free_cv_.wait(lock, [this] {
+      return handler_dispatched_ - handler_committed_ < handler_jobs_.size();
+    });
+    const auto sequence = handler_dispatched_;
+    lock.unlock();
+
+    // Only this thread touches a job between its commit and its dispatch.
+    auto& job = handler_jobs_[sequence % handler_jobs_.size()];
+    if (auto res = copyPacket_(packet, job); !res.has_value()) {
+      if (on_complete) {
+        on_complete(std::unexpected{res.error()});
+      }
+      return std::unexpected{res.error()};
+    }
+    job.on_complete = std::move(on_complete);
+    lock.lock();
+    ++handler_dispatched_;
+    lock.unlock();
+    handler_work_cv_.notify_one();
+    return {};
+  }
+
+  /**
+   * @brief Copy the bytes of `packet` still in `recv_buf_` into
+   *        `job.bytes`, and point the copy's spans at them. Data already
+   *        copied into a reply sink stays where it is.
+   */
+  auto copyPacket_(const Packet& packet, HandlerJob& job) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    const auto buffer = std::span<const uint8_t>(recv_buf_);
+    const auto offsetOf =
+        [&buffer](std::span<const uint8_t> field) -> std::optional<size_t> {
+      const std::less<const uint8_t*> before{};
+      if (field.empty() || before(field.data(), buffer.data()) ||
+          before(buffer.data() + buffer.size(), field.data() + field.size())) {
+        return std::nullopt;
+      }
+      return static_cast<size_t>(field.data() - buffer.data());
+    };
+    std::array<std::span<const uint8_t>*, 3> fields = {
+        &job.packet.targetSpaceWireAddress, &job.packet.replyAddress,
+        &job.packet.data};
+    job.packet = packet;
+    size_t used = 0;
+    for (const auto* field : fields) {
+      if (const auto offset = offsetOf(*field); offset.has_value()) {
+        used = std::max(used, *offset + field->size());
+      }
+    }
+    try {
+      job.bytes.assign(buffer.begin(),
+                       buffer.begin() + static_cast<std::ptrdiff_t>(used));
+    } catch (const std::bad_alloc&) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    for (auto* field : fields) {
+      if (const auto offset = offsetOf(*field); offset.has_value()) {
+        *field = std::span<const uint8_t>(job.bytes).subspan(*offset,
+                                                             field->size());
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @brief Body of a handler thread: serve jobs in the order they were
+   *        dispatched until the node is destroyed and none are left.
+   */
+  auto handlerLoop_() noexcept -> void {
+    for (;;) {
+      std::unique_lock<std::mutex> lock(handler_mtx_);
+      handler_work_cv_.wait(lock, [this] {
+        return handler_stop_ || handler_taken_ < handler_dispatched_;
+      });
+      if (handler_taken_ == handler_dispatched_) {
+        return;
+      }
+      const auto sequence = handler_taken_++;
+      lock.unlock();
+
+      auto& job = handler_jobs_[sequence % handler_jobs_.size()];
+      if (job.on_complete) {
+        auto on_complete = std::move(job.on_complete);
+        on_complete(&job.packet);
+      } else if (auto res = serve_(job.packet, &job); !res.has_value()) {
+        failHandlers_(res.error());
+      }
+      commitReplies_(sequence);
+    }
+  }
+
+  /**
+   * @brief Mark job `sequence` done, then send the replies of the done
+   *        jobs no earlier job is still holding back, oldest first, and
+   *        hand their buffers back to `dispatch_`.
+   */
+  auto commitReplies_(uint64_t sequence) noexcept -> void {
+    std::unique_lock<std::mutex> order_lock(reply_order_mtx_);
+    handler_jobs_[sequence % handler_jobs_.size()].done = true;
+    const auto first = reply_next_;
+    for (;;) {
+      auto& job = handler_jobs_[reply_next_ % handler_jobs_.size()];
+      if (!job.done) {
+        break;
+      }
+      job.done = false;
+      if (!job.reply.empty()) {
+        if (auto res = sendBuilt_(job.reply); !res.has_value()) {
+          spw_rmap::debug::debug("Failed to send reply: ",
+                                 res.error().message());
+          failHandlers_(res.error());
+        }
+        job.reply.clear();
+      }
+      ++reply_next_;
+    }
+    if (reply_next_ == first) {
+      return;
+    }
+    const auto committed = reply_next_;
+    order_lock.unlock();
     {
-      std::lock_guard<std::mutex> lock(*reply_callback_mtx_[index]);
-      if (reply_error_callback_[index]) {
-        error_handler = std::move(reply_error_callback_[index]);
+      std::lock_guard<std::mutex> lock(handler_mtx_);
+      handler_committed_ = committed;
+    }
+    handler_free_cv_.notify_one();
+  }
+
+  /**
+   * @brief Send a frame built by `buildFrame_`, or queue a copy of it to
+   *        the writer thread in a pooled frame; `bytes` keeps its buffer.
+   */
+  auto sendBuilt_(const std::vector<uint8_t>& bytes) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (use_writer_thread_) {
+      auto frame = acquireFrame_();
+      try {
+        frame->bytes.assign(bytes.begin(), bytes.end());
+      } catch (const std::bad_alloc&) {
+        return std::unexpected{
+            std::make_error_code(std::errc::not_enough_memory)};
       }
-      reply_callback_[index] = nullptr;
-      reply_error_callback_[index] = nullptr;
+      enqueueFrame_(std::move(frame));
+      return {};
     }
-    if (error_handler) {
-      error_handler(std::make_error_code(std::errc::timed_out));
-    } else {
-      releaseTransactionID_(transaction_id_min_ + static_cast<uint16_t>(index));
+    std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
+    countSend_();
+    return tcp_backend_->sendAll(bytes);
+  }
+
+  /**
+   * @brief Keep the first error of a handler thread for `poll` to return.
+   */
+  auto failHandlers_(std::error_code ec) noexcept -> void {
+    std::lock_guard<std::mutex> lock(handler_mtx_);
+    if (!handler_error_) {
+      handler_error_ = ec;
+    }
+  }
+
+  /**
+   * @brief Run the completion of a claimed transaction with its reply, on a
+   *        handler thread if there are any. The ID is released first, see
+   *        `takeClaimed_`.
+   */
+  auto completeReply_(uint16_t transaction_id, const Packet& packet) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (handler_jobs_.empty()) {
+      finishClaimed_(transaction_id, &packet);
+      return {};
     }
+    return dispatch_(packet, takeClaimed_(transaction_id));
   }
 
  public:
@@ -686,8 +2120,36 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
 
   virtual auto isShutdowned() noexcept -> bool = 0;
 
+  /**
+   * @brief Receive one packet and handle it. With handler threads, it is
+   *        handed to them instead, and a failure of theirs is returned by
+   *        the next call.
+   */
   auto poll() noexcept -> std::expected<bool, std::error_code> override {
-    auto res = recvAndParseOnePacket_();
+    if (!handler_jobs_.empty()) {
+      std::lock_guard<std::mutex> lock(handler_mtx_);
+      if (handler_error_) {
+        return std::unexpected{std::exchange(handler_error_, {})};
+      }
+    }
+    std::expected<std::size_t, std::error_code> res = 0;
+    {
+      std::lock_guard<std::mutex> lock(recv_mtx_);
+      res = recvAndParseOnePacket_();
+    }
+    if (receiving_reply_.has_value() && (!res.has_value() || *res == 0)) {
+      // The reply's header was seen, but the rest did not make it.
+      const auto [transaction_id, receiving] =
+          *std::exchange(receiving_reply_, std::nullopt);
+      if (transaction_slots_[transaction_id - transaction_id_min_].claim(
+              receiving)) {
+        finishClaimed_(transaction_id,
+                       std::unexpected{res.has_value()
+                                           ? std::make_error_code(
+                                                 std::errc::connection_aborted)
+                                           : res.error()});
+      }
+    }
     if (!res.has_value()) {
       if (isShutdowned()) {
         return false;
@@ -718,124 +2180,32 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
               packet.transactionID);
           return std::unexpected{std::make_error_code(std::errc::bad_message)};
         }
-        const auto idx = packet.transactionID - transaction_id_min_;
-        std::lock_guard<std::mutex> lock(*reply_callback_mtx_[idx]);
-        if (reply_callback_[idx]) {
-          auto callback = std::move(reply_callback_[idx]);
-          reply_callback_[idx] = nullptr;
-          reply_error_callback_[idx] = nullptr;
-          callback(packet);
+        auto& slot =
+            transaction_slots_[packet.transactionID - transaction_id_min_];
+        const auto receiving = std::exchange(receiving_reply_, std::nullopt);
+        if (receiving.has_value() ? slot.claim(receiving->second)
+                                  : slot.claim()) {
+          sampleRtt_(packet.transactionID);
+          if (auto res = completeReply_(packet.transactionID, packet);
+              !res.has_value()) {
+            return std::unexpected{res.error()};
+          }
+        } else if (receiving.has_value()) {
+          spw_rmap::debug::debug("Read reply arrived past its deadline, TID: ",
+                                 packet.transactionID);
         } else {
           std::cerr << "No callback registered for Transaction ID: "
                     << packet.transactionID << "\n";
         }
         break;
       }
-      case PacketType::Read: {
-        std::vector<uint8_t> data{};
-        if (on_read_callback_) {
-          try {
-            data = on_read_callback_(packet);
-          } catch (const std::exception& e) {
-            spw_rmap::debug::debug("Exception in on_read_callback_: ",
-                                   e.what());
-            return std::unexpected{
-                std::make_error_code(std::errc::operation_canceled)};
-          }
-        }
-        if (data.size() != packet.dataLength) {
-          std::cerr << "on_read_callback_ returned data with incorrect length: "
-                    << data.size() << " (expected " << packet.dataLength
-                    << ")\n";
-        }
-        auto config = ReadReplyPacketConfig{
-            .replyAddress = packet.replyAddress,
-            .initiatorLogicalAddress = packet.targetLogicalAddress,
-            .status = static_cast<uint8_t>(
-                PacketStatusCode::CommandExecutedSuccessfully),
-            .targetLogicalAddress = packet.initiatorLogicalAddress,
-            .transactionID = packet.transactionID,
-            .data = data,
-            .incrementMode = true,
-        };
-        ReadReplyPacketBuilder builder;
-        std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
-        auto send_buffer = std::span(send_buf_);
-        if (buffer_policy_ == BufferPolicy::Fixed) {
-          if (builder.getTotalSize(config) + 12 > send_buffer.size()) {
-            spw_rmap::debug::debug(
-                "Send buffer too small for Read Reply Packet");
-            return std::unexpected{
-                std::make_error_code(std::errc::no_buffer_space)};
-          }
-        } else {
-          if (builder.getTotalSize(config) + 12 > send_buffer.size()) {
-            send_buf_.resize(builder.getTotalSize(config) + 12);
-            send_buffer = std::span(send_buf_);
-          }
-        }
-        auto build_res = builder.build(config, send_buffer.subspan(12));
-        if (!build_res.has_value()) {
-          spw_rmap::debug::debug("Failed to build Read Reply Packet: ",
-                                 build_res.error().message());
-          return std::unexpected{build_res.error()};
-        }
-        auto send_res = send_(builder.getTotalSize(config));
-        if (!send_res.has_value()) {
-          spw_rmap::debug::debug("Failed to send Read Reply Packet: ",
-                                 send_res.error().message());
-          return std::unexpected{send_res.error()};
-        }
-        break;
-      }
+      case PacketType::Read:
+      case PacketType::ReadModifyWrite:
       case PacketType::Write: {
-        if (on_write_callback_) {
-          try {
-            on_write_callback_(packet);
-          } catch (const std::exception& e) {
-            spw_rmap::debug::debug("Exception in on_write_callback_: ",
-                                   e.what());
-            return std::unexpected{
-                std::make_error_code(std::errc::operation_canceled)};
-          }
-        }
-        auto config = WriteReplyPacketConfig{
-            .replyAddress = packet.replyAddress,
-            .initiatorLogicalAddress = packet.targetLogicalAddress,
-            .status = static_cast<uint8_t>(
-                PacketStatusCode::CommandExecutedSuccessfully),
-            .targetLogicalAddress = packet.initiatorLogicalAddress,
-            .transactionID = packet.transactionID,
-            .incrementMode = true,
-            .verifyMode = true,
-        };
-        WriteReplyPacketBuilder builder;
-        std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
-        auto send_buffer = std::span(send_buf_);
-        if (buffer_policy_ == BufferPolicy::Fixed) {
-          if (builder.getTotalSize(config) + 12 > send_buffer.size()) {
-            spw_rmap::debug::debug(
-                "Send buffer too small for Write Reply Packet");
-            return std::unexpected{
-                std::make_error_code(std::errc::no_buffer_space)};
-          }
-        } else {
-          if (builder.getTotalSize(config) + 12 > send_buffer.size()) {
-            send_buf_.resize(builder.getTotalSize(config) + 12);
-            send_buffer = std::span(send_buf_);
-          }
-        }
-        auto build_res = builder.build(config, send_buffer.subspan(12));
-        if (!build_res.has_value()) {
-          std::cerr << "Failed to build Write Reply Packet: "
-                    << build_res.error().message() << "\n";
-          return std::unexpected{build_res.error()};
-        }
-        auto send_res = send_(builder.getTotalSize(config));
-        if (!send_res.has_value()) {
-          spw_rmap::debug::debug("Failed to send Write Reply Packet: ",
-                                 send_res.error().message());
-          return std::unexpected{send_res.error()};
+        auto res = handler_jobs_.empty() ? serve_(packet, nullptr)
+                                         : dispatch_(packet, nullptr);
+        if (!res.has_value()) {
+          return std::unexpected{res.error()};
         }
         break;
       }
@@ -863,52 +2233,96 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
 
   auto registerOnWrite(std::function<void(Packet)> onWrite) noexcept
       -> void override {
-    on_write_callback_ = std::move(onWrite);
+    handlers_.on_write = std::move(onWrite);
   }
 
   auto registerOnRead(
       std::function<std::vector<uint8_t>(Packet)> onRead) noexcept
       -> void override {
-    on_read_callback_ = std::move(onRead);
+    handlers_.on_read = std::move(onRead);
+  }
+
+  auto registerOnReadInto(
+      std::function<PacketStatusCode(Packet, std::span<uint8_t>)>
+          onRead) noexcept -> void override {
+    handlers_.on_read_into = std::move(onRead);
+  }
+
+  auto registerTarget(std::shared_ptr<RmapTarget> target) noexcept
+      -> void override {
+    handlers_.target = std::move(target);
   }
 
+  /**
+   * @brief Deadline of asynchronous transactions started from now on; they
+   *        fail with `timed_out` when it passes without a reply.
+   */
   auto setTimeout(std::chrono::milliseconds timeout) noexcept -> void {
     transaction_timeout_ = timeout;
   }
 
+  /**
+   * @brief As above, for deadlines finer than a millisecond; `timeout` is
+   *        rounded up to whole microseconds.
+   */
+  template <class Rep, class Period>
+  auto setTimeout(std::chrono::duration<Rep, Period> timeout) noexcept
+      -> void {
+    transaction_timeout_ =
+        std::chrono::ceil<std::chrono::microseconds>(timeout);
+  }
+
   auto write(std::shared_ptr<TargetNodeBase> target_node,
              uint32_t memory_address, const std::span<const uint8_t> data,
              std::chrono::milliseconds timeout = std::chrono::milliseconds{100},
              std::size_t retry_count = 3) noexcept
       -> std::expected<std::monostate, std::error_code> override {
-    retry_count = retry_count == 0 ? 1 : retry_count;
-    std::error_code last_error = std::make_error_code(std::errc::timed_out);
-    for (std::size_t attempt = 0; attempt < retry_count; ++attempt) {
-      auto async_op =
-          startWriteAsyncOperation_(target_node, memory_address, data,
-                                    [](const Packet&) noexcept -> void {});
-      if (async_op.future.wait_for(timeout) == std::future_status::ready) {
-        auto res = async_op.future.get();
-        if (!res.has_value()) {
-          return std::unexpected{res.error()};
-        }
-        return {};
-      }
-      if (async_op.transaction_id.has_value()) {
-        cancelTransaction_(*async_op.transaction_id);
-      }
-      last_error = std::make_error_code(std::errc::timed_out);
-    }
-    return std::unexpected{last_error};
+    return retry_(retry_count, [&](TransactionCompletion& completion) {
+      startTransaction_(
+          target_node->getTargetLogicalAddress(),
+          [&](uint16_t transaction_id) noexcept {
+            return sendWritePacket_(target_node, transaction_id,
+                                    memory_address, data);
+          },
+          makeWriteCallback_(&completion), timeout);
+    });
   }
 
   auto writeAsync(std::shared_ptr<TargetNodeBase> target_node,
                   uint32_t memory_address, const std::span<const uint8_t> data,
                   std::function<void(Packet)> on_complete) noexcept
       -> std::future<std::expected<std::monostate, std::error_code>> override {
-    auto async_op = startWriteAsyncOperation_(
-        std::move(target_node), memory_address, data, std::move(on_complete));
-    return std::move(async_op.future);
+    auto state = std::make_unique<FutureCompletion>();
+    state->on_complete = std::move(on_complete);
+    auto future = state->promise.get_future();
+    startTransaction_(
+        target_node->getTargetLogicalAddress(),
+        [&](uint16_t transaction_id) noexcept {
+          return sendWritePacket_(std::move(target_node), transaction_id,
+                                  memory_address, data);
+        },
+        makeFutureCallback_(std::move(state)), transaction_timeout_);
+    return future;
+  }
+
+  /**
+   * @brief Start a write that signals `completion` when done; does not
+   *        allocate.
+   *
+   * `completion` must stay alive until it is ready. Failures to start the
+   * transaction are reported through it as well.
+   */
+  auto writeAsync(std::shared_ptr<TargetNodeBase> target_node,
+                  uint32_t memory_address, const std::span<const uint8_t> data,
+                  TransactionCompletion& completion) noexcept -> void {
+    completion.reset();
+    startTransaction_(
+        target_node->getTargetLogicalAddress(),
+        [&](uint16_t transaction_id) noexcept {
+          return sendWritePacket_(std::move(target_node), transaction_id,
+                                  memory_address, data);
+        },
+        makeWriteCallback_(&completion), transaction_timeout_);
   }
 
   auto read(std::shared_ptr<TargetNodeBase> target_node,
@@ -916,37 +2330,385 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
             std::chrono::milliseconds timeout = std::chrono::milliseconds{100},
             std::size_t retry_count = 3) noexcept
       -> std::expected<std::monostate, std::error_code> override {
-    retry_count = retry_count == 0 ? 1 : retry_count;
-    std::error_code last_error = std::make_error_code(std::errc::timed_out);
-    for (std::size_t attempt = 0; attempt < retry_count; ++attempt) {
-      auto async_op = startReadAsyncOperation_(
-          target_node, memory_address, data.size(),
-          [data](const Packet& packet) noexcept -> void {
-            std::copy_n(packet.data.data(), data.size(), data.data());
-          });
-      if (async_op.future.wait_for(timeout) == std::future_status::ready) {
-        auto res = async_op.future.get();
-        if (!res.has_value()) {
-          return std::unexpected{res.error()};
-        }
-        return {};
-      }
-      if (async_op.transaction_id.has_value()) {
-        cancelTransaction_(*async_op.transaction_id);
-      }
-      last_error = std::make_error_code(std::errc::timed_out);
-    }
-    return std::unexpected{last_error};
+    return retry_(retry_count, [&](TransactionCompletion& completion) {
+      startTransaction_(
+          target_node->getTargetLogicalAddress(),
+          [&](uint16_t transaction_id) noexcept {
+            return sendReadPacket_(target_node, transaction_id, memory_address,
+                                   data.size());
+          },
+          makeReadCallback_(&completion, data), timeout, data);
+    });
   }
 
   auto readAsync(std::shared_ptr<TargetNodeBase> target_node,
                  uint32_t memory_address, uint32_t data_length,
                  std::function<void(Packet)> on_complete) noexcept
       -> std::future<std::expected<std::monostate, std::error_code>> override {
-    auto async_op =
-        startReadAsyncOperation_(std::move(target_node), memory_address,
-                                 data_length, std::move(on_complete));
-    return std::move(async_op.future);
+    auto state = std::make_unique<FutureCompletion>();
+    state->on_complete = std::move(on_complete);
+    auto future = state->promise.get_future();
+    startTransaction_(
+        target_node->getTargetLogicalAddress(),
+        [&](uint16_t transaction_id) noexcept {
+          return sendReadPacket_(std::move(target_node), transaction_id,
+                                 memory_address, data_length);
+        },
+        makeFutureCallback_(std::move(state)), transaction_timeout_);
+    return future;
+  }
+
+  /**
+   * @brief Start a read of `data.size()` bytes into `data` that signals
+   *        `completion` when done; does not allocate.
+   *
+   * `data` and `completion` must stay alive until `completion` is ready. A
+   * reply of the wrong length completes it with `bad_message`.
+   */
+  auto readAsync(std::shared_ptr<TargetNodeBase> target_node,
+                 uint32_t memory_address, const std::span<uint8_t> data,
+                 TransactionCompletion& completion) noexcept -> void {
+    completion.reset();
+    startTransaction_(
+        target_node->getTargetLogicalAddress(),
+        [&](uint16_t transaction_id) noexcept {
+          return sendReadPacket_(std::move(target_node), transaction_id,
+                                 memory_address, data.size());
+        },
+        makeReadCallback_(&completion, data), transaction_timeout_, data);
+  }
+
+  /**
+   * @brief Read using a prebuilt command from `makeReadCommand`.
+   *
+   * Only the transaction ID is filled in per call. The command's initiator
+   * logical address is used as is. `data.size()` must equal the command's
+   * data length.
+   */
+  template <size_t Size>
+  auto read(const StaticReadCommand<Size>& command,
+            const std::span<uint8_t> data,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds{100},
+            std::size_t retry_count = 3) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    if (data.size() != command.getDataLength()) {
+      spw_rmap::debug::debug("Read buffer does not match command length");
+      return std::unexpected{
+          std::make_error_code(std::errc::invalid_argument)};
+    }
+    return retry_(retry_count, [&](TransactionCompletion& completion) {
+      startTransaction_(
+          command.getTargetLogicalAddress(),
+          [&](uint16_t transaction_id) noexcept {
+            return sendReadCommand_(command, transaction_id);
+          },
+          makeReadCallback_(&completion, data), timeout, data);
+    });
+  }
+
+  template <size_t Size>
+  auto readAsync(const StaticReadCommand<Size>& command,
+                 std::function<void(Packet)> on_complete) noexcept
+      -> std::future<std::expected<std::monostate, std::error_code>> {
+    auto state = std::make_unique<FutureCompletion>();
+    state->on_complete = std::move(on_complete);
+    auto future = state->promise.get_future();
+    startTransaction_(
+        command.getTargetLogicalAddress(),
+        [&](uint16_t transaction_id) noexcept {
+          return sendReadCommand_(command, transaction_id);
+        },
+        makeFutureCallback_(std::move(state)), transaction_timeout_);
+    return future;
+  }
+
+  /**
+   * @class TransactionAwaiter
+   * @brief Awaitable returned by `readAwait` / `writeAwait`.
+   *
+   * The transaction starts when the awaiting coroutine suspends and the
+   * coroutine is resumed from the thread that completes it: normally the
+   * one running `poll()`, or the timer thread on a timeout. All state lives
+   * in the awaiter, i.e. in the coroutine frame; nothing is allocated. The
+   * result is the same as that of `write` / `read`, without retries.
+   */
+  class TransactionAwaiter {
+   private:
+    static constexpr uint8_t kPending = 0;
+    static constexpr uint8_t kSuspended = 1;
+    static constexpr uint8_t kDone = 2;
+
+    SpwRmapTCPNodeImpl* node_;
+    std::shared_ptr<TargetNodeBase> target_node_;
+    uint32_t memory_address_;
+    std::span<const uint8_t> write_data_;
+    std::span<uint8_t> read_data_;
+    bool is_read_;
+    std::coroutine_handle<> handle_{};
+    std::atomic<uint8_t> state_{kPending};
+    std::expected<std::monostate, std::error_code> result_{};
+
+   public:
+    TransactionAwaiter(SpwRmapTCPNodeImpl* node,
+                       std::shared_ptr<TargetNodeBase> target_node,
+                       uint32_t memory_address,
+                       std::span<const uint8_t> write_data,
+                       std::span<uint8_t> read_data, bool is_read) noexcept
+        : node_(node),
+          target_node_(std::move(target_node)),
+          memory_address_(memory_address),
+          write_data_(write_data),
+          read_data_(read_data),
+          is_read_(is_read) {}
+
+    TransactionAwaiter(const TransactionAwaiter&) = delete;
+    auto operator=(const TransactionAwaiter&) -> TransactionAwaiter& = delete;
+    TransactionAwaiter(TransactionAwaiter&&) = delete;
+    auto operator=(TransactionAwaiter&&) -> TransactionAwaiter& = delete;
+
+    ~TransactionAwaiter() = default;
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    /**
+     * @brief Start the transaction; stays suspended unless it already
+     *        finished, e.g. because no transaction ID was free.
+     */
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool {
+      handle_ = handle;
+      TransactionCallback on_complete =
+          [this](TransactionResult result) noexcept { finish_(result); };
+      node_->startTransaction_(
+          target_node_->getTargetLogicalAddress(),
+          [this](uint16_t transaction_id) noexcept {
+            return is_read_ ? node_->sendReadPacket_(
+                                  target_node_, transaction_id,
+                                  memory_address_, read_data_.size())
+                            : node_->sendWritePacket_(
+                                  target_node_, transaction_id,
+                                  memory_address_, write_data_);
+          },
+          std::move(on_complete), node_->transaction_timeout_,
+          is_read_ ? read_data_ : std::span<uint8_t>{});
+      // Whoever comes second resumes: us by not suspending, or `finish_`.
+      return state_.exchange(kSuspended, std::memory_order_acq_rel) != kDone;
+    }
+
+    auto await_resume() noexcept
+        -> std::expected<std::monostate, std::error_code> {
+      return result_;
+    }
+
+   private:
+    auto finish_(TransactionResult result) noexcept -> void {
+      if (!result.has_value()) {
+        result_ = std::unexpected{result.error()};
+      } else if (is_read_ && (*result)->data.size() != read_data_.size()) {
+        result_ =
+            std::unexpected{std::make_error_code(std::errc::bad_message)};
+      } else if (is_read_ && (*result)->data.data() != read_data_.data()) {
+        std::ranges::copy((*result)->data, read_data_.begin());
+      }
+      if (state_.exchange(kDone, std::memory_order_acq_rel) == kSuspended) {
+        handle_.resume();
+      }
+    }
+  };
+
+  /**
+   * @brief `co_await`-able write; see `TransactionAwaiter`.
+   *
+   * `data` must stay valid until the awaiting coroutine resumes.
+   */
+  [[nodiscard]] auto writeAwait(std::shared_ptr<TargetNodeBase> target_node,
+                                uint32_t memory_address,
+                                std::span<const uint8_t> data) noexcept
+      -> TransactionAwaiter {
+    return {this, std::move(target_node), memory_address, data, {}, false};
+  }
+
+  /**
+   * @brief `co_await`-able read of `data.size()` bytes into `data`; see
+   *        `TransactionAwaiter`.
+   */
+  [[nodiscard]] auto readAwait(std::shared_ptr<TargetNodeBase> target_node,
+                               uint32_t memory_address,
+                               std::span<uint8_t> data) noexcept
+      -> TransactionAwaiter {
+    return {this, std::move(target_node), memory_address, {}, data, true};
+  }
+
+  /**
+   * @brief Start the transactions in `requests` and report how each one
+   *        ends to `queue` instead of to a callback or future per
+   *        transaction.
+   *
+   * Requests are accepted from the front while `queue` has room. ID
+   * allocation and timer arming take their lock once per 64 requests, and
+   * without a writer thread the send lock is held across them as well.
+   * Transactions that cannot be started complete with an error, e.g.
+   * `resource_unavailable_try_again` when no transaction ID is free. All
+   * get the deadline set with `setTimeout`, or their target's adaptive
+   * one.
+   * @return How many requests were accepted.
+   */
+  auto submit(CompletionQueue& queue,
+              std::span<const RmapRequest> requests) noexcept -> std::size_t {
+    constexpr std::size_t kChunk = 64;
+    const auto accepted = queue.reserve(requests.size());
+    std::array<std::size_t, kChunk> indices{};
+    std::array<uint32_t, kChunk> armed{};
+    std::array<uint64_t, kChunk> ticks{};
+    std::array<SlotContext, kChunk> contexts{};
+    for (std::size_t first = 0; first < accepted; first += kChunk) {
+      const auto chunk =
+          requests.subspan(first, std::min(kChunk, accepted - first));
+      const auto started =
+          transaction_ids_.acquire(std::span(indices).first(chunk.size()));
+      const auto now = std::chrono::steady_clock::now();
+      auto earliest = std::numeric_limits<uint64_t>::max();
+      for (std::size_t i = 0; i < started; ++i) {
+        const auto target = chunk[i].target_node->getTargetLogicalAddress();
+        ticks[i] =
+            deadlineTick_(now, timeoutFor_(target, transaction_timeout_));
+        earliest = std::min(earliest, ticks[i]);
+        contexts[i] = {
+            .reply_sink = chunk[i].operation == RmapOperation::Read
+                              ? chunk[i].read_data
+                              : std::span<uint8_t>{},
+            .armed_at = now,
+            .target_logical_address = target};
+      }
+      bool wake = false;
+      {
+        std::lock_guard<std::mutex> lock(timer_mtx_);
+        wake = earliest < timer_wake_tick_;
+        for (std::size_t i = 0; i < started; ++i) {
+          armed[i] = armLocked_(static_cast<uint32_t>(indices[i]),
+                                makeQueueCallback_(&queue, chunk[i]), ticks[i],
+                                contexts[i]);
+        }
+      }
+      if (wake) {
+        timer_cv_.notify_one();
+      }
+      {
+        std::unique_lock<std::recursive_mutex> send_lock(send_buf_mtx_,
+                                                         std::defer_lock);
+        if (!use_writer_thread_) {
+          send_lock.lock();
+        }
+        for (std::size_t i = 0; i < started; ++i) {
+          const auto transaction_id =
+              static_cast<uint16_t>(transaction_id_min_ + indices[i]);
+          const auto& request = chunk[i];
+          auto res = request.operation == RmapOperation::Read
+                         ? sendReadPacket_(
+                               request.target_node, transaction_id,
+                               request.memory_address,
+                               static_cast<uint32_t>(request.read_data.size()))
+                         : sendWritePacket_(request.target_node,
+                                            transaction_id,
+                                            request.memory_address,
+                                            request.write_data);
+          if (!res.has_value()) {
+            completeTransaction_(transaction_id, armed[i],
+                                 std::unexpected{res.error()});
+          }
+        }
+      }
+      for (std::size_t i = started; i < chunk.size(); ++i) {
+        queue.push({.user_data = chunk[i].user_data,
+                    .error = std::make_error_code(
+                        std::errc::resource_unavailable_try_again)});
+      }
+    }
+    return accepted;
+  }
+
+  static constexpr std::size_t kDefaultBulkChunkSize = 4096;
+  static constexpr std::size_t kDefaultBulkWindow = 32;
+
+  /**
+   * @brief Write `data` to `memory_address` onwards as `chunk_size`-byte
+   *        transactions, keeping up to `window` of them in flight.
+   *
+   * A chunk that times out or finds no free transaction ID is sent again,
+   * up to `retry_count` attempts in all; chunks that succeeded are not.
+   * Any other failure, including a reply with a non-zero RMAP status
+   * (`PacketStatusError`), ends the transfer once the chunks already in
+   * flight have completed. Each chunk gets the deadline set with
+   * `setTimeout`. A region running past address 0xFFFFFFFF fails with
+   * `invalid_argument` before anything is sent.
+   */
+  auto bulkWrite(std::shared_ptr<TargetNodeBase> target_node,
+                 uint32_t memory_address, std::span<const uint8_t> data,
+                 std::size_t chunk_size = kDefaultBulkChunkSize,
+                 std::size_t window = kDefaultBulkWindow,
+                 std::size_t retry_count = 3) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return bulkTransfer_(RmapOperation::Write, std::move(target_node),
+                         memory_address, data, {}, chunk_size, window,
+                         retry_count);
+  }
+
+  /**
+   * @brief Read `data.size()` bytes from `memory_address` onwards into
+   *        `data`; the counterpart of `bulkWrite`.
+   *
+   * Each chunk's reply is copied into its place in `data` as it arrives,
+   * without passing through the node's packet buffer.
+   */
+  auto bulkRead(std::shared_ptr<TargetNodeBase> target_node,
+                uint32_t memory_address, std::span<uint8_t> data,
+                std::size_t chunk_size = kDefaultBulkChunkSize,
+                std::size_t window = kDefaultBulkWindow,
+                std::size_t retry_count = 3) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return bulkTransfer_(RmapOperation::Read, std::move(target_node),
+                         memory_address, data, data, chunk_size, window,
+                         retry_count);
+  }
+
+  /**
+   * @brief Read every range in `requests` from `target_node`, with all
+   *        transactions in flight at once, e.g. a cycle of scattered
+   *        register reads.
+   *
+   * The commands go out back to back, so the batch costs about one round
+   * trip rather than one per request. With `merge_adjacent`, requests that
+   * continue each other exactly are read as one transaction of up to
+   * `kDefaultBulkChunkSize` bytes; overlapping requests are never merged.
+   * A transaction that times out or finds no free transaction ID is sent
+   * again, up to `retry_count` attempts; each gets the deadline set with
+   * `setTimeout`.
+   *
+   * @param results Receives the outcome of each request, empty on success;
+   *        may be empty if only the overall outcome matters.
+   * @return The failure of the first request in `requests` that failed.
+   */
+  auto readMany(std::shared_ptr<TargetNodeBase> target_node,
+                std::span<const ReadRequest> requests,
+                std::span<std::error_code> results = {},
+                bool merge_adjacent = false,
+                std::size_t retry_count = 3) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return transferMany_(RmapOperation::Read, std::move(target_node),
+                         requests, results, merge_adjacent, retry_count);
+  }
+
+  /**
+   * @brief Write every range in `requests` to `target_node`; the
+   *        counterpart of `readMany`.
+   */
+  auto writeMany(std::shared_ptr<TargetNodeBase> target_node,
+                 std::span<const WriteRequest> requests,
+                 std::span<std::error_code> results = {},
+                 bool merge_adjacent = false,
+                 std::size_t retry_count = 3) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return transferMany_(RmapOperation::Write, std::move(target_node),
+                         requests, results, merge_adjacent, retry_count);
   }
 
   auto emitTimeCode(uint8_t timecode) noexcept
@@ -964,6 +2726,14 @@ class SpwRmapTCPNodeImpl : public SpwRmapNodeBase {
     packet.at(11) = 0x02;  // reserved
     packet.at(12) = timecode;
     packet.at(13) = 0x00;
+    if (use_writer_thread_) {
+      auto frame = acquireFrame_();
+      frame->bytes.assign(packet.begin(), packet.end());
+      enqueueFrame_(std::move(frame));
+      return {};
+    }
+    std::lock_guard<std::recursive_mutex> lock(send_buf_mtx_);
+    countSend_();
     return tcp_backend_->sendAll(packet);
   }
 };
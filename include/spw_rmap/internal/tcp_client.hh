@@ -49,12 +49,24 @@ class TCPClient {
   [[nodiscard]] auto sendAll(std::span<const uint8_t> data) noexcept
       -> std::expected<std::monostate, std::error_code>;
 
+  /**
+   * @brief Send `buffers` back to back without joining them first.
+   */
+  [[nodiscard]] auto sendAllv(
+      std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
   [[nodiscard]] auto recvSome(std::span<uint8_t> buf) noexcept
       -> std::expected<size_t, std::error_code>;
 
   [[nodiscard]] auto shutdown() noexcept
       -> std::expected<std::monostate, std::error_code>;
 
+  /**
+   * @brief The connected socket, or -1.
+   */
+  [[nodiscard]] auto nativeHandle() const noexcept -> int { return fd_; }
+
   [[nodiscard]] auto getIpAddress() const noexcept -> const std::string& {
     return ip_address_;
   }
@@ -51,6 +51,13 @@ class TCPServer {
   [[nodiscard]] auto sendAll(std::span<const uint8_t> data) noexcept
       -> std::expected<std::monostate, std::error_code>;
 
+  /**
+   * @brief Send `buffers` back to back without joining them first.
+   */
+  [[nodiscard]] auto sendAllv(
+      std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
   [[nodiscard]] auto recvSome(std::span<uint8_t> buf) noexcept
       -> std::expected<size_t, std::error_code>;
 
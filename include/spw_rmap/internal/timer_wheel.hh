@@ -0,0 +1,209 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace spw_rmap::internal {
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel over a fixed set of timers.
+ *
+ * Timers are the indices `[0, capacity)`, one per transaction slot, and are
+ * linked into buckets through a preallocated entry table, so scheduling,
+ * cancelling and expiring a timer are O(1) and never allocate. Time is
+ * counted in ticks. Level `L` has 64 buckets of 64^L ticks; a timer sits in
+ * the lowest level whose bucket still separates it from the current tick
+ * and moves down a level each time the wheel reaches that bucket. Timers
+ * more than 64^4 ticks ahead wait in an overflow list.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+class TimerWheel {
+ public:
+  static constexpr std::size_t kLevels = 4;
+  static constexpr std::size_t kSlotBits = 6;
+  static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+
+ private:
+  static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+  static constexpr uint16_t kUnlinked = std::numeric_limits<uint16_t>::max();
+  static constexpr uint16_t kOverflow = kLevels * kSlots;
+
+  struct Entry {
+    uint64_t tick = 0;
+    uint32_t prev = kNil;
+    uint32_t next = kNil;
+    uint16_t bucket = kUnlinked;
+  };
+
+  std::vector<Entry> entries_;
+  std::array<uint32_t, kLevels * kSlots + 1> heads_{};
+  std::array<uint64_t, kLevels> occupied_{};
+  uint64_t now_ = 0;
+  std::size_t pending_ = 0;
+
+ public:
+  explicit TimerWheel(std::size_t capacity) : entries_(capacity) {
+    heads_.fill(kNil);
+  }
+
+  /**
+   * @brief The last tick `advance` processed.
+   */
+  [[nodiscard]] auto now() const noexcept -> uint64_t { return now_; }
+
+  [[nodiscard]] auto pending() const noexcept -> std::size_t {
+    return pending_;
+  }
+
+  [[nodiscard]] auto isScheduled(uint32_t index) const noexcept -> bool {
+    return entries_[index].bucket != kUnlinked;
+  }
+
+  /**
+   * @brief (Re)arm timer `index` to expire at `tick`; a tick that already
+   *        passed expires on the next advance.
+   */
+  auto schedule(uint32_t index, uint64_t tick) noexcept -> void {
+    cancel(index);
+    entries_[index].tick = tick > now_ ? tick : now_ + 1;
+    insert_(index);
+    ++pending_;
+  }
+
+  /**
+   * @brief Disarm timer `index`. No-op if it is not scheduled.
+   */
+  auto cancel(uint32_t index) noexcept -> void {
+    if (entries_[index].bucket == kUnlinked) {
+      return;
+    }
+    unlink_(index);
+    --pending_;
+  }
+
+  /**
+   * @brief The next tick at which `advance` has work to do: an expiry, or
+   *        a bucket moving down a level. nullopt if no timer is armed.
+   */
+  [[nodiscard]] auto nextTick() const noexcept -> std::optional<uint64_t> {
+    if (pending_ == 0) {
+      return std::nullopt;
+    }
+    for (std::size_t level = 0; level < kLevels; ++level) {
+      const auto shift = level * kSlotBits;
+      const auto group = (now_ >> shift) & (kSlots - 1);
+      if (group == kSlots - 1) {
+        continue;
+      }
+      const auto later = occupied_[level] & (~uint64_t{0} << (group + 1));
+      if (later != 0) {
+        const auto upper = shift + kSlotBits;
+        const auto slot = static_cast<uint64_t>(std::countr_zero(later));
+        return ((now_ >> upper) << upper) | (slot << shift);
+      }
+    }
+    constexpr auto kTopShift = kLevels * kSlotBits;
+    return ((now_ >> kTopShift) + 1) << kTopShift;
+  }
+
+  /**
+   * @brief Move the wheel forward to `tick`, calling `on_expire(index)` for
+   *        every timer due by then. The timer is disarmed before the call.
+   *        Runs in time proportional to the expired timers and the buckets
+   *        that move down, not to the ticks skipped.
+   */
+  template <class OnExpire>
+  auto advance(uint64_t tick, OnExpire&& on_expire) -> void {
+    while (now_ < tick) {
+      const auto next = nextTick();
+      if (!next.has_value() || *next > tick) {
+        now_ = tick;
+        return;
+      }
+      now_ = *next;
+      if ((now_ & ((uint64_t{1} << (kLevels * kSlotBits)) - 1)) == 0) {
+        cascade_(kOverflow);
+      }
+      for (std::size_t level = kLevels - 1; level > 0; --level) {
+        const auto shift = level * kSlotBits;
+        if ((now_ & ((uint64_t{1} << shift) - 1)) == 0) {
+          cascade_(bucketIndex_(level, (now_ >> shift) & (kSlots - 1)));
+        }
+      }
+      const auto bucket = bucketIndex_(0, now_ & (kSlots - 1));
+      while (heads_[bucket] != kNil) {
+        const auto index = heads_[bucket];
+        unlink_(index);
+        --pending_;
+        on_expire(index);
+      }
+    }
+  }
+
+ private:
+  static constexpr auto bucketIndex_(std::size_t level,
+                                     uint64_t slot) noexcept -> uint16_t {
+    return static_cast<uint16_t>(level * kSlots + slot);
+  }
+
+  auto insert_(uint32_t index) noexcept -> void {
+    auto& entry = entries_[index];
+    const auto diff = entry.tick ^ now_;
+    uint16_t bucket = kOverflow;
+    for (std::size_t level = 0; level < kLevels; ++level) {
+      const auto shift = level * kSlotBits;
+      if ((diff >> (shift + kSlotBits)) == 0) {
+        bucket = bucketIndex_(level, (entry.tick >> shift) & (kSlots - 1));
+        occupied_[level] |= uint64_t{1} << (bucket % kSlots);
+        break;
+      }
+    }
+    entry.bucket = bucket;
+    entry.prev = kNil;
+    entry.next = heads_[bucket];
+    if (entry.next != kNil) {
+      entries_[entry.next].prev = index;
+    }
+    heads_[bucket] = index;
+  }
+
+  auto unlink_(uint32_t index) noexcept -> void {
+    auto& entry = entries_[index];
+    if (entry.prev != kNil) {
+      entries_[entry.prev].next = entry.next;
+    } else {
+      heads_[entry.bucket] = entry.next;
+    }
+    if (entry.next != kNil) {
+      entries_[entry.next].prev = entry.prev;
+    }
+    if (heads_[entry.bucket] == kNil && entry.bucket != kOverflow) {
+      occupied_[entry.bucket / kSlots] &=
+          ~(uint64_t{1} << (entry.bucket % kSlots));
+    }
+    entry.bucket = kUnlinked;
+  }
+
+  // Re-insert every timer of `bucket` relative to the current tick. A timer
+  // due right now lands in the level 0 bucket that `advance` fires next.
+  auto cascade_(uint16_t bucket) noexcept -> void {
+    auto index = heads_[bucket];
+    while (index != kNil) {
+      const auto next = entries_[index].next;
+      unlink_(index);
+      insert_(index);
+      index = next;
+    }
+  }
+};
+
+}  // namespace spw_rmap::internal
@@ -0,0 +1,157 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace spw_rmap::internal {
+
+/**
+ * @class TransactionIdAllocator
+ * @brief Hands out the free indices `[0, capacity)` in constant time.
+ *
+ * Free indices are the set bits of a three-level bitmap: each bit of the
+ * top word says whether a summary word has a set bit, and each bit of a
+ * summary word says whether a leaf word has one. `acquire` follows three
+ * `countr_zero`s from the top to the lowest free index, `release` sets one
+ * bit per level, so both cost the same with 32 IDs or 65536. Thread-safe;
+ * the lock is held only for those few word operations.
+ */
+class TransactionIdAllocator {
+ public:
+  static constexpr std::size_t kWordBits = 64;
+  static constexpr std::size_t kMaxCapacity =
+      kWordBits * kWordBits * kWordBits;
+
+ private:
+  mutable std::mutex mtx_;
+  std::size_t capacity_;
+  std::size_t available_ = 0;
+  uint64_t top_ = 0;
+  std::array<uint64_t, kWordBits> summary_{};
+  std::vector<uint64_t> leaves_;
+
+ public:
+  explicit TransactionIdAllocator(std::size_t capacity)
+      : capacity_(capacity), leaves_((capacity + kWordBits - 1) / kWordBits) {
+    assert(capacity <= kMaxCapacity && "Too many transaction IDs");
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      markFree_(i);
+    }
+    available_ = capacity_;
+  }
+
+  TransactionIdAllocator(const TransactionIdAllocator&) = delete;
+  auto operator=(const TransactionIdAllocator&)
+      -> TransactionIdAllocator& = delete;
+  TransactionIdAllocator(TransactionIdAllocator&&) = delete;
+  auto operator=(TransactionIdAllocator&&) -> TransactionIdAllocator& = delete;
+
+  ~TransactionIdAllocator() = default;
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+    return capacity_;
+  }
+
+  /**
+   * @brief Number of indices that `acquire` can still hand out.
+   */
+  [[nodiscard]] auto available() const noexcept -> std::size_t {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return available_;
+  }
+
+  /**
+   * @brief Take the lowest free index, or nullopt when all are in use.
+   */
+  [[nodiscard]] auto acquire() noexcept -> std::optional<std::size_t> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (top_ == 0) {
+      return std::nullopt;
+    }
+    return acquire_();
+  }
+
+  /**
+   * @brief Fill `out` with the lowest free indices under one lock.
+   * @return How many were taken; fewer than `out.size()` once all are in
+   *         use.
+   */
+  [[nodiscard]] auto acquire(std::span<std::size_t> out) noexcept
+      -> std::size_t {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::size_t count = 0;
+    while (count < out.size() && top_ != 0) {
+      out[count++] = acquire_();
+    }
+    return count;
+  }
+
+  /**
+   * @brief Return `index` to the free set. Releasing a free index is a
+   *        no-op.
+   */
+  auto release(std::size_t index) noexcept -> void {
+    if (index >= capacity_) {
+      assert(false && "Transaction ID index out of range");
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (isFree_(index)) {
+      return;
+    }
+    markFree_(index);
+    ++available_;
+  }
+
+  /**
+   * @brief Whether `index` is currently free.
+   */
+  [[nodiscard]] auto isFree(std::size_t index) const noexcept -> bool {
+    if (index >= capacity_) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    return isFree_(index);
+  }
+
+ private:
+  // Caller holds `mtx_` and has checked that an index is free.
+  auto acquire_() noexcept -> std::size_t {
+    const auto s = static_cast<std::size_t>(std::countr_zero(top_));
+    const auto l =
+        s * kWordBits + static_cast<std::size_t>(std::countr_zero(summary_[s]));
+    const auto b = static_cast<std::size_t>(std::countr_zero(leaves_[l]));
+    leaves_[l] &= leaves_[l] - 1;
+    if (leaves_[l] == 0) {
+      summary_[s] &= summary_[s] - 1;
+      if (summary_[s] == 0) {
+        top_ &= top_ - 1;
+      }
+    }
+    --available_;
+    return l * kWordBits + b;
+  }
+
+  [[nodiscard]] auto isFree_(std::size_t index) const noexcept -> bool {
+    return (leaves_[index / kWordBits] >> (index % kWordBits) & 1U) != 0;
+  }
+
+  auto markFree_(std::size_t index) noexcept -> void {
+    const auto l = index / kWordBits;
+    const auto s = l / kWordBits;
+    leaves_[l] |= uint64_t{1} << (index % kWordBits);
+    summary_[s] |= uint64_t{1} << (l % kWordBits);
+    top_ |= uint64_t{1} << s;
+  }
+};
+
+}  // namespace spw_rmap::internal
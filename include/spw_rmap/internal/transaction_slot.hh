@@ -0,0 +1,129 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <system_error>
+#include <utility>
+
+#include "spw_rmap/internal/inline_function.hh"
+#include "spw_rmap/packet_parser.hh"
+
+namespace spw_rmap::internal {
+
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief What a pending transaction completes with: the reply, or the
+ *        reason there will be none.
+ */
+using TransactionResult = std::expected<const Packet*, std::error_code>;
+
+/**
+ * @brief Completion stored in a transaction slot. Captures must fit in 40
+ *        bytes; larger state lives with the caller and is captured by
+ *        pointer.
+ */
+using TransactionCallback = InlineFunction<void(TransactionResult), 40>;
+
+/**
+ * @struct TransactionSlot
+ * @brief The state and completion of one transaction ID, in one cache
+ *        line.
+ *
+ * Slots live in one array indexed by transaction ID, so completing a
+ * transaction touches its own line and never a neighbour's; the node keeps
+ * the rest of what a reply needs in a parallel array, padded the same way. `state` holds the phase in its
+ * low two bits and a generation above them that advances every time the ID
+ * is released. The reply, the deadline and a failed send race to complete
+ * a transaction; each must `claim` the armed state word first, and only
+ * the winner runs the completion. A claim for an earlier generation, e.g.
+ * from a timer that fired as the ID was being reused, fails.
+ *
+ * While its reply is being received the transaction is `kReceiving`: the
+ * receiving thread claims that word again once the reply is in, and the
+ * deadline can claim it first.
+ */
+struct alignas(kCacheLineSize) TransactionSlot {
+  static constexpr uint32_t kFree = 0;
+  static constexpr uint32_t kArmed = 1;
+  static constexpr uint32_t kCompleting = 2;
+  static constexpr uint32_t kReceiving = 3;
+  static constexpr uint32_t kPhaseMask = 3;
+  static constexpr uint32_t kGeneration = 4;
+
+  std::atomic<uint32_t> state{kFree};
+  TransactionCallback on_complete = nullptr;
+
+  [[nodiscard]] static constexpr auto phase(uint32_t word) noexcept
+      -> uint32_t {
+    return word & kPhaseMask;
+  }
+
+  /**
+   * @brief Install `callback` and publish the transaction. Called by the
+   *        thread that just acquired the ID.
+   * @return The armed state word, for `claim`.
+   */
+  auto arm(TransactionCallback callback) noexcept -> uint32_t {
+    on_complete = std::move(callback);
+    const auto armed =
+        (state.load(std::memory_order_relaxed) & ~kPhaseMask) | kArmed;
+    state.store(armed, std::memory_order_release);
+    return armed;
+  }
+
+  /**
+   * @brief Take the right to complete the transaction of generation
+   *        `armed`, still armed or receiving as in that word.
+   */
+  [[nodiscard]] auto claim(uint32_t armed) noexcept -> bool {
+    return state.compare_exchange_strong(
+        armed, (armed & ~kPhaseMask) | kCompleting, std::memory_order_acquire,
+        std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Take the right to complete whichever transaction is armed.
+   */
+  [[nodiscard]] auto claim() noexcept -> bool {
+    auto word = state.load(std::memory_order_relaxed);
+    while (phase(word) == kArmed) {
+      if (state.compare_exchange_weak(word, (word & ~kPhaseMask) | kCompleting,
+                                      std::memory_order_acquire,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Hand a claimed transaction back as `kReceiving`: its reply is
+   *        being received, and the deadline may claim it meanwhile.
+   * @return The receiving state word, for `claim`.
+   */
+  auto receiving() noexcept -> uint32_t {
+    const auto word =
+        (state.load(std::memory_order_relaxed) & ~kPhaseMask) | kReceiving;
+    state.store(word, std::memory_order_release);
+    return word;
+  }
+
+  /**
+   * @brief Back to free under the next generation. Called by the claimant
+   *        once it has taken `on_complete`.
+   */
+  auto release() noexcept -> void {
+    const auto word = state.load(std::memory_order_relaxed);
+    state.store(((word & ~kPhaseMask) + kGeneration) | kFree,
+                std::memory_order_release);
+  }
+};
+
+static_assert(sizeof(TransactionSlot) == kCacheLineSize);
+
+}  // namespace spw_rmap::internal
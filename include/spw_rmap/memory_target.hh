@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+#include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/rmap_target.hh"
+
+namespace spw_rmap {
+
+struct MemoryRegionConfig {
+  uint8_t extended_address = 0;
+  uint32_t address = 0;
+  uint64_t size = 0;  // Up to the end of the 32-bit address space
+  // Maps this file, created or grown to `size`, so the contents persist.
+  // Empty maps anonymous memory that is lost when the target goes away.
+  std::string backing_file;
+};
+
+/**
+ * @class MemoryTarget
+ * @brief RMAP target that serves commands from memory mapped regions.
+ *
+ * Regions are placed anywhere in the 40-bit space of extended address and
+ * address, and are mapped with `mmap`: anonymous regions only take memory
+ * for the pages that are touched, so a region can span the whole 4 GiB of
+ * an extended address. A command must lie within one region, otherwise it
+ * is answered as not authorised.
+ *
+ * Read replies are sent straight from the mapping (see
+ * `RmapTarget::readView`). That is safe as long as only the commands of the
+ * node serving the reads change the memory, from a single thread; handler
+ * threads and `SpwRmapTCPMultiServer` copy under a lock instead, so any
+ * number of them can share a target.
+ */
+class MemoryTarget final : public RmapTarget {
+ public:
+  MemoryTarget() = default;
+  ~MemoryTarget() override;
+
+  /**
+   * @brief Map a region; it must not overlap the regions added before.
+   */
+  auto addRegion(const MemoryRegionConfig& config) noexcept
+      -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Write file-backed regions back to their files.
+   */
+  auto sync() noexcept -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief The `size` bytes at `address`, or an empty span if they are not
+   *        all in one region. For setting up or inspecting the memory while
+   *        no node serves it.
+   */
+  [[nodiscard]] auto view(uint8_t extended_address, uint32_t address,
+                          std::size_t size) noexcept -> std::span<uint8_t>;
+
+  auto write(const Packet& packet) -> PacketStatusCode override;
+
+  auto read(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override;
+
+  auto readView(const Packet& packet)
+      -> std::optional<std::span<const uint8_t>> override;
+
+  auto readModifyWrite(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode override;
+
+ private:
+  struct Region {
+    uint64_t begin;  // extended_address << 32 | address
+    uint64_t end;
+    uint8_t* bytes;
+    bool file_backed;
+  };
+
+  // Sorted by `begin`; regions do not overlap.
+  std::vector<Region> regions_;
+  mutable std::shared_mutex mtx_;
+
+  [[nodiscard]] auto locate_(uint8_t extended_address, uint32_t address,
+                             std::size_t size) const noexcept -> uint8_t*;
+};
+
+}  // namespace spw_rmap
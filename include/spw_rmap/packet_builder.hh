@@ -96,6 +96,7 @@ struct ReadReplyPacketConfig {
   uint16_t transactionID{0};
   std::span<const uint8_t> data;
   bool incrementMode{true};
+  bool verifyMode{false};  // Set in replies to read-modify-write commands
 };
 
 struct WriteReplyPacketConfig {
@@ -2,9 +2,13 @@
 // Licensed under the MIT License. See LICENSE file for details.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 
+#include "spw_rmap/crc.hh"
+
 namespace spw_rmap {
 
 enum class PacketType {
@@ -13,6 +17,7 @@ enum class PacketType {
   Write = 2,
   ReadReply = 3,
   WriteReply = 4,
+  ReadModifyWrite = 5,  // `data` holds the data followed by the mask
 };
 
 struct Packet {
@@ -65,21 +70,74 @@ class PacketParser {
   [[nodiscard]] auto parseReadPacket(
       const std::span<const uint8_t> packet) noexcept -> Status;
 
+  /**
+   * @param data_crc CRC over the data field and its CRC byte, if the caller
+   *        already computed it (see StreamingDataCRC). Skips the second pass
+   *        over the data.
+   */
   [[nodiscard]] auto parseReadReplyPacket(
-      const std::span<const uint8_t> packet) noexcept -> Status;
+      const std::span<const uint8_t> packet,
+      std::optional<uint8_t> data_crc = std::nullopt) noexcept -> Status;
+
+  /**
+   * @brief Parse a read reply whose data field is received separately.
+   *
+   * @param head The reply address bytes followed by the 12-byte header.
+   * @param data Recorded as the packet's data as is; the caller checks it
+   *        against `dataLength` and verifies the data CRC.
+   */
+  [[nodiscard]] auto parseReadReplyHeader(
+      const std::span<const uint8_t> head,
+      const std::span<const uint8_t> data) noexcept -> Status;
 
   [[nodiscard]] auto parseWritePacket(
-      const std::span<const uint8_t> packet) noexcept -> Status;
+      const std::span<const uint8_t> packet,
+      std::optional<uint8_t> data_crc = std::nullopt) noexcept -> Status;
 
   [[nodiscard]] auto parseWriteReplyPacket(
       const std::span<const uint8_t> packet) noexcept -> Status;
 
-  [[nodiscard]] auto parse(const std::span<const uint8_t> packet) noexcept
-      -> Status;
+  [[nodiscard]] auto parse(
+      const std::span<const uint8_t> packet,
+      std::optional<uint8_t> data_crc = std::nullopt) noexcept -> Status;
 
   [[nodiscard]] auto getPacket() const noexcept -> const Packet& {
     return packet_;
   }
 };
 
+/**
+ * @class StreamingDataCRC
+ * @brief Checksums the data field of an RMAP packet while it is received.
+ *
+ * Call `advance` with the packet bytes received so far every time more
+ * arrive. Once the header is complete, only the newly appended bytes are
+ * checksummed, so the result is ready as soon as the last byte lands and
+ * can be handed to `PacketParser::parse`.
+ */
+class StreamingDataCRC {
+ private:
+  crc::CRCAccumulator accumulator_{};
+  std::size_t data_offset_ = 0;
+  std::size_t processed_ = 0;
+  bool located_ = false;
+  bool has_data_ = false;
+
+  auto locateData_(std::span<const uint8_t> received) noexcept -> bool;
+
+ public:
+  auto reset() noexcept -> void { *this = StreamingDataCRC{}; }
+
+  auto advance(std::span<const uint8_t> received) noexcept -> void;
+
+  /**
+   * @brief CRC over the data field and data CRC of `packet`.
+   *
+   * @return std::nullopt if the packet has no data field or `packet` is not
+   *         exactly the bytes passed to the last `advance`.
+   */
+  [[nodiscard]] auto result(std::span<const uint8_t> packet) const noexcept
+      -> std::optional<uint8_t>;
+};
+
 };  // namespace spw_rmap
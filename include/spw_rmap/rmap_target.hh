@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "spw_rmap/packet_parser.hh"
+
+namespace spw_rmap {
+
+/**
+ * @class RmapTarget
+ * @brief The target side of RMAP: executes commands a node receives.
+ *
+ * Register one with `SpwRmapNodeBase::registerTarget` to serve Write, Read
+ * and read-modify-write commands. Every method returns the status sent in
+ * the reply; a Read or RMW reply with a failure status carries no data.
+ */
+class RmapTarget {
+ public:
+  RmapTarget() = default;
+  virtual ~RmapTarget() = default;
+
+  RmapTarget(const RmapTarget&) = delete;
+  auto operator=(const RmapTarget&) -> RmapTarget& = delete;
+  RmapTarget(RmapTarget&&) = delete;
+  auto operator=(RmapTarget&&) -> RmapTarget& = delete;
+
+  /**
+   * @brief Store `packet.data` at the packet's address.
+   */
+  virtual auto write(const Packet& packet) -> PacketStatusCode = 0;
+
+  /**
+   * @brief Fill `data`, the data field of the reply being built and
+   *        `packet.dataLength` bytes long.
+   */
+  virtual auto read(const Packet& packet, std::span<uint8_t> data)
+      -> PacketStatusCode = 0;
+
+  /**
+   * @brief The bytes a Read command returns, if they already sit in memory
+   *        that stays valid and unchanged until the reply is sent.
+   *
+   * A node then sends them without copying them into the reply. Return
+   * std::nullopt to be asked through `read` instead, e.g. on an error.
+   *
+   * No lock is held while the bytes are sent, so a view is only safe while
+   * nothing else writes that memory. Nodes therefore ask for one only when
+   * a single thread serves the commands, the one running `runLoop`, and
+   * never from handler threads or `SpwRmapTCPMultiServer`. Memory the
+   * application itself changes meanwhile must not be handed out here.
+   */
+  virtual auto readView(const Packet& /*packet*/)
+      -> std::optional<std::span<const uint8_t>> {
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Execute a read-modify-write command.
+   *
+   * `packet.data` holds the data followed by the mask, each `data.size()`
+   * bytes. Store the old contents in `data` and write
+   * `(data & mask) | (old & ~mask)`.
+   */
+  virtual auto readModifyWrite(const Packet& /*packet*/,
+                               std::span<uint8_t> /*data*/)
+      -> PacketStatusCode {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+};
+
+}  // namespace spw_rmap
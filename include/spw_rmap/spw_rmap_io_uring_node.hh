@@ -0,0 +1,27 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include "spw_rmap/internal/io_uring_client.hh"
+#include "spw_rmap/spw_rmap_tcp_node.hh"
+
+namespace spw_rmap {
+
+/**
+ * @class SpwRmapIoUringClient
+ * @brief `SpwRmapTCPClient` with its socket I/O done through io_uring.
+ *
+ * Linux only. Check `isSupported` before use; `connect` fails where the
+ * kernel lacks io_uring or provided buffer rings.
+ */
+class SpwRmapIoUringClient
+    : public internal::SpwRmapTCPClientImpl<internal::IoUringClient> {
+ public:
+  using SpwRmapTCPClientImpl::SpwRmapTCPClientImpl;
+
+  [[nodiscard]] static auto isSupported() noexcept -> bool {
+    return internal::IoUringClient::isSupported();
+  }
+};
+
+};  // namespace spw_rmap
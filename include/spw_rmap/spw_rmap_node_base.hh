@@ -13,11 +13,22 @@
 #include <system_error>
 #include <variant>
 
+#include "spw_rmap/internal/debug.hh"
 #include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/rmap_target.hh"
 #include "spw_rmap/target_node.hh"
 
 namespace spw_rmap {
 
+/**
+ * @class SpwRmapNodeBase
+ * @brief Interface of an RMAP node, both initiator and target.
+ *
+ * Registration methods added after the first release have default
+ * implementations, so existing nodes keep compiling. A node that does not
+ * override one logs that it is not supported and keeps serving commands
+ * with the handlers it had.
+ */
 class SpwRmapNodeBase {
   bool verify_mode_{true};
 
@@ -46,6 +57,32 @@ class SpwRmapNodeBase {
   virtual auto registerOnRead(
       std::function<std::vector<uint8_t>(Packet)> onRead) noexcept -> void = 0;
 
+  /**
+   * @brief Serve Read commands without allocating.
+   *
+   * `onRead` fills the span, which is the data field of the reply being
+   * built and `dataLength` bytes long, and returns the reply's status. A
+   * failure status is sent without data. Takes precedence over
+   * `registerOnRead`; pass nullptr to go back to it.
+   */
+  virtual auto registerOnReadInto(
+      [[maybe_unused]] std::function<PacketStatusCode(Packet,
+                                                      std::span<uint8_t>)>
+          onRead) noexcept -> void {
+    spw_rmap::debug::debug("registerOnReadInto is not supported by this node");
+  }
+
+  /**
+   * @brief Serve every command with `target`, including read-modify-write
+   *        ones, which are otherwise answered as not implemented.
+   *
+   * Takes precedence over the callbacks; pass nullptr to go back to them.
+   */
+  virtual auto registerTarget(
+      [[maybe_unused]] std::shared_ptr<RmapTarget> target) noexcept -> void {
+    spw_rmap::debug::debug("registerTarget is not supported by this node");
+  }
+
   /**
    * @brief Writes data to a target node.
    *
@@ -0,0 +1,119 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "spw_rmap/internal/command_handlers.hh"
+#include "spw_rmap/internal/epoll_server.hh"
+#include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/rmap_target.hh"
+
+namespace spw_rmap {
+
+struct SpwRmapTCPMultiServerConfig {
+  std::string ip_address;
+  std::string port;  // "0" picks a free port; see getPort()
+  // Epoll workers the connections are spread over.
+  std::size_t worker_threads = 1;
+  // Longest packet a client may send; its connection is dropped above it.
+  // The default fits the largest RMAP command.
+  std::size_t max_packet_size = (std::size_t{1} << 24) + 64;
+};
+
+/**
+ * @class SpwRmapTCPMultiServer
+ * @brief RMAP target that serves many TCP clients at once.
+ *
+ * Answers commands the way `SpwRmapTCPServer` does, each on the connection
+ * it arrived on, but accepts any number of clients and multiplexes them
+ * over `worker_threads` epoll workers (see `internal::EpollServer`). The
+ * callbacks run on the workers, so they must be thread safe once more than
+ * one client connects. Register them before `start`. Linux only.
+ */
+class SpwRmapTCPMultiServer {
+ private:
+  internal::CommandHandlers handlers_{};
+  internal::EpollServer server_;
+
+ public:
+  explicit SpwRmapTCPMultiServer(SpwRmapTCPMultiServerConfig config) noexcept
+      : server_(std::move(config.ip_address), std::move(config.port),
+                config.worker_threads, config.max_packet_size,
+                [this](std::span<const uint8_t> packet,
+                       std::vector<uint8_t>& reply) {
+                  return handle_(packet, reply);
+                }) {}
+
+  SpwRmapTCPMultiServer(const SpwRmapTCPMultiServer&) = delete;
+  auto operator=(const SpwRmapTCPMultiServer&)
+      -> SpwRmapTCPMultiServer& = delete;
+  SpwRmapTCPMultiServer(SpwRmapTCPMultiServer&&) = delete;
+  auto operator=(SpwRmapTCPMultiServer&&) -> SpwRmapTCPMultiServer& = delete;
+
+  ~SpwRmapTCPMultiServer() noexcept = default;
+
+  auto registerOnWrite(std::function<void(Packet)> onWrite) noexcept -> void {
+    handlers_.on_write = std::move(onWrite);
+  }
+
+  auto registerOnRead(
+      std::function<std::vector<uint8_t>(Packet)> onRead) noexcept -> void {
+    handlers_.on_read = std::move(onRead);
+  }
+
+  /**
+   * @brief Serve Read commands without allocating; see
+   *        `SpwRmapNodeBase::registerOnReadInto`.
+   */
+  auto registerOnReadInto(
+      std::function<PacketStatusCode(Packet, std::span<uint8_t>)>
+          onRead) noexcept -> void {
+    handlers_.on_read_into = std::move(onRead);
+  }
+
+  /**
+   * @brief Serve every command with `target`; see
+   *        `SpwRmapNodeBase::registerTarget`.
+   */
+  auto registerTarget(std::shared_ptr<RmapTarget> target) noexcept -> void {
+    handlers_.target = std::move(target);
+  }
+
+  /**
+   * @brief Start listening and serving; returns once clients can connect.
+   */
+  auto start() noexcept -> std::expected<std::monostate, std::error_code>;
+
+  /**
+   * @brief Disconnect every client and stop serving.
+   */
+  auto shutdown() noexcept -> std::expected<std::monostate, std::error_code> {
+    server_.stop();
+    return {};
+  }
+
+  [[nodiscard]] auto connectionCount() const noexcept -> std::size_t {
+    return server_.connectionCount();
+  }
+
+  [[nodiscard]] auto getPort() const noexcept -> const std::string& {
+    return server_.getPort();
+  }
+
+ private:
+  auto handle_(std::span<const uint8_t> packet_bytes,
+               std::vector<uint8_t>& reply) const -> bool;
+};
+
+}  // namespace spw_rmap
@@ -16,10 +16,17 @@ namespace spw_rmap {
 
 using namespace std::chrono_literals;
 
-class SpwRmapTCPClient
-    : public internal::SpwRmapTCPNodeImpl<internal::TCPClient> {
+namespace internal {
+
+/**
+ * @brief Client node over a `TcpBackend` that connects to a server.
+ */
+template <TcpBackend Backend>
+class SpwRmapTCPClientImpl : public SpwRmapTCPNodeImpl<Backend> {
+  using Base = SpwRmapTCPNodeImpl<Backend>;
+
  public:
-  using SpwRmapTCPNodeImpl::SpwRmapTCPNodeImpl;
+  using Base::Base;
 
   std::mutex shutdown_mtx_;
   bool shutdowned_ = false;
@@ -27,15 +34,21 @@ class SpwRmapTCPClient
   auto connect(std::chrono::microseconds connect_timeout = 100ms)
       -> std::expected<std::monostate, std::error_code> {
     std::lock_guard<std::mutex> lock(shutdown_mtx_);
-    auto res = getBackend_()->connect(connect_timeout);
+    if (shutdowned_) {
+      // Release the socket shut down by `shutdown` before reconnecting.
+      this->getBackend_()->disconnect();
+    }
+    auto res = this->getBackend_()->connect(connect_timeout);
     shutdowned_ = false;
+    this->resetReceiveBuffer_();
     if (!res.has_value()) {
-      getBackend_()->disconnect();
+      this->getBackend_()->disconnect();
       return std::unexpected{res.error()};
     }
-    auto timeout_res = getBackend_()->setSendTimeout(getSendTimeout_());
+    auto timeout_res =
+        this->getBackend_()->setSendTimeout(this->getSendTimeout_());
     if (!timeout_res.has_value()) {
-      getBackend_()->disconnect();
+      this->getBackend_()->disconnect();
       return std::unexpected{timeout_res.error()};
     }
     return {};
@@ -44,19 +57,18 @@ class SpwRmapTCPClient
   auto setSendTimeout(std::chrono::microseconds timeout) noexcept
       -> std::expected<std::monostate, std::error_code> {
     std::lock_guard<std::mutex> lock(shutdown_mtx_);
-    return setSendTimeoutInternal_(timeout);
+    return this->setSendTimeoutInternal_(timeout);
   }
 
   auto shutdown() noexcept
       -> std::expected<std::monostate, std::error_code> override {
     std::lock_guard<std::mutex> lock(shutdown_mtx_);
-    if (getBackend_()) {
-      auto res = getBackend_()->shutdown();
+    if (this->getBackend_()) {
+      auto res = this->getBackend_()->shutdown();
       shutdowned_ = true;
       if (!res.has_value()) {
         return std::unexpected{res.error()};
       }
-      getBackend_() = nullptr;
     }
     return {};
   }
@@ -67,6 +79,14 @@ class SpwRmapTCPClient
   }
 };
 
+}  // namespace internal
+
+class SpwRmapTCPClient
+    : public internal::SpwRmapTCPClientImpl<internal::TCPClient> {
+ public:
+  using SpwRmapTCPClientImpl::SpwRmapTCPClientImpl;
+};
+
 class SpwRmapTCPServer
     : public internal::SpwRmapTCPNodeImpl<internal::TCPServer> {
  public:
@@ -84,6 +104,7 @@ class SpwRmapTCPServer
                 << "\n";
       return std::unexpected{res.error()};
     }
+    resetReceiveBuffer_();
     auto timeout_res = getBackend_()->setSendTimeout(getSendTimeout_());
     if (!timeout_res.has_value()) {
       std::cerr << "Failed to set send timeout: "
@@ -0,0 +1,174 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "spw_rmap/crc.hh"
+#include "spw_rmap/rmap_packet_type.hh"
+#include "spw_rmap/target_node.hh"
+
+namespace spw_rmap {
+
+/**
+ * @brief Size of a read command for the given address lengths.
+ */
+constexpr auto getReadCommandSize(size_t target_address_length,
+                                  size_t reply_address_length) noexcept
+    -> size_t {
+  return target_address_length + 4 + ((reply_address_length + 3) / 4 * 4) + 12;
+}
+
+/**
+ * @class StaticReadCommand
+ * @brief A complete RMAP read command built ahead of time.
+ *
+ * Everything except the transaction ID is fixed, so sending it is one copy
+ * plus `writeTo` patching two ID bytes and the header CRC. Build instances
+ * with `makeReadCommand`, ideally as `constexpr` values.
+ *
+ * @tparam Size Total packet length in bytes, including the header CRC.
+ */
+template <size_t Size>
+class StaticReadCommand {
+ private:
+  // Offsets counted from the end of the packet, which do not depend on the
+  // path length: ... TID(2) ext(1) addr(4) len(3) CRC(1).
+  static constexpr size_t kTransactionIDOffset = Size - 11;
+  static constexpr size_t kCRCOffset = Size - 1;
+
+  std::array<uint8_t, Size> bytes_{};
+  uint32_t data_length_{};
+  uint8_t target_logical_address_{};
+
+ public:
+  constexpr StaticReadCommand(const std::array<uint8_t, Size>& bytes,
+                              uint32_t data_length,
+                              uint8_t target_logical_address = 0xFE) noexcept
+      : bytes_(bytes),
+        data_length_(data_length),
+        target_logical_address_(target_logical_address) {}
+
+  [[nodiscard]] static constexpr auto size() noexcept -> size_t {
+    return Size;
+  }
+
+  [[nodiscard]] constexpr auto getDataLength() const noexcept -> uint32_t {
+    return data_length_;
+  }
+
+  [[nodiscard]] constexpr auto getTargetLogicalAddress() const noexcept
+      -> uint8_t {
+    return target_logical_address_;
+  }
+
+  /**
+   * @brief The packet with transaction ID 0.
+   */
+  [[nodiscard]] constexpr auto bytes() const noexcept
+      -> const std::array<uint8_t, Size>& {
+    return bytes_;
+  }
+
+  /**
+   * @brief Copy the packet into `out` with `transaction_id` filled in.
+   *
+   * The CRC is linear, so the header CRC of the patched packet is the stored
+   * CRC (computed with ID 0) xor the CRC of the ID bytes followed by the 8
+   * zero bytes after them, i.e. two slicing table lookups. `out.size()` must
+   * be at least `size()`.
+   *
+   * @return size_t The number of bytes written.
+   */
+  constexpr auto writeTo(std::span<uint8_t> out,
+                         uint16_t transaction_id) const noexcept -> size_t {
+    std::ranges::copy(bytes_, out.begin());
+    const auto hi = static_cast<uint8_t>(transaction_id >> 8);
+    const auto lo = static_cast<uint8_t>(transaction_id & 0xFF);
+    out[kTransactionIDOffset] = hi;
+    out[kTransactionIDOffset + 1] = lo;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+    out[kCRCOffset] ^= crc::SLICING_TABLES[9][hi] ^ crc::SLICING_TABLES[8][lo];
+    // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+    return Size;
+  }
+};
+
+/**
+ * @brief Build a read command for fixed path addresses at compile time.
+ *
+ * The result matches `ReadPacketBuilder` output for the same parameters and
+ * transaction ID. `reply_address` must be at most 12 bytes.
+ */
+template <size_t TargetLength, size_t ReplyLength>
+  requires(ReplyLength <= 12)
+constexpr auto makeReadCommand(
+    const std::array<uint8_t, TargetLength>& target_spacewire_address,
+    const std::array<uint8_t, ReplyLength>& reply_address,
+    uint8_t target_logical_address, uint32_t address, uint32_t data_length,
+    uint8_t extended_address = 0x00, uint8_t initiator_logical_address = 0xFE,
+    uint8_t key = 0x00, bool increment_mode = true) noexcept
+    -> StaticReadCommand<getReadCommandSize(TargetLength, ReplyLength)> {
+  constexpr auto kSize = getReadCommandSize(TargetLength, ReplyLength);
+  constexpr size_t kReplyFieldLength = (ReplyLength + 3) / 4 * 4;
+  std::array<uint8_t, kSize> out{};
+  size_t head = 0;
+  for (const auto& byte : target_spacewire_address) {
+    out[head++] = byte;
+  }
+  out[head++] = target_logical_address;
+  out[head++] = RMAPProtocolIdentifier;
+  uint8_t instruction = 0;
+  instruction |= std::to_underlying(RMAPPacketType::Command);
+  instruction |= std::to_underlying(RMAPCommandCode::Reply);
+  if (increment_mode) {
+    instruction |= std::to_underlying(RMAPCommandCode::IncrementAddress);
+  }
+  instruction |= static_cast<uint8_t>(kReplyFieldLength >> 2);
+  out[head++] = instruction;
+  out[head++] = key;
+  head += kReplyFieldLength - ReplyLength;
+  for (const auto& byte : reply_address) {
+    out[head++] = byte;
+  }
+  out[head++] = initiator_logical_address;
+  head += 2;  // Transaction ID, patched by writeTo
+  out[head++] = extended_address;
+  out[head++] = static_cast<uint8_t>((address >> 24) & 0xFF);
+  out[head++] = static_cast<uint8_t>((address >> 16) & 0xFF);
+  out[head++] = static_cast<uint8_t>((address >> 8) & 0xFF);
+  out[head++] = static_cast<uint8_t>((address >> 0) & 0xFF);
+  out[head++] = static_cast<uint8_t>((data_length >> 16) & 0xFF);
+  out[head++] = static_cast<uint8_t>((data_length >> 8) & 0xFF);
+  out[head++] = static_cast<uint8_t>((data_length >> 0) & 0xFF);
+  out[head] = crc::calcCRC(
+      std::span<const uint8_t>(out).subspan(TargetLength, head - TargetLength));
+  return {out, data_length, target_logical_address};
+}
+
+/**
+ * @brief Build a read command for a `TargetNodeFixed`.
+ */
+template <size_t TargetLength, size_t ReplyLength>
+constexpr auto makeReadCommand(
+    const TargetNodeFixed<TargetLength, ReplyLength>& target_node,
+    uint32_t address, uint32_t data_length, uint8_t extended_address = 0x00,
+    uint8_t initiator_logical_address = 0xFE, uint8_t key = 0x00,
+    bool increment_mode = true) noexcept {
+  std::array<uint8_t, TargetLength> target_spacewire_address{};
+  std::array<uint8_t, ReplyLength> reply_address{};
+  std::ranges::copy(target_node.getTargetSpaceWireAddress(),
+                    target_spacewire_address.begin());
+  std::ranges::copy(target_node.getReplyAddress(), reply_address.begin());
+  return makeReadCommand(target_spacewire_address, reply_address,
+                         target_node.getTargetLogicalAddress(), address,
+                         data_length, extended_address,
+                         initiator_logical_address, key, increment_mode);
+}
+
+};  // namespace spw_rmap
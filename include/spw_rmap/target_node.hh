@@ -2,29 +2,53 @@
 // Licensed under the MIT License. See LICENSE file for details.
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <span>
 #include <vector>
 
+#include "spw_rmap/command_header.hh"
+
 namespace spw_rmap {
 
 class TargetNodeBase {
  private:
   uint8_t logical_address_{};
+  CommandHeaderTemplate command_header_{};
+
+ protected:
+  /**
+   * @brief Precompute the command header for `reply_address`. Derived
+   *        classes call this once their addresses are set.
+   */
+  constexpr auto buildCommandHeader_(
+      std::span<const uint8_t> reply_address) noexcept -> void {
+    command_header_ = CommandHeaderTemplate(logical_address_, reply_address);
+  }
 
  public:
-  TargetNodeBase(uint8_t logical_address = 0x00) noexcept
+  constexpr TargetNodeBase(uint8_t logical_address = 0x00) noexcept
       : logical_address_(logical_address) {}
   TargetNodeBase(const TargetNodeBase&) = default;
   TargetNodeBase(TargetNodeBase&&) = default;
   auto operator=(const TargetNodeBase&) -> TargetNodeBase& = default;
   auto operator=(TargetNodeBase&&) -> TargetNodeBase& = default;
-  virtual ~TargetNodeBase() = default;
+  constexpr virtual ~TargetNodeBase() = default;
 
-  [[nodiscard]] auto getTargetLogicalAddress() const noexcept -> uint8_t {
+  [[nodiscard]] constexpr auto getTargetLogicalAddress() const noexcept
+      -> uint8_t {
     return logical_address_;
   }
 
+  /**
+   * @brief The precomputed command header, or an invalid template if the
+   *        derived class did not build one.
+   */
+  [[nodiscard]] constexpr auto getCommandHeader() const noexcept
+      -> const CommandHeaderTemplate& {
+    return command_header_;
+  }
+
   [[nodiscard]] virtual auto getTargetSpaceWireAddress() const noexcept
       -> std::span<const uint8_t> = 0;
 
@@ -39,19 +63,27 @@ class TargetNodeFixed : public TargetNodeBase {
   std::array<uint8_t, ReplyLength> reply_address{};
 
  public:
-  TargetNodeFixed(uint8_t logical_address,
-                  std::array<uint8_t, TargetLength>&& target_spacewire_address,
-                  std::array<uint8_t, ReplyLength>&& reply_address) noexcept
+  constexpr TargetNodeFixed(
+      uint8_t logical_address,
+      std::array<uint8_t, TargetLength>&& target_spacewire_address,
+      std::array<uint8_t, ReplyLength>&& reply_address) noexcept
       : TargetNodeBase(logical_address),
         target_spacewire_address(std::move(target_spacewire_address)),
-        reply_address(std::move(reply_address)) {}
+        reply_address(std::move(reply_address)) {
+    buildCommandHeader_(this->reply_address);
+  }
+  TargetNodeFixed(const TargetNodeFixed&) = default;
+  TargetNodeFixed(TargetNodeFixed&&) = default;
+  auto operator=(const TargetNodeFixed&) -> TargetNodeFixed& = default;
+  auto operator=(TargetNodeFixed&&) -> TargetNodeFixed& = default;
+  constexpr ~TargetNodeFixed() override = default;
 
-  [[nodiscard]] auto getTargetSpaceWireAddress() const noexcept
+  [[nodiscard]] constexpr auto getTargetSpaceWireAddress() const noexcept
       -> std::span<const uint8_t> override {
     return target_spacewire_address;
   }
 
-  [[nodiscard]] auto getReplyAddress() const noexcept
+  [[nodiscard]] constexpr auto getReplyAddress() const noexcept
       -> std::span<const uint8_t> override {
     return reply_address;
   };
@@ -68,7 +100,9 @@ class TargetNodeDynamic : public TargetNodeBase {
                     std::vector<uint8_t>&& reply_address) noexcept
       : TargetNodeBase(logical_address),
         target_spacewire_address(std::move(target_spacewire_address)),
-        reply_address(std::move(reply_address)) {}
+        reply_address(std::move(reply_address)) {
+    buildCommandHeader_(this->reply_address);
+  }
 
   [[nodiscard]] auto getTargetSpaceWireAddress() const noexcept
       -> std::span<const uint8_t> override {
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <system_error>
+#include <thread>
+#include <variant>
+
+namespace spw_rmap {
+
+/**
+ * @class TransactionCompletion
+ * @brief Caller-owned result of one asynchronous transaction.
+ *
+ * Passed by reference to the allocation-free `writeAsync` / `readAsync`
+ * overloads, which keep a pointer to it until the transaction completes,
+ * so it must outlive the transaction and cannot be moved. Waiting blocks
+ * on the completion's own state word (a futex on Linux); nothing is
+ * allocated. One completion can be reused for sequential transactions.
+ *
+ * The waiter may destroy the completion as soon as it sees it finished,
+ * so `complete` publishes a last state once it is done with the object,
+ * and only that state counts as finished.
+ */
+class TransactionCompletion {
+ private:
+  static constexpr uint32_t kPending = 0;
+  static constexpr uint32_t kDone = 1;
+  // `complete` no longer touches the object.
+  static constexpr uint32_t kNotified = 2;
+
+  std::atomic<uint32_t> state_{kPending};
+  std::error_code error_{};
+
+ public:
+  TransactionCompletion() noexcept = default;
+
+  TransactionCompletion(const TransactionCompletion&) = delete;
+  auto operator=(const TransactionCompletion&)
+      -> TransactionCompletion& = delete;
+  TransactionCompletion(TransactionCompletion&&) = delete;
+  auto operator=(TransactionCompletion&&) -> TransactionCompletion& = delete;
+
+  ~TransactionCompletion() = default;
+
+  [[nodiscard]] auto isReady() const noexcept -> bool {
+    return state_.load(std::memory_order_acquire) == kNotified;
+  }
+
+  /**
+   * @brief Block until the transaction has completed.
+   */
+  auto wait() const noexcept -> void {
+    auto state = state_.load(std::memory_order_acquire);
+    while (state == kPending) {
+      state_.wait(kPending, std::memory_order_acquire);
+      state = state_.load(std::memory_order_acquire);
+    }
+    // Only the wake-up call separates kDone from kNotified.
+    while (state != kNotified) {
+      std::this_thread::yield();
+      state = state_.load(std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * @brief Wait, then return how the transaction ended.
+   */
+  [[nodiscard]] auto result() const noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    wait();
+    if (error_) {
+      return std::unexpected{error_};
+    }
+    return {};
+  }
+
+  /**
+   * @brief Mark the transaction finished with `ec` (empty on success) and
+   *        wake waiters. Called by the node.
+   */
+  auto complete(std::error_code ec) noexcept -> void {
+    error_ = ec;
+    state_.store(kDone, std::memory_order_release);
+    state_.notify_all();
+    state_.store(kNotified, std::memory_order_release);
+  }
+
+  /**
+   * @brief Make the completion pending again. Called by the node when a
+   *        transaction starts.
+   */
+  auto reset() noexcept -> void {
+    error_ = {};
+    state_.store(kPending, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace spw_rmap
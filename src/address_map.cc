@@ -0,0 +1,180 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include "spw_rmap/address_map.hh"
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap {
+
+namespace {
+
+constexpr uint64_t kAddressSpace = uint64_t{1} << 32;
+
+auto beginOf(const AddressRoute& route) noexcept -> uint64_t {
+  return (uint64_t{route.extended_address} << 32) | route.address;
+}
+
+}  // namespace
+
+auto AddressMap::snapshot_() const noexcept -> std::shared_ptr<const Table> {
+  return table_.load(std::memory_order_acquire);
+}
+
+auto AddressMap::publish_(std::vector<AddressRoute> routes) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::ranges::sort(routes, {}, beginOf);
+  uint64_t previous_end = 0;
+  for (const auto& route : routes) {
+    if (route.size == 0 || route.address + route.size > kAddressSpace ||
+        !route.target) {
+      spw_rmap::debug::debug("Invalid route at address ", route.address);
+      return std::unexpected{
+          std::make_error_code(std::errc::invalid_argument)};
+    }
+    if (beginOf(route) < previous_end) {
+      spw_rmap::debug::debug("Route overlaps another at address ",
+                             route.address);
+      return std::unexpected{
+          std::make_error_code(std::errc::invalid_argument)};
+    }
+    previous_end = beginOf(route) + route.size;
+  }
+
+  std::shared_ptr<Table> table;
+  try {
+    table = std::make_shared<Table>();
+    table->begins.reserve(routes.size());
+    table->ends.reserve(routes.size());
+    table->targets.reserve(routes.size());
+  } catch (const std::bad_alloc&) {
+    return std::unexpected{
+        std::make_error_code(std::errc::not_enough_memory)};
+  }
+  for (auto& route : routes) {
+    table->begins.push_back(beginOf(route));
+    table->ends.push_back(beginOf(route) + route.size);
+    table->targets.push_back(std::move(route.target));
+  }
+  auto old = table_.exchange(std::move(table), std::memory_order_acq_rel);
+  // `old` and the targets only it holds are released here, or by the last
+  // command still routed through it.
+  return {};
+}
+
+auto AddressMap::assign(std::vector<AddressRoute> routes) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::lock_guard<std::mutex> lock(update_mtx_);
+  return publish_(std::move(routes));
+}
+
+auto AddressMap::routesOf_(const Table* table, std::size_t extra)
+    -> std::vector<AddressRoute> {
+  std::vector<AddressRoute> routes;
+  const auto count = table != nullptr ? table->begins.size() : 0;
+  routes.reserve(count + extra);
+  for (std::size_t i = 0; i < count; ++i) {
+    routes.push_back({
+        .extended_address = static_cast<uint8_t>(table->begins[i] >> 32),
+        .address = static_cast<uint32_t>(table->begins[i]),
+        .size = table->ends[i] - table->begins[i],
+        .target = table->targets[i],
+    });
+  }
+  return routes;
+}
+
+auto AddressMap::add(AddressRoute route) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::lock_guard<std::mutex> lock(update_mtx_);
+  std::vector<AddressRoute> routes;
+  try {
+    routes = routesOf_(snapshot_().get(), 1);
+  } catch (const std::bad_alloc&) {
+    return std::unexpected{
+        std::make_error_code(std::errc::not_enough_memory)};
+  }
+  routes.push_back(std::move(route));
+  return publish_(std::move(routes));
+}
+
+auto AddressMap::remove(uint8_t extended_address, uint32_t address) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::lock_guard<std::mutex> lock(update_mtx_);
+  std::vector<AddressRoute> routes;
+  try {
+    routes = routesOf_(snapshot_().get(), 0);
+  } catch (const std::bad_alloc&) {
+    return std::unexpected{
+        std::make_error_code(std::errc::not_enough_memory)};
+  }
+  const auto removed = std::erase_if(routes, [&](const AddressRoute& route) {
+    return route.extended_address == extended_address &&
+           route.address == address;
+  });
+  if (removed == 0) {
+    spw_rmap::debug::debug("No route starts at address ", address);
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+  return publish_(std::move(routes));
+}
+
+auto AddressMap::size() const noexcept -> std::size_t {
+  const auto table = snapshot_();
+  return table != nullptr ? table->begins.size() : 0;
+}
+
+auto AddressMap::route_(const Table* table, const Packet& packet,
+                        std::size_t size) noexcept -> RmapTarget* {
+  if (table == nullptr) {
+    return nullptr;
+  }
+  const uint64_t begin =
+      (uint64_t{packet.extendedAddress} << 32) | packet.address;
+  const auto next = std::ranges::upper_bound(table->begins, begin);
+  if (next == table->begins.begin()) {
+    return nullptr;
+  }
+  const auto index = static_cast<std::size_t>(
+                         std::distance(table->begins.begin(), next)) -
+                     1;
+  if (begin >= table->ends[index] || size > table->ends[index] - begin) {
+    return nullptr;
+  }
+  return table->targets[index].get();
+}
+
+auto AddressMap::write(const Packet& packet) -> PacketStatusCode {
+  const auto table = snapshot_();
+  auto* target = route_(table.get(), packet, packet.data.size());
+  if (target == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  return target->write(packet);
+}
+
+auto AddressMap::read(const Packet& packet, std::span<uint8_t> data)
+    -> PacketStatusCode {
+  const auto table = snapshot_();
+  auto* target = route_(table.get(), packet, data.size());
+  if (target == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  return target->read(packet, data);
+}
+
+auto AddressMap::readModifyWrite(const Packet& packet,
+                                 std::span<uint8_t> data)
+    -> PacketStatusCode {
+  const auto table = snapshot_();
+  auto* target = route_(table.get(), packet, data.size());
+  if (target == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  return target->readModifyWrite(packet, data);
+}
+
+}  // namespace spw_rmap
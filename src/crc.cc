@@ -2,54 +2,427 @@
 // Licensed under the MIT License. See LICENSE file for details.
 
 #include <array>
+#include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <spw_rmap/crc.hh>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPW_RMAP_CRC_HAVE_CLMUL 1
+#elif defined(__aarch64__) && \
+    (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#define SPW_RMAP_CRC_HAVE_CLMUL 1
+#endif
+
 namespace spw_rmap::crc {
 
-constexpr std::array<uint8_t, 256> CRC_LOOKUP_TABLE = {
-    0x00, 0x91, 0xe3, 0x72, 0x07, 0x96, 0xe4, 0x75,  //
-    0x0e, 0x9f, 0xed, 0x7c, 0x09, 0x98, 0xea, 0x7b,  //
-    0x1c, 0x8d, 0xff, 0x6e, 0x1b, 0x8a, 0xf8, 0x69,  //
-    0x12, 0x83, 0xf1, 0x60, 0x15, 0x84, 0xf6, 0x67,  //
-    0x38, 0xa9, 0xdb, 0x4a, 0x3f, 0xae, 0xdc, 0x4d,  //
-    0x36, 0xa7, 0xd5, 0x44, 0x31, 0xa0, 0xd2, 0x43,  //
-    0x24, 0xb5, 0xc7, 0x56, 0x23, 0xb2, 0xc0, 0x51,  //
-    0x2a, 0xbb, 0xc9, 0x58, 0x2d, 0xbc, 0xce, 0x5f,  //
-    0x70, 0xe1, 0x93, 0x02, 0x77, 0xe6, 0x94, 0x05,  //
-    0x7e, 0xef, 0x9d, 0x0c, 0x79, 0xe8, 0x9a, 0x0b,  //
-    0x6c, 0xfd, 0x8f, 0x1e, 0x6b, 0xfa, 0x88, 0x19,  //
-    0x62, 0xf3, 0x81, 0x10, 0x65, 0xf4, 0x86, 0x17,  //
-    0x48, 0xd9, 0xab, 0x3a, 0x4f, 0xde, 0xac, 0x3d,  //
-    0x46, 0xd7, 0xa5, 0x34, 0x41, 0xd0, 0xa2, 0x33,  //
-    0x54, 0xc5, 0xb7, 0x26, 0x53, 0xc2, 0xb0, 0x21,  //
-    0x5a, 0xcb, 0xb9, 0x28, 0x5d, 0xcc, 0xbe, 0x2f,  //
-    0xe0, 0x71, 0x03, 0x92, 0xe7, 0x76, 0x04, 0x95,  //
-    0xee, 0x7f, 0x0d, 0x9c, 0xe9, 0x78, 0x0a, 0x9b,  //
-    0xfc, 0x6d, 0x1f, 0x8e, 0xfb, 0x6a, 0x18, 0x89,  //
-    0xf2, 0x63, 0x11, 0x80, 0xf5, 0x64, 0x16, 0x87,  //
-    0xd8, 0x49, 0x3b, 0xaa, 0xdf, 0x4e, 0x3c, 0xad,  //
-    0xd6, 0x47, 0x35, 0xa4, 0xd1, 0x40, 0x32, 0xa3,  //
-    0xc4, 0x55, 0x27, 0xb6, 0xc3, 0x52, 0x20, 0xb1,  //
-    0xca, 0x5b, 0x29, 0xb8, 0xcd, 0x5c, 0x2e, 0xbf,  //
-    0x90, 0x01, 0x73, 0xe2, 0x97, 0x06, 0x74, 0xe5,  //
-    0x9e, 0x0f, 0x7d, 0xec, 0x99, 0x08, 0x7a, 0xeb,  //
-    0x8c, 0x1d, 0x6f, 0xfe, 0x8b, 0x1a, 0x68, 0xf9,  //
-    0x82, 0x13, 0x61, 0xf0, 0x85, 0x14, 0x66, 0xf7,  //
-    0xa8, 0x39, 0x4b, 0xda, 0xaf, 0x3e, 0x4c, 0xdd,  //
-    0xa6, 0x37, 0x45, 0xd4, 0xa1, 0x30, 0x42, 0xd3,  //
-    0xb4, 0x25, 0x57, 0xc6, 0xb3, 0x22, 0x50, 0xc1,  //
-    0xba, 0x2b, 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf   //
-};
+namespace {
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
 
-auto calcCRC(std::span<const uint8_t> data, uint8_t crc) noexcept -> uint8_t {
-  for (const auto& byte : data) {
+// Every kernel comes in two flavours: `Copy == false` only reads `src`,
+// `Copy == true` additionally stores each block to `dst` while it is still in
+// registers, so copying a payload and checksumming it is a single pass.
+
+template <bool Copy>
+auto crcReference(const uint8_t* src, uint8_t* dst, size_t size,
+                  uint8_t crc) noexcept -> uint8_t {
+  for (size_t i = 0; i < size; ++i) {
     // This is guaranteed to be safe because the lookup table is 256 bytes long
     // and the byte is in the range 0-255.
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-    crc = CRC_LOOKUP_TABLE[crc ^ byte];
+    crc = CRC_LOOKUP_TABLE[crc ^ src[i]];
+    if constexpr (Copy) {
+      dst[i] = src[i];
+    }
   }
   return crc;
 }
 
+// The RMAP CRC is only eight bits wide, so the whole state folds into the
+// first byte of each block and the remaining bytes are independent lookups.
+template <bool Copy>
+auto crcSlicing8(const uint8_t* src, uint8_t* dst, size_t size,
+                 uint8_t crc) noexcept -> uint8_t {
+  const auto& t = SLICING_TABLES;
+  while (size >= 8) {
+    std::array<uint8_t, 8> b{};
+    std::memcpy(b.data(), src, b.size());
+    if constexpr (Copy) {
+      std::memcpy(dst, b.data(), b.size());
+      dst += 8;
+    }
+    crc = t[7][crc ^ b[0]] ^ t[6][b[1]] ^ t[5][b[2]] ^ t[4][b[3]] ^
+          t[3][b[4]] ^ t[2][b[5]] ^ t[1][b[6]] ^ t[0][b[7]];
+    src += 8;
+    size -= 8;
+  }
+  return crcReference<Copy>(src, dst, size, crc);
+}
+
+template <bool Copy>
+auto crcSlicing16(const uint8_t* src, uint8_t* dst, size_t size,
+                  uint8_t crc) noexcept -> uint8_t {
+  const auto& t = SLICING_TABLES;
+  while (size >= 16) {
+    std::array<uint8_t, 16> b{};
+    std::memcpy(b.data(), src, b.size());
+    if constexpr (Copy) {
+      std::memcpy(dst, b.data(), b.size());
+      dst += 16;
+    }
+    crc = t[15][crc ^ b[0]] ^ t[14][b[1]] ^ t[13][b[2]] ^ t[12][b[3]] ^
+          t[11][b[4]] ^ t[10][b[5]] ^ t[9][b[6]] ^ t[8][b[7]] ^ t[7][b[8]] ^
+          t[6][b[9]] ^ t[5][b[10]] ^ t[4][b[11]] ^ t[3][b[12]] ^
+          t[2][b[13]] ^ t[1][b[14]] ^ t[0][b[15]];
+    src += 16;
+    size -= 16;
+  }
+  return crcSlicing8<Copy>(src, dst, size, crc);
+}
+
+// NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+
+#ifdef SPW_RMAP_CRC_HAVE_CLMUL
+
+/*
+ * Carry-less multiply folding.
+ *
+ * Data is loaded little-endian into 128-bit lanes, so bit i of a lane holds
+ * the coefficient of x^(127 - i) (the CRC is bit-reflected). Folding a lane
+ * A = lo * x^64 + hi forward by D bits uses
+ *
+ *   A * x^D = lo * x^(D + 64) + hi * x^D  (mod P)
+ *
+ * where both x^k mod P are at most degree 7. A 64x64 carry-less product of
+ * reflected operands comes out one bit short, hence the constants below are
+ * x^(D + 63) and x^(D - 1). After the last fold the remaining 16 bytes are
+ * fed through the table kernel, which performs the final reduction.
+ */
+constexpr auto xPowModP(unsigned k) noexcept -> uint64_t {
+  uint32_t r = 1;
+  for (unsigned i = 0; i < k; ++i) {
+    r <<= 1;
+    if ((r & 0x100U) != 0) {
+      r ^= 0x107U;  // x^8 + x^2 + x + 1
+    }
+  }
+  uint64_t reflected = 0;
+  for (unsigned i = 0; i < 8; ++i) {
+    if (((r >> i) & 1U) != 0) {
+      reflected |= uint64_t{1} << (63 - i);
+    }
+  }
+  return reflected;
+}
+
+struct FoldConstants {
+  uint64_t lo;  // x^(D + 63) mod P
+  uint64_t hi;  // x^(D - 1) mod P
+};
+
+constexpr auto foldConstants(unsigned distance) noexcept -> FoldConstants {
+  return {.lo = xPowModP(distance + 63), .hi = xPowModP(distance - 1)};
+}
+
+constexpr FoldConstants FOLD_BY_512 = foldConstants(512);
+constexpr FoldConstants FOLD_BY_128 = foldConstants(128);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("pclmul,sse2"))) inline auto fold(
+    __m128i acc, __m128i k) noexcept -> __m128i {
+  return _mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x00),
+                       _mm_clmulepi64_si128(acc, k, 0x11));
+}
+
+template <bool Copy>
+__attribute__((target("pclmul,sse2"))) auto crcClmul(
+    const uint8_t* src, uint8_t* dst, size_t size, uint8_t crc) noexcept
+    -> uint8_t {
+  if (size < 64) {
+    return crcSlicing16<Copy>(src, dst, size, crc);
+  }
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto load = [&src](size_t offset) noexcept -> __m128i {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+  };
+  const auto copy = [&dst](size_t offset, __m128i v) noexcept -> void {
+    if constexpr (Copy) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), v);
+    }
+  };
+  const __m128i k512 =
+      _mm_set_epi64x(static_cast<int64_t>(FOLD_BY_512.hi),
+                     static_cast<int64_t>(FOLD_BY_512.lo));
+  const __m128i k128 =
+      _mm_set_epi64x(static_cast<int64_t>(FOLD_BY_128.hi),
+                     static_cast<int64_t>(FOLD_BY_128.lo));
+
+  __m128i d0 = load(0);
+  __m128i d1 = load(16);
+  __m128i d2 = load(32);
+  __m128i d3 = load(48);
+  copy(0, d0);
+  copy(16, d1);
+  copy(32, d2);
+  copy(48, d3);
+  __m128i x0 = _mm_xor_si128(d0, _mm_cvtsi32_si128(crc));
+  __m128i x1 = d1;
+  __m128i x2 = d2;
+  __m128i x3 = d3;
+  src += 64;
+  if constexpr (Copy) {
+    dst += 64;
+  }
+  size -= 64;
+  while (size >= 64) {
+    d0 = load(0);
+    d1 = load(16);
+    d2 = load(32);
+    d3 = load(48);
+    copy(0, d0);
+    copy(16, d1);
+    copy(32, d2);
+    copy(48, d3);
+    x0 = _mm_xor_si128(fold(x0, k512), d0);
+    x1 = _mm_xor_si128(fold(x1, k512), d1);
+    x2 = _mm_xor_si128(fold(x2, k512), d2);
+    x3 = _mm_xor_si128(fold(x3, k512), d3);
+    src += 64;
+    if constexpr (Copy) {
+      dst += 64;
+    }
+    size -= 64;
+  }
+  x1 = _mm_xor_si128(fold(x0, k128), x1);
+  x2 = _mm_xor_si128(fold(x1, k128), x2);
+  x3 = _mm_xor_si128(fold(x2, k128), x3);
+  while (size >= 16) {
+    d0 = load(0);
+    copy(0, d0);
+    x3 = _mm_xor_si128(fold(x3, k128), d0);
+    src += 16;
+    if constexpr (Copy) {
+      dst += 16;
+    }
+    size -= 16;
+  }
+  std::array<uint8_t, 16> folded{};
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(folded.data()), x3);
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  crc = crcSlicing16<false>(folded.data(), nullptr, folded.size(), 0x00);
+  return crcSlicing16<Copy>(src, dst, size, crc);
+}
+
+auto cpuHasClmul() noexcept -> bool {
+  return __builtin_cpu_supports("pclmul") != 0;
+}
+
+#else  // aarch64
+
+inline auto fold(uint8x16_t acc, FoldConstants k) noexcept -> uint8x16_t {
+  const uint64x2_t a = vreinterpretq_u64_u8(acc);
+  const poly128_t lo = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(a, 0)),
+                                 static_cast<poly64_t>(k.lo));
+  const poly128_t hi = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(a, 1)),
+                                 static_cast<poly64_t>(k.hi));
+  return veorq_u8(vreinterpretq_u8_p128(lo), vreinterpretq_u8_p128(hi));
+}
+
+template <bool Copy>
+auto crcClmul(const uint8_t* src, uint8_t* dst, size_t size,
+              uint8_t crc) noexcept -> uint8_t {
+  if (size < 64) {
+    return crcSlicing16<Copy>(src, dst, size, crc);
+  }
+  const auto load = [&src](size_t offset) noexcept -> uint8x16_t {
+    return vld1q_u8(src + offset);
+  };
+  const auto copy = [&dst](size_t offset, uint8x16_t v) noexcept -> void {
+    if constexpr (Copy) {
+      vst1q_u8(dst + offset, v);
+    }
+  };
+  std::array<uint8_t, 16> seed{};
+  seed[0] = crc;
+
+  uint8x16_t d0 = load(0);
+  uint8x16_t d1 = load(16);
+  uint8x16_t d2 = load(32);
+  uint8x16_t d3 = load(48);
+  copy(0, d0);
+  copy(16, d1);
+  copy(32, d2);
+  copy(48, d3);
+  uint8x16_t x0 = veorq_u8(d0, vld1q_u8(seed.data()));
+  uint8x16_t x1 = d1;
+  uint8x16_t x2 = d2;
+  uint8x16_t x3 = d3;
+  src += 64;
+  if constexpr (Copy) {
+    dst += 64;
+  }
+  size -= 64;
+  while (size >= 64) {
+    d0 = load(0);
+    d1 = load(16);
+    d2 = load(32);
+    d3 = load(48);
+    copy(0, d0);
+    copy(16, d1);
+    copy(32, d2);
+    copy(48, d3);
+    x0 = veorq_u8(fold(x0, FOLD_BY_512), d0);
+    x1 = veorq_u8(fold(x1, FOLD_BY_512), d1);
+    x2 = veorq_u8(fold(x2, FOLD_BY_512), d2);
+    x3 = veorq_u8(fold(x3, FOLD_BY_512), d3);
+    src += 64;
+    if constexpr (Copy) {
+      dst += 64;
+    }
+    size -= 64;
+  }
+  x1 = veorq_u8(fold(x0, FOLD_BY_128), x1);
+  x2 = veorq_u8(fold(x1, FOLD_BY_128), x2);
+  x3 = veorq_u8(fold(x2, FOLD_BY_128), x3);
+  while (size >= 16) {
+    d0 = load(0);
+    copy(0, d0);
+    x3 = veorq_u8(fold(x3, FOLD_BY_128), d0);
+    src += 16;
+    if constexpr (Copy) {
+      dst += 16;
+    }
+    size -= 16;
+  }
+  std::array<uint8_t, 16> folded{};
+  vst1q_u8(folded.data(), x3);
+  crc = crcSlicing16<false>(folded.data(), nullptr, folded.size(), 0x00);
+  return crcSlicing16<Copy>(src, dst, size, crc);
+}
+
+auto cpuHasClmul() noexcept -> bool {
+#if defined(__linux__)
+  return (::getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+#else
+  return true;  // Compiled with the crypto extension enabled.
+#endif
+}
+
+#endif
+
+#endif  // SPW_RMAP_CRC_HAVE_CLMUL
+
+template <bool Copy>
+using KernelFunction = auto (*)(const uint8_t*, uint8_t*, size_t,
+                                uint8_t) noexcept -> uint8_t;
+
+template <bool Copy>
+auto getKernelFunction(Kernel kernel) noexcept -> KernelFunction<Copy> {
+  switch (kernel) {
+    case Kernel::Slicing8:
+      return &crcSlicing8<Copy>;
+    case Kernel::Slicing16:
+      return &crcSlicing16<Copy>;
+    case Kernel::CarrylessMultiply:
+#ifdef SPW_RMAP_CRC_HAVE_CLMUL
+      if (cpuHasClmul()) {
+        return &crcClmul<Copy>;
+      }
+#endif
+      return &crcReference<Copy>;
+    case Kernel::Reference:
+    default:
+      return &crcReference<Copy>;
+  }
+}
+
+auto selectKernel() noexcept -> Kernel {
+  if (isKernelSupported(Kernel::CarrylessMultiply)) {
+    return Kernel::CarrylessMultiply;
+  }
+  return Kernel::Slicing16;
+}
+
+// Function-local statics so that calcCRC is usable from other translation
+// units' static initializers.
+auto activeKernel() noexcept -> Kernel {
+  static const Kernel kernel = selectKernel();
+  return kernel;
+}
+
+template <bool Copy>
+auto activeKernelFunction() noexcept -> KernelFunction<Copy> {
+  static const KernelFunction<Copy> function =
+      getKernelFunction<Copy>(activeKernel());
+  return function;
+}
+
+}  // namespace
+
+auto internal::calcCRCDispatched(std::span<const uint8_t> data,
+                                 uint8_t crc) noexcept -> uint8_t {
+  return activeKernelFunction<false>()(data.data(), nullptr, data.size(), crc);
+}
+
+auto calcCRCWith(Kernel kernel, std::span<const uint8_t> data,
+                 uint8_t crc) noexcept -> uint8_t {
+  return getKernelFunction<false>(kernel)(data.data(), nullptr, data.size(),
+                                          crc);
+}
+
+auto copyAndCalcCRC(std::span<const uint8_t> src, std::span<uint8_t> dst,
+                    uint8_t crc) noexcept -> uint8_t {
+  assert(dst.size() >= src.size());
+  return activeKernelFunction<true>()(src.data(), dst.data(), src.size(), crc);
+}
+
+auto copyAndCalcCRCWith(Kernel kernel, std::span<const uint8_t> src,
+                        std::span<uint8_t> dst, uint8_t crc) noexcept
+    -> uint8_t {
+  assert(dst.size() >= src.size());
+  return getKernelFunction<true>(kernel)(src.data(), dst.data(), src.size(),
+                                         crc);
+}
+
+auto isKernelSupported(Kernel kernel) noexcept -> bool {
+  switch (kernel) {
+    case Kernel::Reference:
+    case Kernel::Slicing8:
+    case Kernel::Slicing16:
+      return true;
+    case Kernel::CarrylessMultiply:
+#ifdef SPW_RMAP_CRC_HAVE_CLMUL
+      return cpuHasClmul();
+#else
+      return false;
+#endif
+    default:
+      return false;
+  }
+}
+
+auto getActiveKernel() noexcept -> Kernel { return activeKernel(); }
+
+auto getKernelName(Kernel kernel) noexcept -> std::string_view {
+  switch (kernel) {
+    case Kernel::Reference:
+      return "reference";
+    case Kernel::Slicing8:
+      return "slicing-by-8";
+    case Kernel::Slicing16:
+      return "slicing-by-16";
+    case Kernel::CarrylessMultiply:
+      return "carry-less-multiply";
+    default:
+      return "unknown";
+  }
+}
+
 }  // namespace spw_rmap::crc
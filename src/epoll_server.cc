@@ -0,0 +1,555 @@
+#include "spw_rmap/internal/epoll_server.hh"
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap::internal {
+
+namespace {
+
+constexpr std::size_t kFrameHeaderSize = 12;
+constexpr std::size_t kRecvChunkSize = 64 * 1024;
+// Queued replies above which a connection is no longer read.
+constexpr std::size_t kMaxPendingOutput = 1024 * 1024;
+constexpr int kMaxEvents = 64;
+
+struct gai_category_t final : std::error_category {
+  [[nodiscard]] auto name() const noexcept -> const char* override {
+    return "gai";
+  }
+  [[nodiscard]] auto message(int ev) const -> std::string override {
+    return ::gai_strerror(ev);
+  }
+};
+
+auto gai_category() noexcept -> const std::error_category& {
+  static const gai_category_t cat{};
+  return cat;
+}
+
+auto close_retry(int fd) noexcept -> void {
+  if (fd < 0) {
+    return;
+  }
+  int r = 0;
+  do {
+    r = ::close(fd);
+  } while (r < 0 && errno == EINTR);
+}
+
+auto lastError() noexcept -> std::error_code {
+  return {errno, std::system_category()};
+}
+
+}  // namespace
+
+struct EpollServer::Connection {
+  int fd = -1;
+  // Received bytes not yet consumed are in[in_begin, in_end).
+  std::vector<uint8_t> in;
+  std::size_t in_begin = 0;
+  std::size_t in_end = 0;
+  // Payloads of the 0x02 frames of the packet being received.
+  std::vector<uint8_t> packet;
+  // Framed replies not yet sent are out[out_begin, out.size()).
+  std::vector<uint8_t> out;
+  std::size_t out_begin = 0;
+  // Reading stopped on a backlog of replies; more input may be waiting.
+  bool read_paused = false;
+
+  [[nodiscard]] auto pendingOutput() const noexcept -> std::size_t {
+    return out.size() - out_begin;
+  }
+};
+
+struct EpollServer::Worker {
+  int epoll_fd = -1;
+  std::thread thread;
+  std::mutex mtx;  // guards connections; acceptors on other workers add
+  std::unordered_map<int, std::unique_ptr<Connection>> connections;
+  std::vector<uint8_t> reply;
+};
+
+EpollServer::EpollServer(std::string bind_address, std::string port,
+                         std::size_t worker_threads,
+                         std::size_t max_packet_size, Handler handler) noexcept
+    : bind_address_(std::move(bind_address)),
+      port_(std::move(port)),
+      worker_count_(std::max<std::size_t>(worker_threads, 1)),
+      max_packet_size_(max_packet_size),
+      handler_(std::move(handler)) {}
+
+EpollServer::~EpollServer() noexcept { stop(); }
+
+auto EpollServer::listen_() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;  // IPv4/IPv6 both
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+  hints.ai_flags = AI_PASSIVE;  // for bind
+
+  addrinfo* res = nullptr;
+  if (int rc = ::getaddrinfo(bind_address_.c_str(), port_.c_str(), &hints,
+                             &res);
+      rc != 0) {
+    spw_rmap::debug::debug("getaddrinfo error: ", ::gai_strerror(rc));
+    return std::unexpected{std::error_code(rc, gai_category())};
+  }
+  std::error_code last = std::make_error_code(std::errc::invalid_argument);
+  for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+    const int fd = ::socket(ai->ai_family,
+                            ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                            ai->ai_protocol);
+    if (fd < 0) {
+      spw_rmap::debug::debug("Failed to create listening socket");
+      last = lastError();
+      continue;
+    }
+    // Allow quick rebinding after restart.
+    int yes = 1;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    (void)::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+    if (::bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+      last = lastError();
+      close_retry(fd);
+      continue;
+    }
+    listen_fd_ = fd;
+    break;
+  }
+  ::freeaddrinfo(res);
+  if (listen_fd_ < 0) {
+    return std::unexpected{last};
+  }
+  sockaddr_storage bound{};
+  socklen_t length = sizeof(bound);
+  if (::getsockname(listen_fd_,
+                    reinterpret_cast<sockaddr*>(&bound),  // NOLINT
+                    &length) == 0) {
+    if (bound.ss_family == AF_INET) {
+      port_ = std::to_string(
+          ntohs(reinterpret_cast<sockaddr_in*>(&bound)->sin_port));  // NOLINT
+    } else if (bound.ss_family == AF_INET6) {
+      port_ = std::to_string(
+          ntohs(reinterpret_cast<sockaddr_in6*>(&bound)  // NOLINT
+                    ->sin6_port));
+    }
+  }
+  return {};
+}
+
+auto EpollServer::start() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  if (listen_fd_ >= 0) {
+    return std::unexpected{
+        std::make_error_code(std::errc::operation_in_progress)};
+  }
+  if (auto res = listen_(); !res.has_value()) {
+    return res;
+  }
+  stop_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (stop_fd_ < 0) {
+    spw_rmap::debug::debug("Failed to create eventfd");
+    const auto ec = lastError();
+    stop();
+    return std::unexpected{ec};
+  }
+  try {
+    for (std::size_t i = 0; i < worker_count_; ++i) {
+      auto& worker = *workers_.emplace_back(std::make_unique<Worker>());
+      worker.epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+      // The listening socket and the eventfd are told apart from
+      // connections by these addresses.
+      epoll_event stop_event{};
+      stop_event.events = EPOLLIN;
+      stop_event.data.ptr = &stop_fd_;
+      epoll_event listen_event{};
+      listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+      listen_event.data.ptr = &listen_fd_;
+      if (worker.epoll_fd < 0 ||
+          ::epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, stop_fd_,
+                      &stop_event) != 0 ||
+          ::epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, listen_fd_,
+                      &listen_event) != 0) {
+        spw_rmap::debug::debug("Failed to set up epoll");
+        const auto ec = lastError();
+        stop();
+        return std::unexpected{ec};
+      }
+    }
+    for (auto& worker : workers_) {
+      worker->thread = std::thread(
+          [this, target = worker.get()]() noexcept { run_(*target); });
+    }
+  } catch (const std::bad_alloc&) {
+    stop();
+    return std::unexpected{std::make_error_code(std::errc::not_enough_memory)};
+  } catch (const std::system_error& e) {
+    spw_rmap::debug::debug("Failed to start worker thread: ", e.what());
+    stop();
+    return std::unexpected{e.code()};
+  }
+  return {};
+}
+
+auto EpollServer::stop() noexcept -> void {
+  if (stop_fd_ >= 0) {
+    const uint64_t one = 1;
+    (void)::write(stop_fd_, &one, sizeof(one));
+  }
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  for (auto& worker : workers_) {
+    for (auto& [fd, connection] : worker->connections) {
+      close_retry(fd);
+    }
+    worker->connections.clear();
+    close_retry(worker->epoll_fd);
+  }
+  workers_.clear();
+  connection_count_.store(0, std::memory_order_relaxed);
+  close_retry(listen_fd_);
+  listen_fd_ = -1;
+  close_retry(stop_fd_);
+  stop_fd_ = -1;
+}
+
+auto EpollServer::run_(Worker& worker) noexcept -> void {
+  std::array<epoll_event, kMaxEvents> events{};
+  for (;;) {
+    const int n =
+        ::epoll_wait(worker.epoll_fd, events.data(), kMaxEvents, -1);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      spw_rmap::debug::debug("epoll_wait failed");
+      return;
+    }
+    const auto ready = std::span(events).first(static_cast<std::size_t>(n));
+    for (const auto& event : ready) {
+      if (event.data.ptr == &stop_fd_) {
+        return;
+      }
+      if (event.data.ptr == &listen_fd_) {
+        acceptAll_();
+        continue;
+      }
+      onEvents_(worker, *static_cast<Connection*>(event.data.ptr),
+                event.events);
+    }
+  }
+}
+
+auto EpollServer::acceptAll_() noexcept -> void {
+  for (;;) {
+    const int fd =
+        ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        spw_rmap::debug::debug("Failed to accept connection: ",
+                               std::strerror(errno));
+      }
+      return;
+    }
+    // Disable Nagle for latency-sensitive traffic.
+    int yes = 1;
+    if (::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)) != 0) {
+      spw_rmap::debug::debug("Failed to set TCP_NODELAY");
+      close_retry(fd);
+      continue;
+    }
+    auto& worker = *workers_[next_worker_.fetch_add(
+                                 1, std::memory_order_relaxed) %
+                             workers_.size()];
+    Connection* connection = nullptr;
+    try {
+      auto owned = std::make_unique<Connection>();
+      owned->fd = fd;
+      connection = owned.get();
+      std::lock_guard<std::mutex> lock(worker.mtx);
+      worker.connections.emplace(fd, std::move(owned));
+    } catch (const std::bad_alloc&) {
+      spw_rmap::debug::debug("Out of memory accepting connection");
+      close_retry(fd);
+      continue;
+    }
+    connection_count_.fetch_add(1, std::memory_order_relaxed);
+    // From here on the connection belongs to `worker`'s thread.
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = connection;
+    if (::epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      spw_rmap::debug::debug("Failed to add connection to epoll");
+      close_(worker, *connection);
+    }
+  }
+}
+
+auto EpollServer::onEvents_(Worker& worker, Connection& connection,
+                            uint32_t events) noexcept -> void {
+  if ((events & EPOLLERR) != 0) {
+    close_(worker, connection);
+    return;
+  }
+  if ((events & EPOLLOUT) != 0 && !flush_(connection)) {
+    close_(worker, connection);
+    return;
+  }
+  if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0 ||
+      connection.read_paused) {
+    if (!receive_(worker, connection)) {
+      close_(worker, connection);
+    }
+  }
+}
+
+auto EpollServer::receive_(Worker& worker, Connection& connection) noexcept
+    -> bool {
+  for (;;) {
+    if (connection.pendingOutput() >= kMaxPendingOutput) {
+      if (!flush_(connection)) {
+        return false;
+      }
+      if (connection.pendingOutput() >= kMaxPendingOutput) {
+        // Resumed by the EPOLLOUT that follows the backlog draining.
+        connection.read_paused = true;
+        return true;
+      }
+    }
+    connection.read_paused = false;
+    auto& in = connection.in;
+    if (in.size() - connection.in_end < kRecvChunkSize) {
+      try {
+        in.resize(connection.in_end + kRecvChunkSize);
+      } catch (const std::bad_alloc&) {
+        spw_rmap::debug::debug("Out of memory receiving frame");
+        return false;
+      }
+    }
+    const ssize_t n = ::recv(connection.fd, in.data() + connection.in_end,
+                             in.size() - connection.in_end, 0);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      spw_rmap::debug::debug("Receive failed");
+      return false;
+    }
+    if (n == 0) {
+      // Peer closed; answer what it sent before going away.
+      std::ignore = flush_(connection);
+      return false;
+    }
+    connection.in_end += static_cast<std::size_t>(n);
+    if (!consumeFrames_(worker, connection)) {
+      return false;
+    }
+  }
+  return flush_(connection);
+}
+
+auto EpollServer::consumeFrames_(Worker& worker,
+                                 Connection& connection) noexcept -> bool {
+  const auto in = std::span<const uint8_t>(connection.in);
+  while (connection.in_end - connection.in_begin >= kFrameHeaderSize) {
+    const auto header = in.subspan(connection.in_begin, kFrameHeaderSize);
+    const uint8_t type = header[0];
+    if (header[1] != 0x00) {
+      spw_rmap::debug::debug("Received frame with invalid reserved byte: ",
+                             static_cast<int>(header[1]));
+      return false;
+    }
+    uint64_t length = 0;
+    for (std::size_t i = 4; i < kFrameHeaderSize; ++i) {
+      length = (length << 8) | header[i];
+    }
+    if (length == 0) {
+      spw_rmap::debug::debug("Received frame with zero data length");
+      return false;
+    }
+    if ((type == 0x30 || type == 0x31) &&
+        (header[2] != 0x00 || header[3] != 0x00 || length != 2)) {
+      spw_rmap::debug::debug("Received invalid Timecode frame header");
+      return false;
+    }
+    // Checked before any of the payload is buffered, so a client cannot
+    // make `in` or `packet` grow past the limit.
+    const auto pending =
+        (type == 0x00 || type == 0x02) ? connection.packet.size() : 0;
+    if (length > max_packet_size_ - pending) {
+      spw_rmap::debug::debug("Received packet longer than the limit: ",
+                             pending + length);
+      return false;
+    }
+    const auto available =
+        connection.in_end - connection.in_begin - kFrameHeaderSize;
+    if (available < length) {
+      break;
+    }
+    const auto payload =
+        in.subspan(connection.in_begin + kFrameHeaderSize, length);
+    connection.in_begin += kFrameHeaderSize + length;
+    try {
+      switch (type) {
+        case 0x00:
+          if (connection.packet.empty()) {
+            if (!handlePacket_(worker, connection, payload)) {
+              return false;
+            }
+          } else {
+            connection.packet.insert(connection.packet.end(), payload.begin(),
+                                     payload.end());
+            if (!handlePacket_(worker, connection, connection.packet)) {
+              return false;
+            }
+            connection.packet.clear();
+          }
+          break;
+        case 0x01:
+          connection.packet.clear();
+          break;
+        case 0x02:
+          connection.packet.insert(connection.packet.end(), payload.begin(),
+                                   payload.end());
+          break;
+        case 0x30:
+        case 0x31:
+          if (payload[1] != 0x00) {
+            spw_rmap::debug::debug("Received invalid Timecode frame data");
+            return false;
+          }
+          break;
+        default:
+          spw_rmap::debug::debug("Received frame with unknown type byte: ",
+                                 static_cast<int>(type));
+          return false;
+      }
+    } catch (const std::bad_alloc&) {
+      spw_rmap::debug::debug("Out of memory receiving packet");
+      return false;
+    }
+  }
+  // Keep a partial frame at the front of the buffer.
+  const auto remaining = connection.in_end - connection.in_begin;
+  if (remaining != 0 && connection.in_begin != 0) {
+    std::memmove(connection.in.data(),
+                 connection.in.data() + connection.in_begin, remaining);
+  }
+  connection.in_begin = 0;
+  connection.in_end = remaining;
+  return true;
+}
+
+auto EpollServer::handlePacket_(Worker& worker, Connection& connection,
+                                std::span<const uint8_t> packet) noexcept
+    -> bool {
+  auto& reply = worker.reply;
+  reply.clear();
+  try {
+    if (!handler_(packet, reply)) {
+      return false;
+    }
+    if (reply.empty()) {
+      return true;
+    }
+    const auto offset = connection.out.size();
+    connection.out.resize(offset + kFrameHeaderSize + reply.size());
+    auto frame = std::span(connection.out).subspan(offset);
+    const uint64_t length = reply.size();
+    frame[0] = 0x00;
+    frame[1] = 0x00;
+    frame[2] = 0x00;
+    frame[3] = 0x00;
+    for (std::size_t i = 0; i < 8; ++i) {
+      frame[4 + i] = static_cast<uint8_t>(length >> (56 - 8 * i));
+    }
+    std::ranges::copy(reply, frame.begin() + kFrameHeaderSize);
+  } catch (const std::exception& e) {
+    spw_rmap::debug::debug("Exception in packet handler: ", e.what());
+    return false;
+  }
+  return true;
+}
+
+auto EpollServer::flush_(Connection& connection) noexcept -> bool {
+  auto& out = connection.out;
+  while (connection.out_begin < out.size()) {
+    const ssize_t n =
+        ::send(connection.fd, out.data() + connection.out_begin,
+               out.size() - connection.out_begin, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // The rest goes on the next EPOLLOUT.
+        out.erase(out.begin(),
+                  out.begin() + static_cast<std::ptrdiff_t>(
+                                    connection.out_begin));
+        connection.out_begin = 0;
+        return true;
+      }
+      spw_rmap::debug::debug("Send failed");
+      return false;
+    }
+    connection.out_begin += static_cast<std::size_t>(n);
+  }
+  out.clear();
+  connection.out_begin = 0;
+  return true;
+}
+
+auto EpollServer::close_(Worker& worker, Connection& connection) noexcept
+    -> void {
+  const int fd = connection.fd;
+  std::unique_ptr<Connection> owned;
+  {
+    // Taken out before the fd is closed and can be reused by an accept.
+    std::lock_guard<std::mutex> lock(worker.mtx);
+    auto it = worker.connections.find(fd);
+    if (it == worker.connections.end()) {
+      return;
+    }
+    owned = std::move(it->second);
+    worker.connections.erase(it);
+  }
+  (void)::epoll_ctl(worker.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  close_retry(fd);
+  connection_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace spw_rmap::internal
+
+#endif  // __linux__
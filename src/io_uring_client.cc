@@ -0,0 +1,697 @@
+#include "spw_rmap/internal/io_uring_client.hh"
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap::internal {
+
+namespace {
+
+constexpr uint16_t kRecvBufferGroup = 0;
+constexpr uint16_t kRecvBufferCount = 16;  // Power of two
+constexpr std::size_t kRecvBufferSize = 16 * 1024;
+constexpr unsigned kRecvRingEntries = 4;
+constexpr unsigned kRecvCompletionEntries = kRecvBufferCount * 4;
+constexpr unsigned kSendRingEntries = 4;
+constexpr std::size_t kMaxIovecs = 64;
+
+constexpr uint64_t kRecvTag = 1;
+constexpr uint64_t kCancelTag = 2;
+constexpr uint64_t kSendTag = 3;
+constexpr uint64_t kTimeoutTag = 4;
+
+auto systemError(int error) noexcept -> std::error_code {
+  return {error, std::system_category()};
+}
+
+template <class T>
+auto loadAcquire(T* p) noexcept -> T {
+  return std::atomic_ref<T>(*p).load(std::memory_order_acquire);
+}
+
+template <class T>
+auto storeRelease(T* p, T value) noexcept -> void {
+  std::atomic_ref<T>(*p).store(value, std::memory_order_release);
+}
+
+template <class T>
+auto offsetPointer(void* base, uint32_t offset) noexcept -> T* {
+  return reinterpret_cast<T*>(  // NOLINT
+      static_cast<uint8_t*>(base) + offset);
+}
+
+}  // namespace
+
+/**
+ * Submission and completion queues of one io_uring instance.
+ */
+class IoUringClient::Ring {
+ private:
+  int fd_ = -1;
+  void* sq_ptr_ = MAP_FAILED;
+  std::size_t sq_size_ = 0;
+  void* cq_ptr_ = MAP_FAILED;
+  std::size_t cq_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t sqe_tail_ = 0;
+
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  Ring() = default;
+
+ public:
+  Ring(const Ring&) = delete;
+  auto operator=(const Ring&) -> Ring& = delete;
+  Ring(Ring&&) = delete;
+  auto operator=(Ring&&) -> Ring& = delete;
+
+  ~Ring() {
+    if (sqes_ != nullptr) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+      ::munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != MAP_FAILED) {
+      ::munmap(sq_ptr_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  /**
+   * @param cq_entries Completion queue size, or 0 for the kernel default of
+   *        twice `entries`.
+   */
+  static auto create(unsigned entries, unsigned cq_entries) noexcept
+      -> std::expected<std::unique_ptr<Ring>, std::error_code> {
+    std::unique_ptr<Ring> ring(new (std::nothrow) Ring());
+    if (!ring) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    io_uring_params params{};
+    if (cq_entries > 0) {
+      params.flags |= IORING_SETUP_CQSIZE;
+      params.cq_entries = cq_entries;
+    }
+    // Completions are reaped by the thread that submitted, so there is no
+    // need to interrupt it to post them; they are flushed on its next
+    // io_uring_enter. Kernels before 5.19 reject the flag.
+    params.flags |= IORING_SETUP_COOP_TASKRUN;
+    ring->fd_ = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->fd_ < 0 && errno == EINVAL) {
+      params.flags &= ~IORING_SETUP_COOP_TASKRUN;
+      ring->fd_ = static_cast<int>(
+          ::syscall(__NR_io_uring_setup, entries, &params));
+    }
+    if (ring->fd_ < 0) {
+      spw_rmap::debug::debug("io_uring_setup failed");
+      return std::unexpected{systemError(errno)};
+    }
+
+    ring->sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cq_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      ring->sq_size_ = std::max(ring->sq_size_, ring->cq_size_);
+      ring->cq_size_ = ring->sq_size_;
+    }
+    ring->sq_ptr_ = ::mmap(nullptr, ring->sq_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring->fd_,
+                           IORING_OFF_SQ_RING);
+    if (ring->sq_ptr_ == MAP_FAILED) {
+      spw_rmap::debug::debug("Failed to map io_uring submission queue");
+      return std::unexpected{systemError(errno)};
+    }
+    if (single_mmap) {
+      ring->cq_ptr_ = ring->sq_ptr_;
+    } else {
+      ring->cq_ptr_ = ::mmap(nullptr, ring->cq_size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring->fd_,
+                             IORING_OFF_CQ_RING);
+      if (ring->cq_ptr_ == MAP_FAILED) {
+        spw_rmap::debug::debug("Failed to map io_uring completion queue");
+        return std::unexpected{systemError(errno)};
+      }
+    }
+    ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      spw_rmap::debug::debug("Failed to map io_uring submission entries");
+      return std::unexpected{systemError(errno)};
+    }
+    ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    ring->sq_head_ = offsetPointer<uint32_t>(ring->sq_ptr_, params.sq_off.head);
+    ring->sq_tail_ = offsetPointer<uint32_t>(ring->sq_ptr_, params.sq_off.tail);
+    ring->sq_array_ =
+        offsetPointer<uint32_t>(ring->sq_ptr_, params.sq_off.array);
+    ring->sq_mask_ =
+        *offsetPointer<uint32_t>(ring->sq_ptr_, params.sq_off.ring_mask);
+    ring->sq_entries_ = params.sq_entries;
+    ring->sqe_tail_ = *ring->sq_tail_;
+
+    ring->cq_head_ = offsetPointer<uint32_t>(ring->cq_ptr_, params.cq_off.head);
+    ring->cq_tail_ = offsetPointer<uint32_t>(ring->cq_ptr_, params.cq_off.tail);
+    ring->cq_mask_ =
+        *offsetPointer<uint32_t>(ring->cq_ptr_, params.cq_off.ring_mask);
+    ring->cqes_ =
+        offsetPointer<io_uring_cqe>(ring->cq_ptr_, params.cq_off.cqes);
+    return ring;
+  }
+
+  [[nodiscard]] auto fd() const noexcept -> int { return fd_; }
+
+  /**
+   * @brief Next free submission entry, zeroed, or nullptr if the queue is
+   *        full. It is handed to the kernel by the next `submitAndWait`.
+   */
+  auto getSqe() noexcept -> io_uring_sqe* {
+    if (sqe_tail_ - loadAcquire(sq_head_) >= sq_entries_) {
+      return nullptr;
+    }
+    const uint32_t index = sqe_tail_ & sq_mask_;
+    sq_array_[index] = index;  // NOLINT
+    io_uring_sqe* sqe = &sqes_[index];  // NOLINT
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sqe_tail_;
+    return sqe;
+  }
+
+  /**
+   * @brief Submit pending entries and wait until at least `wait_nr`
+   *        completions are available.
+   */
+  auto submitAndWait(unsigned wait_nr) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    storeRelease(sq_tail_, sqe_tail_);
+    const unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0U;
+    for (;;) {
+      const unsigned to_submit = sqe_tail_ - loadAcquire(sq_head_);
+      const auto rc = ::syscall(__NR_io_uring_enter, fd_, to_submit, wait_nr,
+                                flags, nullptr, 0);
+      if (rc >= 0) {
+        return {};
+      }
+      if (errno != EINTR) {
+        spw_rmap::debug::debug("io_uring_enter failed");
+        return std::unexpected{systemError(errno)};
+      }
+    }
+  }
+
+  /**
+   * @brief Oldest unconsumed completion, or nullptr. Release it with
+   *        `advanceCq`.
+   */
+  auto peekCqe() const noexcept -> const io_uring_cqe* {
+    const uint32_t head = *cq_head_;
+    if (head == loadAcquire(cq_tail_)) {
+      return nullptr;
+    }
+    return &cqes_[head & cq_mask_];  // NOLINT
+  }
+
+  auto advanceCq() noexcept -> void { storeRelease(cq_head_, *cq_head_ + 1); }
+};
+
+/**
+ * Receive buffers registered as a provided buffer ring. The kernel picks a
+ * buffer per completion; `recycle` hands it back once consumed.
+ */
+class IoUringClient::ProvidedBuffers {
+ private:
+  int ring_fd_ = -1;
+  uint16_t group_ = 0;
+  uint16_t mask_ = 0;
+  uint16_t tail_ = 0;
+  void* ring_mem_ = MAP_FAILED;
+  std::size_t ring_mem_size_ = 0;
+  std::size_t buffer_size_ = 0;
+  std::vector<uint8_t> storage_;
+
+  ProvidedBuffers() = default;
+
+  auto bufs_() noexcept -> io_uring_buf* {
+    return static_cast<io_uring_buf*>(ring_mem_);
+  }
+
+  // The ring tail shares storage with the reserved field of the first
+  // entry, so entries are written field by field.
+  auto push_(uint16_t id) noexcept -> void {
+    io_uring_buf& buf = bufs_()[tail_ & mask_];  // NOLINT
+    buf.addr = reinterpret_cast<uint64_t>(data(id));  // NOLINT
+    buf.len = static_cast<uint32_t>(buffer_size_);
+    buf.bid = id;
+    ++tail_;
+  }
+
+  auto publish_() noexcept -> void {
+    storeRelease(&bufs_()->resv, tail_);
+  }
+
+ public:
+  ProvidedBuffers(const ProvidedBuffers&) = delete;
+  auto operator=(const ProvidedBuffers&) -> ProvidedBuffers& = delete;
+  ProvidedBuffers(ProvidedBuffers&&) = delete;
+  auto operator=(ProvidedBuffers&&) -> ProvidedBuffers& = delete;
+
+  ~ProvidedBuffers() {
+    if (ring_mem_ != MAP_FAILED) {
+      io_uring_buf_reg reg{};
+      reg.bgid = group_;
+      ::syscall(__NR_io_uring_register, ring_fd_, IORING_UNREGISTER_PBUF_RING,
+                &reg, 1);
+      ::munmap(ring_mem_, ring_mem_size_);
+    }
+  }
+
+  static auto create(const Ring& ring, uint16_t group, uint16_t count,
+                     std::size_t buffer_size) noexcept
+      -> std::expected<std::unique_ptr<ProvidedBuffers>, std::error_code> {
+    std::unique_ptr<ProvidedBuffers> bufs(new (std::nothrow) ProvidedBuffers());
+    if (!bufs) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    bufs->ring_fd_ = ring.fd();
+    bufs->group_ = group;
+    bufs->mask_ = static_cast<uint16_t>(count - 1);
+    bufs->buffer_size_ = buffer_size;
+    try {
+      bufs->storage_.resize(count * buffer_size);
+    } catch (const std::bad_alloc&) {
+      return std::unexpected{
+          std::make_error_code(std::errc::not_enough_memory)};
+    }
+    bufs->ring_mem_size_ = count * sizeof(io_uring_buf);
+    void* mem = ::mmap(nullptr, bufs->ring_mem_size_, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+      spw_rmap::debug::debug("Failed to map provided buffer ring");
+      return std::unexpected{systemError(errno)};
+    }
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(mem);  // NOLINT
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (::syscall(__NR_io_uring_register, ring.fd(),
+                  IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+      const int error = errno;
+      ::munmap(mem, bufs->ring_mem_size_);
+      spw_rmap::debug::debug("Failed to register provided buffer ring");
+      return std::unexpected{systemError(error)};
+    }
+    bufs->ring_mem_ = mem;
+    for (uint16_t id = 0; id < count; ++id) {
+      bufs->push_(id);
+    }
+    bufs->publish_();
+    return bufs;
+  }
+
+  [[nodiscard]] auto data(uint16_t id) noexcept -> uint8_t* {
+    return storage_.data() + static_cast<std::size_t>(id) * buffer_size_;
+  }
+
+  auto recycle(uint16_t id) noexcept -> void {
+    push_(id);
+    publish_();
+  }
+};
+
+IoUringClient::IoUringClient(std::string ip_address, std::string port)
+    : socket_(std::move(ip_address), std::move(port)) {}
+
+IoUringClient::~IoUringClient() { disconnect(); }
+
+auto IoUringClient::isSupported() noexcept -> bool {
+  static const bool supported = []() noexcept -> bool {
+    auto ring = Ring::create(2, 0);
+    if (!ring.has_value()) {
+      return false;
+    }
+    return ProvidedBuffers::create(**ring, kRecvBufferGroup, 1, 64)
+        .has_value();
+  }();
+  return supported;
+}
+
+auto IoUringClient::connect(std::chrono::microseconds timeout) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto res = socket_.connect(timeout);
+  if (!res.has_value()) {
+    return res;
+  }
+  auto rings = setupRings_();
+  if (!rings.has_value()) {
+    socket_.disconnect();
+    return rings;
+  }
+  return {};
+}
+
+auto IoUringClient::disconnect() noexcept -> void {
+  teardownRings_();
+  socket_.disconnect();
+}
+
+auto IoUringClient::setupRings_() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto recv_ring = Ring::create(kRecvRingEntries, kRecvCompletionEntries);
+  if (!recv_ring.has_value()) {
+    return std::unexpected{recv_ring.error()};
+  }
+  auto recv_buffers = ProvidedBuffers::create(
+      **recv_ring, kRecvBufferGroup, kRecvBufferCount, kRecvBufferSize);
+  if (!recv_buffers.has_value()) {
+    return std::unexpected{recv_buffers.error()};
+  }
+  auto send_ring = Ring::create(kSendRingEntries, 0);
+  if (!send_ring.has_value()) {
+    return std::unexpected{send_ring.error()};
+  }
+  recv_ring_ = std::move(*recv_ring);
+  recv_buffers_ = std::move(*recv_buffers);
+  send_ring_ = std::move(*send_ring);
+  recv_armed_ = false;
+  recv_remaining_ = 0;
+  return {};
+}
+
+auto IoUringClient::teardownRings_() noexcept -> void {
+  if (recv_ring_ && recv_armed_) {
+    // The multishot receive may still write into the provided buffers;
+    // cancel it and wait for its final completion before freeing them.
+    if (auto* sqe = recv_ring_->getSqe(); sqe != nullptr) {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = kRecvTag;
+      sqe->user_data = kCancelTag;
+    }
+    while (recv_armed_) {
+      const auto* cqe = recv_ring_->peekCqe();
+      if (cqe == nullptr) {
+        if (!recv_ring_->submitAndWait(1).has_value()) {
+          break;
+        }
+        continue;
+      }
+      if (cqe->user_data == kRecvTag &&
+          (cqe->flags & IORING_CQE_F_MORE) == 0) {
+        recv_armed_ = false;
+      }
+      recv_ring_->advanceCq();
+    }
+  }
+  recv_buffers_.reset();
+  recv_ring_.reset();
+  send_ring_.reset();
+  recv_armed_ = false;
+  recv_remaining_ = 0;
+}
+
+auto IoUringClient::setSendTimeout(std::chrono::microseconds timeout) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  if (timeout < std::chrono::microseconds::zero()) {
+    spw_rmap::debug::debug("Negative timeout value");
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+  std::lock_guard<std::mutex> lock(send_mtx_);
+  send_timeout_ = timeout;
+  return {};
+}
+
+auto IoUringClient::sendAll(std::span<const uint8_t> data) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  const std::array<std::span<const uint8_t>, 1> buffers = {data};
+  return sendAllv(buffers);
+}
+
+auto IoUringClient::sendAllv(
+    std::span<const std::span<const uint8_t>> buffers) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::lock_guard<std::mutex> lock(send_mtx_);
+  if (!send_ring_) {
+    spw_rmap::debug::debug("Not connected");
+    return std::unexpected{std::make_error_code(std::errc::not_connected)};
+  }
+  std::size_t total = 0;
+  for (const auto& buffer : buffers) {
+    total += buffer.size();
+  }
+  std::size_t offset = 0;
+  bool retried_zero = false;
+  bool wait = false;
+  while (offset < total) {
+    auto res = sendChunk_(buffers, offset, wait);
+    if (!res.has_value()) {
+      if (res.error() == std::errc::interrupted) {
+        continue;
+      }
+      if (!wait &&
+          res.error() == std::errc::resource_unavailable_try_again) {
+        wait = true;
+        continue;
+      }
+      return std::unexpected{res.error()};
+    }
+    wait = false;
+    if (*res == 0) {
+      if (retried_zero) {
+        spw_rmap::debug::debug("Send returned zero twice, treating as error");
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+      }
+      retried_zero = true;
+      continue;
+    }
+    offset += *res;
+  }
+  return {};
+}
+
+/**
+ * Submit one `sendmsg` covering up to kMaxIovecs buffers from byte `offset`
+ * of `buffers` and wait for it. Without `wait` the send does not block and
+ * fails with EAGAIN when the socket buffer is full; arming the linked
+ * timeout costs more than the send itself, so it is only used with `wait`.
+ */
+auto IoUringClient::sendChunk_(
+    std::span<const std::span<const uint8_t>> buffers, std::size_t offset,
+    bool wait) noexcept
+    -> std::expected<std::size_t, std::error_code> {
+  std::array<iovec, kMaxIovecs> iov{};
+  std::size_t iov_count = 0;
+  for (const auto& buffer : buffers) {
+    if (iov_count == iov.size()) {
+      break;
+    }
+    if (offset >= buffer.size()) {
+      offset -= buffer.size();
+      continue;
+    }
+    auto rest = buffer.subspan(offset);
+    offset = 0;
+    iov.at(iov_count++) = {
+        .iov_base = const_cast<uint8_t*>(rest.data()),  // NOLINT
+        .iov_len = rest.size(),
+    };
+  }
+  msghdr msg{};
+  msg.msg_iov = iov.data();
+  msg.msg_iovlen = iov_count;
+
+  auto* sqe = send_ring_->getSqe();
+  if (sqe == nullptr) {
+    return std::unexpected{
+        std::make_error_code(std::errc::device_or_resource_busy)};
+  }
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = socket_.nativeHandle();
+  sqe->addr = reinterpret_cast<uint64_t>(&msg);  // NOLINT
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL | (wait ? MSG_WAITALL : MSG_DONTWAIT);
+  sqe->user_data = kSendTag;
+  unsigned submitted = 1;
+
+  __kernel_timespec ts{};
+  if (wait && send_timeout_ > std::chrono::microseconds::zero()) {
+    auto* timeout_sqe = send_ring_->getSqe();
+    if (timeout_sqe != nullptr) {
+      const auto secs =
+          std::chrono::duration_cast<std::chrono::seconds>(send_timeout_);
+      ts.tv_sec = secs.count();
+      ts.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       send_timeout_ - secs)
+                       .count();
+      sqe->flags |= IOSQE_IO_LINK;
+      timeout_sqe->opcode = IORING_OP_LINK_TIMEOUT;
+      timeout_sqe->addr = reinterpret_cast<uint64_t>(&ts);  // NOLINT
+      timeout_sqe->len = 1;
+      timeout_sqe->user_data = kTimeoutTag;
+      ++submitted;
+    }
+  }
+
+  int32_t result = 0;
+  unsigned reaped = 0;
+  while (reaped < submitted) {
+    const auto* cqe = send_ring_->peekCqe();
+    if (cqe == nullptr) {
+      // `msg`, `iov` and `ts` must stay alive until every completion of this
+      // submission has been reaped, so waiting can not be abandoned.
+      auto res = send_ring_->submitAndWait(submitted - reaped);
+      if (!res.has_value() &&
+          res.error() != std::errc::resource_unavailable_try_again &&
+          res.error() != std::errc::device_or_resource_busy) {
+        return std::unexpected{res.error()};
+      }
+      continue;
+    }
+    if (cqe->user_data == kSendTag) {
+      result = cqe->res;
+    }
+    send_ring_->advanceCq();
+    ++reaped;
+  }
+
+  if (result >= 0) {
+    return static_cast<std::size_t>(result);
+  }
+  if (!wait && result == -EAGAIN) {
+    return std::unexpected{
+        std::make_error_code(std::errc::resource_unavailable_try_again)};
+  }
+  if (result == -ECANCELED || result == -EAGAIN) {
+    spw_rmap::debug::debug("Send timed out");
+    return std::unexpected{std::make_error_code(std::errc::timed_out)};
+  }
+  if (result != -EINTR) {
+    spw_rmap::debug::debug("Send failed");
+  }
+  return std::unexpected{systemError(-result)};
+}
+
+auto IoUringClient::armRecv_() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto* sqe = recv_ring_->getSqe();
+  if (sqe == nullptr) {
+    return std::unexpected{
+        std::make_error_code(std::errc::device_or_resource_busy)};
+  }
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = socket_.nativeHandle();
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kRecvBufferGroup;
+  sqe->user_data = kRecvTag;
+  recv_armed_ = true;
+  return {};
+}
+
+auto IoUringClient::recvSome(std::span<uint8_t> buf) noexcept
+    -> std::expected<size_t, std::error_code> {
+  if (buf.empty()) {
+    return 0U;  // Nothing to receive
+  }
+  if (!recv_ring_) {
+    spw_rmap::debug::debug("Not connected");
+    return std::unexpected{std::make_error_code(std::errc::not_connected)};
+  }
+  for (;;) {
+    if (recv_remaining_ > 0) {
+      const auto n = std::min(buf.size(), recv_remaining_);
+      std::memcpy(buf.data(),
+                  recv_buffers_->data(recv_buffer_id_) + recv_offset_, n);
+      recv_offset_ += n;
+      recv_remaining_ -= n;
+      if (recv_remaining_ == 0) {
+        recv_buffers_->recycle(recv_buffer_id_);
+      }
+      return n;
+    }
+    if (!recv_armed_) {
+      auto res = armRecv_();
+      if (!res.has_value()) {
+        return std::unexpected{res.error()};
+      }
+    }
+    const auto* cqe = recv_ring_->peekCqe();
+    if (cqe == nullptr) {
+      auto res = recv_ring_->submitAndWait(1);
+      if (!res.has_value()) {
+        return std::unexpected{res.error()};
+      }
+      continue;
+    }
+    const uint64_t tag = cqe->user_data;
+    const int32_t result = cqe->res;
+    const uint32_t flags = cqe->flags;
+    recv_ring_->advanceCq();
+    if (tag != kRecvTag) {
+      continue;
+    }
+    if ((flags & IORING_CQE_F_MORE) == 0) {
+      recv_armed_ = false;
+    }
+    if (result > 0) {
+      if ((flags & IORING_CQE_F_BUFFER) == 0) {
+        spw_rmap::debug::debug("Receive completed without a buffer");
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+      }
+      recv_buffer_id_ = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+      recv_offset_ = 0;
+      recv_remaining_ = static_cast<std::size_t>(result);
+      continue;
+    }
+    if (result == 0) {
+      spw_rmap::debug::debug("Connection closed by peer");
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+    }
+    if (result == -ENOBUFS || result == -EINTR) {
+      // Every buffer was in use; the receive is re-armed once the queued
+      // completions have been consumed.
+      continue;
+    }
+    spw_rmap::debug::debug("Receive failed");
+    return std::unexpected{systemError(-result)};
+  }
+}
+
+auto IoUringClient::shutdown() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  return socket_.shutdown();
+}
+
+}  // namespace spw_rmap::internal
+
+#endif  // __linux__
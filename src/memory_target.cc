@@ -0,0 +1,201 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include "spw_rmap/memory_target.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap {
+
+namespace {
+
+constexpr uint64_t kAddressSpace = uint64_t{1} << 32;
+
+// RMW commands carry 0 to 4 bytes of data, each followed by its mask.
+constexpr uint32_t kMaxRmwDataLength = 8;
+
+auto lastError() noexcept -> std::error_code {
+  return {errno, std::system_category()};
+}
+
+auto mapFile(const std::string& path, uint64_t size) noexcept
+    -> std::expected<void*, std::error_code> {
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    spw_rmap::debug::debug("Failed to open backing file: ", path);
+    return std::unexpected{lastError()};
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 ||
+      (static_cast<uint64_t>(st.st_size) < size &&
+       ::ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+    const auto error = lastError();
+    ::close(fd);
+    return std::unexpected{error};
+  }
+  void* bytes =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const auto error = lastError();
+  ::close(fd);  // The mapping keeps the file open
+  if (bytes == MAP_FAILED) {
+    return std::unexpected{error};
+  }
+  return bytes;
+}
+
+}  // namespace
+
+MemoryTarget::~MemoryTarget() {
+  for (const auto& region : regions_) {
+    ::munmap(region.bytes, region.end - region.begin);
+  }
+}
+
+auto MemoryTarget::addRegion(const MemoryRegionConfig& config) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  if (config.size == 0 || config.address + config.size > kAddressSpace) {
+    spw_rmap::debug::debug("Region outside the address space, size ",
+                           config.size);
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+  const uint64_t begin =
+      (uint64_t{config.extended_address} << 32) | config.address;
+  const uint64_t end = begin + config.size;
+
+  std::unique_lock lock(mtx_);
+  const auto next = std::ranges::upper_bound(regions_, begin, {},
+                                             &Region::begin);
+  if ((next != regions_.end() && next->begin < end) ||
+      (next != regions_.begin() && std::prev(next)->end > begin)) {
+    spw_rmap::debug::debug("Region overlaps another at address ",
+                           config.address);
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+
+  void* bytes = nullptr;
+  if (config.backing_file.empty()) {
+    bytes = ::mmap(nullptr, config.size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (bytes == MAP_FAILED) {
+      return std::unexpected{lastError()};
+    }
+  } else {
+    auto res = mapFile(config.backing_file, config.size);
+    if (!res.has_value()) {
+      return std::unexpected{res.error()};
+    }
+    bytes = *res;
+  }
+  regions_.insert(next, Region{
+                            .begin = begin,
+                            .end = end,
+                            .bytes = static_cast<uint8_t*>(bytes),
+                            .file_backed = !config.backing_file.empty(),
+                        });
+  return {};
+}
+
+auto MemoryTarget::sync() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  std::shared_lock lock(mtx_);
+  for (const auto& region : regions_) {
+    if (region.file_backed &&
+        ::msync(region.bytes, region.end - region.begin, MS_SYNC) != 0) {
+      return std::unexpected{lastError()};
+    }
+  }
+  return {};
+}
+
+auto MemoryTarget::locate_(uint8_t extended_address, uint32_t address,
+                           std::size_t size) const noexcept -> uint8_t* {
+  const uint64_t begin = (uint64_t{extended_address} << 32) | address;
+  const auto next = std::ranges::upper_bound(regions_, begin, {},
+                                             &Region::begin);
+  if (next == regions_.begin()) {
+    return nullptr;
+  }
+  const auto& region = *std::prev(next);
+  if (begin >= region.end || size > region.end - begin) {
+    return nullptr;
+  }
+  return region.bytes + (begin - region.begin);
+}
+
+auto MemoryTarget::view(uint8_t extended_address, uint32_t address,
+                        std::size_t size) noexcept -> std::span<uint8_t> {
+  std::shared_lock lock(mtx_);
+  auto* bytes = locate_(extended_address, address, size);
+  if (bytes == nullptr) {
+    return {};
+  }
+  return {bytes, size};
+}
+
+auto MemoryTarget::write(const Packet& packet) -> PacketStatusCode {
+  std::unique_lock lock(mtx_);
+  auto* bytes =
+      locate_(packet.extendedAddress, packet.address, packet.data.size());
+  if (bytes == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  std::memcpy(bytes, packet.data.data(), packet.data.size());
+  return PacketStatusCode::CommandExecutedSuccessfully;
+}
+
+auto MemoryTarget::read(const Packet& packet, std::span<uint8_t> data)
+    -> PacketStatusCode {
+  std::shared_lock lock(mtx_);
+  const auto* bytes =
+      locate_(packet.extendedAddress, packet.address, data.size());
+  if (bytes == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  std::memcpy(data.data(), bytes, data.size());
+  return PacketStatusCode::CommandExecutedSuccessfully;
+}
+
+auto MemoryTarget::readView(const Packet& packet)
+    -> std::optional<std::span<const uint8_t>> {
+  std::shared_lock lock(mtx_);
+  const auto* bytes =
+      locate_(packet.extendedAddress, packet.address, packet.dataLength);
+  if (bytes == nullptr) {
+    return std::nullopt;  // `read` reports the error
+  }
+  return std::span<const uint8_t>(bytes, packet.dataLength);
+}
+
+auto MemoryTarget::readModifyWrite(const Packet& packet,
+                                   std::span<uint8_t> data)
+    -> PacketStatusCode {
+  if (packet.dataLength % 2 != 0 || packet.dataLength > kMaxRmwDataLength ||
+      packet.data.size() != 2 * data.size()) {
+    return PacketStatusCode::RMWDataLengthError;
+  }
+  std::unique_lock lock(mtx_);
+  auto* bytes = locate_(packet.extendedAddress, packet.address, data.size());
+  if (bytes == nullptr) {
+    return PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  }
+  const auto value = packet.data.first(data.size());
+  const auto mask = packet.data.subspan(data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = bytes[i];
+    bytes[i] = static_cast<uint8_t>((value[i] & mask[i]) |
+                                    (bytes[i] & ~mask[i]));
+  }
+  return PacketStatusCode::CommandExecutedSuccessfully;
+}
+
+}  // namespace spw_rmap
@@ -1,5 +1,6 @@
 #include "spw_rmap/packet_parser.hh"
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
@@ -62,7 +63,8 @@ auto PacketParser::parseReadPacket(
 }
 
 auto PacketParser::parseReadReplyPacket(
-    const std::span<const uint8_t> packet) noexcept -> Status {
+    const std::span<const uint8_t> packet,
+    std::optional<uint8_t> data_crc) noexcept -> Status {
   size_t head = 0;
   if (packet.size() < 12) {
     return Status::IncompletePacket;
@@ -88,7 +90,11 @@ auto PacketParser::parseReadReplyPacket(
   if (packet.size() != 12 + packet_.dataLength + 1) {
     return Status::IncompletePacket;
   }
-  if (crc::calcCRC(packet.subspan(12, packet_.dataLength + 1)) != 0x00) {
+  // Only fall back to a second pass when no streamed CRC was supplied.
+  if ((data_crc.has_value()
+           ? *data_crc
+           : crc::calcCRC(packet.subspan(12, packet_.dataLength + 1))) !=
+      0x00) {
     return Status::DataCRCError;
   }
   head++;
@@ -96,8 +102,45 @@ auto PacketParser::parseReadReplyPacket(
       std::span<const uint8_t>(packet).subspan(head, packet_.dataLength);
   return Status::Success;
 }
+auto PacketParser::parseReadReplyHeader(
+    const std::span<const uint8_t> head,
+    const std::span<const uint8_t> data) noexcept -> Status {
+  size_t prefix = 0;
+  while (prefix < head.size() && head[prefix] < 0x20) {
+    prefix++;
+  }
+  if (head.size() - prefix != 12) {
+    return Status::IncompletePacket;
+  }
+  const auto header = head.subspan(prefix);
+  const auto instruction = header[2];
+  if ((instruction & 0b01000000) != 0 ||
+      (instruction & std::to_underlying(RMAPCommandCode::Write)) != 0) {
+    return Status::NotReplyPacket;
+  }
+  if (crc::calcCRC(header) != 0x00) {
+    return Status::HeaderCRCError;
+  }
+  if (header[1] != 0x01) {
+    return Status::UnknownProtocolIdentifier;
+  }
+  packet_.type = PacketType::ReadReply;
+  packet_.replyAddress = head.first(prefix);
+  packet_.initiatorLogicalAddress = header[0];
+  packet_.instruction = instruction;
+  packet_.status = header[3];
+  packet_.targetLogicalAddress = header[4];
+  packet_.transactionID =
+      static_cast<uint16_t>((header[5] << 8) | (header[6] << 0));
+  packet_.dataLength = (static_cast<uint32_t>(header[8]) << 16) |
+                       (static_cast<uint32_t>(header[9]) << 8) |
+                       (static_cast<uint32_t>(header[10]) << 0);
+  packet_.data = data;
+  return Status::Success;
+}
 auto PacketParser::parseWritePacket(
-    const std::span<const uint8_t> packet) noexcept -> Status {
+    const std::span<const uint8_t> packet,
+    std::optional<uint8_t> data_crc) noexcept -> Status {
   if (packet.size() < 4) {
     return Status::IncompletePacket;
   }
@@ -147,8 +190,10 @@ auto PacketParser::parseWritePacket(
   if (packet.size() != 16 + replyAddressSize + packet_.dataLength + 1) {
     return Status::IncompletePacket;
   }
-  if (crc::calcCRC(packet.subspan(16 + replyAddressSize,
-                                  packet_.dataLength + 1)) != 0x00) {
+  if ((data_crc.has_value()
+           ? *data_crc
+           : crc::calcCRC(packet.subspan(16 + replyAddressSize,
+                                         packet_.dataLength + 1))) != 0x00) {
     return Status::DataCRCError;
   }
   head++;  // Skip CRC byte
@@ -177,8 +222,8 @@ auto PacketParser::parseWriteReplyPacket(
   packet_.transactionID |= (packet[head++] << 0);
   return Status::Success;
 }
-auto PacketParser::parse(const std::span<const uint8_t> packet) noexcept
-    -> Status {
+auto PacketParser::parse(const std::span<const uint8_t> packet,
+                         std::optional<uint8_t> data_crc) noexcept -> Status {
   size_t head = 0;
 
   // Parse target SpaceWire address
@@ -203,24 +248,83 @@ auto PacketParser::parse(const std::span<const uint8_t> packet) noexcept
     case 0b00:  // Read reply
       packet_.type = PacketType::ReadReply;
       packet_.replyAddress = std::span<const uint8_t>(packet).subspan(0, head);
-      return parseReadReplyPacket(packet.subspan(head));
+      return parseReadReplyPacket(packet.subspan(head), data_crc);
     case 0b01:  // Write reply
       packet_.type = PacketType::WriteReply;
       packet_.replyAddress = std::span<const uint8_t>(packet).subspan(0, head);
       return parseWriteReplyPacket(packet.subspan(head));
-    case 0b10:  // Read command
-      packet_.type = PacketType::Read;
+    case 0b10:  // Read or read-modify-write command
       packet_.targetSpaceWireAddress =
           std::span<const uint8_t>(packet).subspan(0, head);
+      if ((packet_.instruction &
+           std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite)) != 0) {
+        // An RMW command carries its data and mask like a write does.
+        packet_.type = PacketType::ReadModifyWrite;
+        return parseWritePacket(packet.subspan(head), data_crc);
+      }
+      packet_.type = PacketType::Read;
       return parseReadPacket(packet.subspan(head));
     case 0b11:  // Write command
       packet_.type = PacketType::Write;
       packet_.targetSpaceWireAddress =
           std::span<const uint8_t>(packet).subspan(0, head);
-      return parseWritePacket(packet.subspan(head));
+      return parseWritePacket(packet.subspan(head), data_crc);
     default:
       std::unreachable();
   }
 }
 
+auto StreamingDataCRC::locateData_(
+    std::span<const uint8_t> received) noexcept -> bool {
+  size_t head = 0;
+  while (head < received.size() && received[head] < 0x20) {
+    head++;
+  }
+  if (received.size() - head < 3) {
+    return false;  // Instruction byte not received yet.
+  }
+  const auto instruction = received[head + 2];
+  const bool is_command = (instruction & 0b01000000) != 0;
+  const bool is_write =
+      (instruction & std::to_underlying(RMAPCommandCode::Write)) != 0;
+  const bool is_verify =
+      (instruction &
+       std::to_underlying(RMAPCommandCode::VerifyDataBeforeWrite)) != 0;
+  if (is_command && (is_write || is_verify)) {
+    data_offset_ =
+        head + 16 + static_cast<size_t>(instruction & 0b00000011) * 4;
+    has_data_ = true;
+  } else if (!is_command && !is_write) {
+    data_offset_ = head + 12;
+    has_data_ = true;
+  }
+  located_ = true;
+  return true;
+}
+
+auto StreamingDataCRC::advance(std::span<const uint8_t> received) noexcept
+    -> void {
+  if (!located_ && !locateData_(received)) {
+    return;
+  }
+  if (!has_data_ || received.size() <= data_offset_) {
+    processed_ = received.size();
+    return;
+  }
+  const auto from = std::max(processed_, data_offset_);
+  if (received.size() > from) {
+    accumulator_.update(received.subspan(from));
+  }
+  processed_ = received.size();
+}
+
+auto StreamingDataCRC::result(std::span<const uint8_t> packet) const noexcept
+    -> std::optional<uint8_t> {
+  if (!located_ || !has_data_ || processed_ != packet.size() ||
+      packet.size() <= data_offset_) {
+    return std::nullopt;
+  }
+  return accumulator_.value();
+}
+
 }  // namespace spw_rmap
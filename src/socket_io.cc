@@ -0,0 +1,110 @@
+// Copyright (c) 2025 Gen
+// Licensed under the MIT License. See LICENSE file for details.
+#include "spw_rmap/internal/socket_io.hh"
+
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap::internal {
+
+namespace {
+
+// iovecs handed to one sendmsg call; longer lists are sent in windows.
+constexpr std::size_t kMaxIovecs = 64;
+
+}  // namespace
+
+auto sendAllv(int fd,
+              std::span<const std::span<const uint8_t>> buffers) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  if (fd < 0) {
+    spw_rmap::debug::debug("Not connected");
+    return std::unexpected{std::make_error_code(std::errc::not_connected)};
+  }
+#ifndef __APPLE__
+  constexpr int kFlags = MSG_NOSIGNAL;
+#else
+  constexpr int kFlags = 0;  // SO_NOSIGPIPE is set on the socket
+#endif
+  std::array<iovec, kMaxIovecs> iov{};
+  std::size_t index = 0;   // First buffer not fully sent
+  std::size_t offset = 0;  // Bytes of buffers[index] already sent
+  bool retried_zero = false;
+  for (;;) {
+    while (index < buffers.size() && offset == buffers[index].size()) {
+      ++index;
+      offset = 0;
+    }
+    if (index == buffers.size()) {
+      return {};
+    }
+
+    std::size_t count = 0;
+    for (std::size_t i = index; i < buffers.size() && count < kMaxIovecs;
+         ++i) {
+      const auto buf = i == index ? buffers[i].subspan(offset) : buffers[i];
+      if (buf.empty()) {
+        continue;
+      }
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      iov[count].iov_base = const_cast<uint8_t*>(buf.data());
+      iov[count].iov_len = buf.size();
+      ++count;
+    }
+    msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(count);
+
+    const ssize_t n = ::sendmsg(fd, &msg, kFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        spw_rmap::debug::debug("Send would block, timing out");
+        return std::unexpected{std::make_error_code(std::errc::timed_out)};
+      }
+      spw_rmap::debug::debug("Send failed");
+      return std::unexpected{std::error_code(errno, std::system_category())};
+    }
+    if (n == 0) {
+      if (retried_zero) {
+        spw_rmap::debug::debug("Send returned zero twice, treating as error");
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+      }
+      pollfd pfd{.fd = fd, .events = POLLOUT, .revents = 0};
+      int prc = 0;
+      do {
+        prc = ::poll(&pfd, 1, 10);
+      } while (prc < 0 && errno == EINTR);
+      if (prc <= 0 || (pfd.revents & POLLOUT) == 0) {
+        spw_rmap::debug::debug("Socket not writable after zero-length send");
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+      }
+      retried_zero = true;
+      continue;
+    }
+
+    auto sent = static_cast<std::size_t>(n);
+    while (sent > 0) {
+      const auto left = buffers[index].size() - offset;
+      if (sent < left) {
+        offset += sent;
+        sent = 0;
+      } else {
+        sent -= left;
+        ++index;
+        offset = 0;
+      }
+    }
+  }
+}
+
+}  // namespace spw_rmap::internal
@@ -0,0 +1,50 @@
+#include "spw_rmap/spw_rmap_tcp_multi_server.hh"
+
+#include <iostream>
+#include <optional>
+
+#include "spw_rmap/crc.hh"
+#include "spw_rmap/internal/debug.hh"
+
+namespace spw_rmap {
+
+auto SpwRmapTCPMultiServer::start() noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  auto res = server_.start();
+  if (!res.has_value()) {
+    std::cerr << "Failed to start TCP server: " << res.error().message()
+              << "\n";
+  }
+  return res;
+}
+
+auto SpwRmapTCPMultiServer::handle_(std::span<const uint8_t> packet_bytes,
+                                    std::vector<uint8_t>& reply) const
+    -> bool {
+  PacketParser parser;
+  if (parser.parse(packet_bytes) != PacketParser::Status::Success) {
+    spw_rmap::debug::debug("Failed to parse received packet");
+    return false;
+  }
+  // Workers serve connections concurrently, so a target's view could
+  // change while it is copied; read through `RmapTarget::read` instead.
+  auto res = internal::serveCommand(
+      handlers_, parser.getPacket(), /*allow_view=*/false,
+      [&reply](std::size_t size, auto&& fill,
+               std::optional<std::span<const uint8_t>> payload)
+          -> std::expected<std::monostate, std::error_code> {
+        reply.resize(size + (payload.has_value() ? payload->size() + 1 : 0));
+        if (auto res = fill(std::span(reply).first(size)); !res.has_value()) {
+          reply.clear();
+          return std::unexpected{res.error()};
+        }
+        if (payload.has_value()) {
+          reply.back() = crc::copyAndCalcCRC(
+              *payload, std::span(reply).subspan(size));
+        }
+        return {};
+      });
+  return res.has_value();
+}
+
+}  // namespace spw_rmap
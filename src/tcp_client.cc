@@ -15,6 +15,7 @@
 #include <system_error>
 
 #include "spw_rmap/internal/debug.hh"
+#include "spw_rmap/internal/socket_io.hh"
 
 namespace spw_rmap::internal {
 
@@ -298,6 +299,12 @@ auto TCPClient::sendAll(std::span<const uint8_t> data) noexcept
   return {};
 }
 
+auto TCPClient::sendAllv(
+    std::span<const std::span<const uint8_t>> buffers) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  return internal::sendAllv(fd_, buffers);
+}
+
 auto TCPClient::recvSome(std::span<uint8_t> buf) noexcept
     -> std::expected<size_t, std::error_code> {
   if (buf.empty()) {
@@ -17,6 +17,7 @@
 #include <system_error>
 
 #include "spw_rmap/internal/debug.hh"
+#include "spw_rmap/internal/socket_io.hh"
 
 namespace spw_rmap::internal {
 
@@ -87,6 +88,10 @@ static inline auto gai_category() noexcept -> const std::error_category& {
 
 auto TCPServer::accept_once() noexcept
     -> std::expected<std::monostate, std::error_code> {
+  // The previous client, if any, is done with.
+  close_retry_(client_fd_);
+  client_fd_ = -1;
+
   addrinfo hints{};
   hints.ai_family = AF_UNSPEC;  // IPv4/IPv6 both
   hints.ai_socktype = SOCK_STREAM;
@@ -222,6 +227,12 @@ auto TCPServer::sendAll(std::span<const uint8_t> data) noexcept
   return {};
 }
 
+auto TCPServer::sendAllv(
+    std::span<const std::span<const uint8_t>> buffers) noexcept
+    -> std::expected<std::monostate, std::error_code> {
+  return internal::sendAllv(client_fd_, buffers);
+}
+
 auto TCPServer::recvSome(std::span<uint8_t> buf) noexcept
     -> std::expected<size_t, std::error_code> {
   if (buf.empty()) {
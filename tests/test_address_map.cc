@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <spw_rmap/address_map.hh>
+#include <spw_rmap/memory_target.hh>
+#include <spw_rmap/packet_parser.hh>
+#include <spw_rmap/spw_rmap_tcp_node.hh>
+#include <spw_rmap/target_node.hh>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using spw_rmap::PacketStatusCode;
+
+auto command(uint8_t extended_address, uint32_t address, uint32_t length)
+    -> spw_rmap::Packet {
+  return {.extendedAddress = extended_address,
+          .address = address,
+          .dataLength = length};
+}
+
+// Register block that answers every read with its own id.
+auto block(uint8_t id) -> std::shared_ptr<spw_rmap::RmapTarget> {
+  return std::make_shared<spw_rmap::CallbackTarget>(
+      spw_rmap::CallbackTarget::Callbacks{
+          .on_write = nullptr,
+          .on_read =
+              [id](const spw_rmap::Packet&, std::span<uint8_t> data) {
+                std::ranges::fill(data, id);
+                return PacketStatusCode::CommandExecutedSuccessfully;
+              },
+          .on_read_modify_write = nullptr,
+      });
+}
+
+auto readFrom(spw_rmap::AddressMap& map, uint8_t extended_address,
+              uint32_t address, uint32_t length = 4)
+    -> std::pair<PacketStatusCode, uint8_t> {
+  std::vector<uint8_t> data(length, 0xEE);
+  const auto status =
+      map.read(command(extended_address, address, length), data);
+  return {status, data.front()};
+}
+
+TEST(AddressMap, RoutesCommandsToTheRangeTheyFallIn) {
+  spw_rmap::AddressMap map;
+  std::vector<spw_rmap::AddressRoute> routes;
+  for (uint8_t i = 0; i < 200; ++i) {
+    routes.push_back({.extended_address = 0,
+                      .address = 0x1000U * (200U - i),
+                      .size = 0x100,
+                      .target = block(i)});
+  }
+  routes.push_back(
+      {.extended_address = 1, .address = 0, .size = 0x100, .target = block(7)});
+  ASSERT_TRUE(map.assign(routes).has_value());
+  EXPECT_EQ(map.size(), 201U);
+
+  constexpr auto kOk = PacketStatusCode::CommandExecutedSuccessfully;
+  constexpr auto kDenied =
+      PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised;
+  EXPECT_EQ(readFrom(map, 0, 0x1000), std::pair(kOk, uint8_t{199}));
+  EXPECT_EQ(readFrom(map, 0, 0x10FC), std::pair(kOk, uint8_t{199}));
+  EXPECT_EQ(readFrom(map, 0, 0x64000), std::pair(kOk, uint8_t{100}));
+  EXPECT_EQ(readFrom(map, 0, 0xC8000), std::pair(kOk, uint8_t{0}));
+  EXPECT_EQ(readFrom(map, 1, 0x0000), std::pair(kOk, uint8_t{7}));
+  // Outside every range, or running past the end of one.
+  EXPECT_EQ(readFrom(map, 0, 0x0000).first, kDenied);
+  EXPECT_EQ(readFrom(map, 0, 0x1100).first, kDenied);
+  EXPECT_EQ(readFrom(map, 0, 0x10FE).first, kDenied);
+  EXPECT_EQ(readFrom(map, 2, 0x1000).first, kDenied);
+  // Routed, but the block has no write handler.
+  const std::array<uint8_t, 4> value{};
+  auto write = command(0, 0x1000, 4);
+  write.data = value;
+  EXPECT_EQ(map.write(write), kDenied);
+}
+
+TEST(AddressMap, RejectedChangesKeepTheRoutesAsTheyWere) {
+  spw_rmap::AddressMap map;
+  EXPECT_EQ(readFrom(map, 0, 0).first,
+            PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised);
+  ASSERT_TRUE(
+      map.add({.address = 0x100, .size = 0x100, .target = block(1)})
+          .has_value());
+  EXPECT_FALSE(
+      map.add({.address = 0x180, .size = 0x100, .target = block(2)})
+          .has_value());
+  EXPECT_FALSE(
+      map.add({.address = 0x000, .size = 0x101, .target = block(2)})
+          .has_value());
+  EXPECT_FALSE(
+      map.add({.address = 0x300, .size = 0, .target = block(2)}).has_value());
+  EXPECT_FALSE(map.add({.address = 0x300, .size = 0x100}).has_value());
+  EXPECT_FALSE(map.assign({{.address = 0, .size = 0x10, .target = block(3)},
+                           {.address = 8, .size = 0x10, .target = block(3)}})
+                   .has_value());
+  EXPECT_FALSE(map.remove(0, 0x180).has_value());
+  EXPECT_EQ(map.size(), 1U);
+  EXPECT_EQ(readFrom(map, 0, 0x100).second, 1);
+
+  ASSERT_TRUE(
+      map.add({.address = 0x200, .size = 0x100, .target = block(2)})
+          .has_value());
+  ASSERT_TRUE(map.remove(0, 0x100).has_value());
+  EXPECT_EQ(readFrom(map, 0, 0x100).first,
+            PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised);
+  EXPECT_EQ(readFrom(map, 0, 0x200).second, 2);
+}
+
+TEST(AddressMap, RoutesToMemoryTargets) {
+  auto low = std::make_shared<spw_rmap::MemoryTarget>();
+  auto high = std::make_shared<spw_rmap::MemoryTarget>();
+  ASSERT_TRUE(low->addRegion({.address = 0, .size = 0x1000}).has_value());
+  ASSERT_TRUE(
+      high->addRegion({.address = 0x80000000, .size = 0x1000}).has_value());
+  spw_rmap::AddressMap map;
+  ASSERT_TRUE(map.assign({{.address = 0, .size = 0x1000, .target = low},
+                          {.address = 0x80000000,
+                           .size = 0x1000,
+                           .target = high}})
+                  .has_value());
+  const std::array<uint8_t, 2> value{0x5A, 0xA5};
+  auto write = command(0, 0x80000010, 2);
+  write.data = value;
+  EXPECT_EQ(map.write(write), PacketStatusCode::CommandExecutedSuccessfully);
+  EXPECT_TRUE(std::ranges::equal(high->view(0, 0x80000010, 2), value));
+  EXPECT_TRUE(std::ranges::equal(low->view(0, 0x10, 2),
+                                 std::array<uint8_t, 2>{}));
+}
+
+#ifdef __linux__
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) {
+    return {};
+  }
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  std::string port;
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+             sizeof(sin)) == 0 &&
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                    &sl) == 0) {
+    port = std::to_string(ntohs(sin.sin_port));
+  }
+  ::close(fd);
+  return port;
+}
+
+TEST(AddressMap, CanBeRebuiltWhileTheServerRuns) {
+  const auto port = pickFreePort();
+  if (port.empty()) {
+    GTEST_SKIP() << "Loopback sockets are not available";
+  }
+  auto map = std::make_shared<spw_rmap::AddressMap>();
+  ASSERT_TRUE(
+      map->add({.address = 0x0000, .size = 0x100, .target = block(1)})
+          .has_value());
+  spw_rmap::SpwRmapTCPServer server(
+      {.ip_address = "127.0.0.1", .port = port});
+  server.registerTarget(map);
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+  spw_rmap::SpwRmapTCPClient client(
+      {.ip_address = "127.0.0.1", .port = port});
+  bool connected = false;
+  for (int attempt = 0; attempt < 100 && !connected; ++attempt) {
+    connected = client.connect(100ms).has_value();
+    if (!connected) {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  ASSERT_TRUE(connected);
+  std::thread client_thread([&client] { std::ignore = client.runLoop(); });
+
+  // Blocks come and go at 0x1000 while the block at 0 keeps answering.
+  std::atomic<bool> done{false};
+  std::thread remapper([&map, &done] {
+    for (uint8_t i = 0; !done.load(); ++i) {
+      std::ignore = map->add(
+          {.address = 0x1000, .size = 0x100, .target = block(i)});
+      std::ignore = map->remove(0, 0x1000);
+    }
+  });
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+  std::array<uint8_t, 16> data{};
+  std::size_t failures = 0;
+  for (int i = 0; i < 500; ++i) {
+    if (!client.read(target, 0x10, data, 1s).has_value() || data[0] != 1) {
+      ++failures;
+    }
+  }
+  done.store(true);
+  remapper.join();
+  EXPECT_EQ(failures, 0U);
+  EXPECT_EQ(map->size(), 1U);
+
+  std::ignore = client.shutdown();
+  client_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+}
+
+#endif  // __linux__
+
+}  // namespace
@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <spw_rmap/spw_rmap_tcp_node.hh>
+#include <spw_rmap/target_node.hh>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  ::bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin));  // NOLINT
+  ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &sl);   // NOLINT
+  ::close(fd);
+  return std::to_string(ntohs(sin.sin_port));
+}
+
+// Loopback target backed by `memory`, with a client connected to it that
+// has `transaction_ids` IDs.
+class Loopback {
+ public:
+  explicit Loopback(std::size_t memory_size, uint32_t transaction_ids = 0x20)
+      : port_(pickFreePort()),
+        memory_(memory_size),
+        server_({.ip_address = "127.0.0.1", .port = port_}),
+        client_({.ip_address = "127.0.0.1",
+                 .port = port_,
+                 .transaction_id_min = 0x0020,
+                 .transaction_id_max = 0x0020 + transaction_ids}) {
+    server_.registerOnWrite([this](spw_rmap::Packet packet) {
+      if (on_write_) {
+        on_write_(packet);
+      }
+      std::lock_guard<std::mutex> lock(mtx_);
+      std::ranges::copy(packet.data, memory_.begin() + packet.address);
+    });
+    server_.registerOnRead([this](spw_rmap::Packet packet) {
+      reads_.fetch_add(1);
+      std::lock_guard<std::mutex> lock(mtx_);
+      const auto first = memory_.begin() + packet.address;
+      return std::vector<uint8_t>(
+          first, first + (packet.address == short_read_address_
+                              ? packet.dataLength - 1
+                              : packet.dataLength));
+    });
+    server_thread_ = std::thread([this] {
+      if (server_.acceptOnce().has_value()) {
+        std::ignore = server_.runLoop();
+      }
+    });
+    for (int attempt = 0; attempt < 100 && !connected_; ++attempt) {
+      connected_ = client_.connect(100ms).has_value();
+      if (!connected_) {
+        std::this_thread::sleep_for(10ms);
+      }
+    }
+    if (connected_) {
+      client_thread_ = std::thread([this] { std::ignore = client_.runLoop(); });
+    }
+  }
+
+  Loopback(const Loopback&) = delete;
+  auto operator=(const Loopback&) -> Loopback& = delete;
+
+  ~Loopback() {
+    std::ignore = client_.shutdown();
+    if (client_thread_.joinable()) {
+      client_thread_.join();
+    }
+    std::ignore = server_.shutdown();
+    server_thread_.join();
+  }
+
+  [[nodiscard]] auto connected() const -> bool { return connected_; }
+  auto client() -> spw_rmap::SpwRmapTCPClient& { return client_; }
+
+  auto memory() -> std::vector<uint8_t> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return memory_;
+  }
+
+  // Read commands the target has served.
+  [[nodiscard]] auto reads() const -> int { return reads_.load(); }
+
+  // Called by the server thread before each write is applied.
+  void onWrite(std::function<void(const spw_rmap::Packet&)> on_write) {
+    on_write_ = std::move(on_write);
+  }
+
+  // Reads of this address get a reply one byte short.
+  void shortReadAt(uint32_t address) { short_read_address_ = address; }
+
+ private:
+  std::string port_;
+  std::mutex mtx_;
+  std::vector<uint8_t> memory_;
+  std::function<void(const spw_rmap::Packet&)> on_write_;
+  uint32_t short_read_address_ = 0xFFFFFFFF;
+  std::atomic<int> reads_{0};
+  spw_rmap::SpwRmapTCPServer server_;
+  spw_rmap::SpwRmapTCPClient client_;
+  bool connected_ = false;
+  std::thread server_thread_;
+  std::thread client_thread_;
+};
+
+auto makeTarget() -> std::shared_ptr<spw_rmap::TargetNodeBase> {
+  return std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+}
+
+auto makePattern(std::size_t size) -> std::vector<uint8_t> {
+  std::vector<uint8_t> pattern(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    pattern[i] = static_cast<uint8_t>(i * 31 + i / 251);
+  }
+  return pattern;
+}
+
+TEST(BulkTransfer, WritesAndReadsBackUnevenRegion) {
+  Loopback loopback(64 * 1024);
+  ASSERT_TRUE(loopback.connected());
+  const auto pattern = makePattern(50'001);
+
+  ASSERT_TRUE(loopback.client()
+                  .bulkWrite(makeTarget(), 0x100, pattern, 1000, 8)
+                  .has_value());
+  const auto memory = loopback.memory();
+  EXPECT_TRUE(std::equal(pattern.begin(), pattern.end(),
+                         memory.begin() + 0x100));
+
+  std::vector<uint8_t> readback(pattern.size());
+  ASSERT_TRUE(loopback.client()
+                  .bulkRead(makeTarget(), 0x100, readback, 777, 16)
+                  .has_value());
+  EXPECT_EQ(readback, pattern);
+}
+
+TEST(BulkTransfer, RetriesOnlyTheChunkThatTimedOut) {
+  Loopback loopback(16 * 1024);
+  ASSERT_TRUE(loopback.connected());
+  const auto pattern = makePattern(16 * 1024);
+  std::vector<std::atomic<int>> received(16);
+  loopback.onWrite([&received](const spw_rmap::Packet& packet) {
+    // Sit on the first copy of chunk 5 past its deadline.
+    if (received[packet.address / 1024].fetch_add(1) == 0 &&
+        packet.address == 5 * 1024) {
+      std::this_thread::sleep_for(300ms);
+    }
+  });
+  loopback.client().setTimeout(100ms);
+
+  ASSERT_TRUE(loopback.client()
+                  .bulkWrite(makeTarget(), 0, pattern, 1024, 4, 5)
+                  .has_value());
+  EXPECT_GE(received[5].load(), 2);
+  EXPECT_EQ(received[0].load(), 1);
+  // The late reply to chunk 5 may complete the chunk that reused its ID
+  // before that chunk's write is applied, so give the server time to
+  // catch up.
+  for (int attempt = 0; attempt < 100 && loopback.memory() != pattern;
+       ++attempt) {
+    std::this_thread::sleep_for(10ms);
+  }
+  EXPECT_EQ(loopback.memory(), pattern);
+}
+
+TEST(BulkTransfer, WaitsForAFreeTransactionIdBeforeRetrying) {
+  Loopback loopback(16 * 1024, 4);
+  ASSERT_TRUE(loopback.connected());
+  loopback.onWrite([](const spw_rmap::Packet& packet) {
+    if (packet.address == 0x3000) {
+      std::this_thread::sleep_for(50ms);
+    }
+  });
+
+  // Two of the four IDs stay taken for 100 ms, so half of the first window
+  // finds none; retrying those at once would use up their attempts.
+  const std::array<uint8_t, 4> value{1, 2, 3, 4};
+  auto first = loopback.client().writeAsync(makeTarget(), 0x3000, value,
+                                            [](spw_rmap::Packet) {});
+  auto second = loopback.client().writeAsync(makeTarget(), 0x3000, value,
+                                             [](spw_rmap::Packet) {});
+  const auto pattern = makePattern(8 * 1024);
+  ASSERT_TRUE(loopback.client()
+                  .bulkWrite(makeTarget(), 0, pattern, 1024, 4, 2)
+                  .has_value());
+  EXPECT_TRUE(first.get().has_value());
+  EXPECT_TRUE(second.get().has_value());
+  const auto memory = loopback.memory();
+  EXPECT_TRUE(std::equal(pattern.begin(), pattern.end(), memory.begin()));
+}
+
+TEST(BulkTransfer, StopsOnAPermanentFailure) {
+  Loopback loopback(8 * 1024);
+  ASSERT_TRUE(loopback.connected());
+  loopback.shortReadAt(3 * 512);
+
+  std::vector<uint8_t> readback(8 * 1024);
+  auto res = loopback.client().bulkRead(makeTarget(), 0, readback, 512, 4);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), std::make_error_code(std::errc::bad_message));
+}
+
+TEST(BulkTransfer, RejectsARegionPastTheEndOfTheAddressSpace) {
+  Loopback loopback(1024);
+  ASSERT_TRUE(loopback.connected());
+  std::atomic<int> writes{0};
+  loopback.onWrite([&writes](const spw_rmap::Packet&) { ++writes; });
+
+  const auto pattern = makePattern(512);
+  auto res = loopback.client().bulkWrite(makeTarget(), 0xFFFFFF00, pattern,
+                                         128, 4);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), std::make_error_code(std::errc::invalid_argument));
+  std::vector<uint8_t> readback(257);
+  res = loopback.client().bulkRead(makeTarget(), 0xFFFFFF00, readback);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), std::make_error_code(std::errc::invalid_argument));
+  EXPECT_EQ(writes.load(), 0);
+}
+
+TEST(TransferMany, MergesAdjacentRegistersIntoFewerTransactions) {
+  Loopback loopback(4096);
+  ASSERT_TRUE(loopback.connected());
+  std::atomic<int> writes{0};
+  loopback.onWrite([&writes](const spw_rmap::Packet&) { ++writes; });
+  const std::vector<uint8_t> a{1, 2, 3, 4};
+  const std::vector<uint8_t> b{5, 6, 7, 8};
+  const std::vector<uint8_t> c{9, 10};
+  const std::vector<spw_rmap::WriteRequest> writes_list{
+      {.memory_address = 0x204, .data = b},
+      {.memory_address = 0x800, .data = c},
+      {.memory_address = 0x200, .data = a},
+      {.memory_address = 0x900, .data = {}},
+  };
+  ASSERT_TRUE(loopback.client()
+                  .writeMany(makeTarget(), writes_list, {},
+                             /*merge_adjacent=*/true)
+                  .has_value());
+  EXPECT_EQ(writes.load(), 2);
+
+  std::array<uint8_t, 4> low{};
+  std::array<uint8_t, 4> high{};
+  std::array<uint8_t, 2> overlapping{};
+  std::array<uint8_t, 2> far{};
+  const std::vector<spw_rmap::ReadRequest> reads{
+      {.memory_address = 0x200, .data = low},
+      {.memory_address = 0x802, .data = {}},
+      {.memory_address = 0x800, .data = far},
+      {.memory_address = 0x206, .data = overlapping},
+      {.memory_address = 0x204, .data = high},
+  };
+  std::vector<std::error_code> results(reads.size(),
+                                       std::make_error_code(
+                                           std::errc::io_error));
+  ASSERT_TRUE(loopback.client()
+                  .readMany(makeTarget(), reads, results,
+                            /*merge_adjacent=*/true)
+                  .has_value());
+  // Overlapping reads are never merged; they may read registers with side
+  // effects twice.
+  EXPECT_EQ(loopback.reads(), 3);
+  EXPECT_EQ(low, (std::array<uint8_t, 4>{1, 2, 3, 4}));
+  EXPECT_EQ(high, (std::array<uint8_t, 4>{5, 6, 7, 8}));
+  EXPECT_EQ(overlapping, (std::array<uint8_t, 2>{7, 8}));
+  EXPECT_EQ(far, (std::array<uint8_t, 2>{9, 10}));
+  for (const auto& result : results) {
+    EXPECT_FALSE(result);
+  }
+}
+
+TEST(TransferMany, ReportsEachRequestSeparately) {
+  Loopback loopback(4096);
+  ASSERT_TRUE(loopback.connected());
+  loopback.shortReadAt(0x100);
+
+  std::vector<std::array<uint8_t, 4>> buffers(3);
+  const std::vector<spw_rmap::ReadRequest> reads{
+      {.memory_address = 0x000, .data = buffers[0]},
+      {.memory_address = 0x100, .data = buffers[1]},
+      {.memory_address = 0x104, .data = buffers[2]},
+  };
+  std::vector<std::error_code> results(reads.size());
+  // Not merged by default, although the last two continue each other.
+  auto res = loopback.client().readMany(makeTarget(), reads, results);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), std::make_error_code(std::errc::bad_message));
+  EXPECT_EQ(loopback.reads(), 3);
+  EXPECT_FALSE(results[0]);
+  EXPECT_EQ(results[1], std::make_error_code(std::errc::bad_message));
+  EXPECT_FALSE(results[2]);
+
+  std::vector<std::error_code> too_few(1);
+  auto mismatched = loopback.client().readMany(makeTarget(), reads, too_few);
+  ASSERT_FALSE(mismatched.has_value());
+  EXPECT_EQ(mismatched.error(),
+            std::make_error_code(std::errc::invalid_argument));
+}
+
+}  // namespace
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <spw_rmap/completion_queue.hh>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using spw_rmap::CompletionQueue;
+using spw_rmap::RmapCompletion;
+
+TEST(CompletionQueue, ReservesNoMoreThanItsCapacity) {
+  CompletionQueue queue(6);
+  EXPECT_EQ(queue.capacity(), 8U);
+  EXPECT_EQ(queue.reserve(5), 5U);
+  EXPECT_EQ(queue.reserve(5), 3U);
+  EXPECT_EQ(queue.reserve(1), 0U);
+  EXPECT_EQ(queue.outstanding(), 8U);
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    queue.push({.user_data = i, .status = static_cast<uint8_t>(i)});
+  }
+  std::array<RmapCompletion, 2> out{};
+  ASSERT_EQ(queue.reap(out), 2U);
+  EXPECT_EQ(out[0].user_data, 0U);
+  EXPECT_EQ(out[1].user_data, 1U);
+  EXPECT_EQ(out[1].status, 1U);
+  EXPECT_EQ(queue.outstanding(), 6U);
+  EXPECT_EQ(queue.reserve(5), 2U);
+}
+
+TEST(CompletionQueue, ReapNeverWaitsForMoreThanOutstanding) {
+  CompletionQueue queue(4);
+  std::array<RmapCompletion, 4> out{};
+  EXPECT_EQ(queue.reap(out, 4), 0U);
+  ASSERT_EQ(queue.reserve(1), 1U);
+  queue.push({.user_data = 7});
+  ASSERT_EQ(queue.reap(out, 4), 1U);
+  EXPECT_EQ(out[0].user_data, 7U);
+}
+
+TEST(CompletionQueue, DeliversEveryCompletionFromManyProducers) {
+  constexpr std::size_t kProducers = 4;
+  constexpr std::size_t kPerProducer = 20'000;
+  CompletionQueue queue(256);
+  std::vector<std::size_t> per_producer(kProducers, 0);
+  std::atomic<std::size_t> reserved{0};
+
+  // The consumer reserves room, as `submit` does, and hands it out.
+  std::vector<std::thread> producers;
+  std::array<std::atomic<std::size_t>, kProducers> budget{};
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (std::size_t i = 0; i < kPerProducer; ++i) {
+        while (budget[p].load(std::memory_order_acquire) == 0) {
+          std::this_thread::yield();
+        }
+        budget[p].fetch_sub(1, std::memory_order_acq_rel);
+        queue.push({.user_data = (p << 32) | i});
+      }
+    });
+  }
+  std::array<RmapCompletion, 64> out{};
+  std::size_t reaped = 0;
+  std::size_t next = 0;
+  while (reaped < kProducers * kPerProducer) {
+    while (reserved.load() < kProducers * kPerProducer) {
+      if (queue.reserve(1) == 0) {
+        break;
+      }
+      budget[next++ % kProducers].fetch_add(1, std::memory_order_acq_rel);
+      reserved.fetch_add(1);
+    }
+    const auto count = queue.reap(out, 1);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto p = out[i].user_data >> 32;
+      ASSERT_LT(p, kProducers);
+      EXPECT_EQ(out[i].user_data & 0xFFFFFFFF, per_producer[p]);
+      ++per_producer[p];
+    }
+    reaped += count;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(queue.outstanding(), 0U);
+}
+
+}  // namespace
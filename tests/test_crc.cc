@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "spw_rmap/crc.hh"
+
+namespace {
+
+using spw_rmap::crc::Kernel;
+
+constexpr std::array<Kernel, 4> kKernels = {
+    Kernel::Reference, Kernel::Slicing8, Kernel::Slicing16,
+    Kernel::CarrylessMultiply};
+
+auto randomBytes(std::size_t size) -> std::vector<uint8_t> {
+  static std::mt19937 gen(std::random_device{}());
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(dist(gen));
+  }
+  return data;
+}
+
+TEST(Crc, KnownValues) {
+  const std::array<uint8_t, 1> one{0x01};
+  for (auto kernel : kKernels) {
+    EXPECT_EQ(spw_rmap::crc::calcCRCWith(kernel, one), 0x91);
+  }
+  const std::array<uint8_t, 0> empty{};
+  EXPECT_EQ(spw_rmap::crc::calcCRC(empty, 0x5A), 0x5A);
+}
+
+static_assert(spw_rmap::crc::calcCRC(std::array<uint8_t, 1>{0x01}) == 0x91);
+static_assert(spw_rmap::crc::calcCRC(std::array<uint8_t, 2>{0x01, 0x91}) ==
+              0x00);
+
+TEST(Crc, ConstexprMatchesRuntime) {
+  auto data = randomBytes(257);
+  uint8_t expected = 0x00;
+  for (auto byte : data) {
+    expected = spw_rmap::crc::CRC_LOOKUP_TABLE[expected ^ byte];
+  }
+  EXPECT_EQ(spw_rmap::crc::calcCRC(data), expected);
+}
+
+TEST(Crc, KernelsMatchReference) {
+  for (std::size_t size : {0UL, 1UL, 7UL, 8UL, 15UL, 16UL, 17UL, 63UL, 64UL,
+                           65UL, 127UL, 128UL, 200UL, 1023UL, 4096UL,
+                           65537UL}) {
+    const auto data = randomBytes(size + 3);
+    for (std::size_t offset = 0; offset < 3; ++offset) {
+      const auto input = std::span(data).subspan(offset, size);
+      for (uint8_t seed : {0x00, 0x5A, 0xFF}) {
+        const auto expected =
+            spw_rmap::crc::calcCRCWith(Kernel::Reference, input, seed);
+        for (auto kernel : kKernels) {
+          EXPECT_EQ(spw_rmap::crc::calcCRCWith(kernel, input, seed), expected)
+              << spw_rmap::crc::getKernelName(kernel) << " size=" << size
+              << " offset=" << offset;
+        }
+        EXPECT_EQ(spw_rmap::crc::calcCRC(input, seed), expected);
+      }
+    }
+  }
+}
+
+TEST(Crc, ChainedEqualsWhole) {
+  const auto data = randomBytes(1000);
+  const auto whole = spw_rmap::crc::calcCRC(data);
+  const auto first = spw_rmap::crc::calcCRC(std::span(data).first(333));
+  EXPECT_EQ(spw_rmap::crc::calcCRC(std::span(data).subspan(333), first), whole);
+}
+
+TEST(Crc, CopyAndCalcMatchesTwoPass) {
+  for (std::size_t size : {0UL, 5UL, 16UL, 64UL, 100UL, 1000UL, 65536UL}) {
+    const auto src = randomBytes(size);
+    const auto expected = spw_rmap::crc::calcCRC(src, 0x21);
+    for (auto kernel : kKernels) {
+      std::vector<uint8_t> dst(size + 1, 0xEE);
+      EXPECT_EQ(spw_rmap::crc::copyAndCalcCRCWith(kernel, src, dst, 0x21),
+                expected)
+          << spw_rmap::crc::getKernelName(kernel) << " size=" << size;
+      EXPECT_TRUE(std::equal(src.begin(), src.end(), dst.begin()));
+      EXPECT_EQ(dst.back(), 0xEE);
+    }
+    std::vector<uint8_t> dst(size);
+    EXPECT_EQ(spw_rmap::crc::copyAndCalcCRC(src, dst, 0x21), expected);
+    EXPECT_EQ(dst, src);
+  }
+}
+
+TEST(Crc, AccumulatorMatchesWhole) {
+  auto data = randomBytes(777);
+  spw_rmap::crc::CRCAccumulator accumulator;
+  for (std::size_t offset = 0; offset < data.size(); offset += 100) {
+    accumulator.update(
+        std::span(data).subspan(offset, std::min<std::size_t>(
+                                            100, data.size() - offset)));
+  }
+  EXPECT_EQ(accumulator.value(), spw_rmap::crc::calcCRC(data));
+
+  // Appending the CRC itself leaves a zero remainder.
+  data.push_back(accumulator.value());
+  accumulator.reset();
+  accumulator.update(data);
+  EXPECT_EQ(accumulator.value(), 0x00);
+}
+
+TEST(Crc, ActiveKernelIsSupported) {
+  EXPECT_TRUE(spw_rmap::crc::isKernelSupported(
+      spw_rmap::crc::getActiveKernel()));
+}
+
+}  // namespace
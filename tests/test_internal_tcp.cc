@@ -4,12 +4,14 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <random>
 #include <span>
+#include <spw_rmap/internal/socket_io.hh>
 #include <spw_rmap/internal/tcp_client.hh>
 #include <spw_rmap/internal/tcp_server.hh>
 #include <string>
@@ -222,3 +224,43 @@ TEST(TcpClientServer, ClientRecieve) {
   EXPECT_FALSE(server_emit_error)
       << "Server thread emitted an error during execution.";
 }
+
+TEST(SocketIo, SendAllvDeliversBuffersInOrder) {
+  std::array<int, 2> fds{};
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+  // A small send buffer forces partial writes that end mid-iovec.
+  const int sndbuf = 4096;
+  (void)::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<std::vector<uint8_t>> chunks;
+  std::vector<uint8_t> expected;
+  for (std::size_t i = 0; i < 40; ++i) {
+    // Includes empty chunks and more chunks than one sendmsg takes.
+    auto& chunk = chunks.emplace_back((i % 7) * 9973);
+    for (auto& b : chunk) {
+      b = static_cast<uint8_t>(byte(rng));
+    }
+    expected.insert(expected.end(), chunk.begin(), chunk.end());
+  }
+  std::vector<std::span<const uint8_t>> buffers(chunks.begin(), chunks.end());
+
+  std::vector<uint8_t> received;
+  std::thread reader([&]() -> void {
+    std::vector<uint8_t> buf(3000);
+    while (received.size() < expected.size()) {
+      const auto n = ::recv(fds[1], buf.data(), buf.size(), 0);
+      if (n <= 0) {
+        break;
+      }
+      received.insert(received.end(), buf.begin(), buf.begin() + n);
+    }
+  });
+  auto res = spw_rmap::internal::sendAllv(fds[0], buffers);
+  reader.join();
+  (void)::close(fds[0]);
+  (void)::close(fds[1]);
+
+  ASSERT_TRUE(res.has_value()) << res.error().message();
+  EXPECT_EQ(received, expected);
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <spw_rmap/internal/io_uring_client.hh>
+#include <spw_rmap/spw_rmap_io_uring_node.hh>
+#include <spw_rmap/spw_rmap_tcp_node.hh>
+#include <spw_rmap/target_node.hh>
+#include <string>
+#include <thread>
+#include <vector>
+
+using spw_rmap::internal::IoUringClient;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Listening socket on 127.0.0.1 with a kernel-assigned port.
+class Listener {
+ public:
+  Listener() {
+    fd_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd_ < 0) {
+      return;
+    }
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sin.sin_port = htons(0);
+    socklen_t sl = sizeof(sin);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+               sizeof(sin)) != 0 ||
+        ::listen(fd_, 1) != 0 ||
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                      &sl) != 0) {
+      ::close(fd_);
+      fd_ = -1;
+      return;
+    }
+    port_ = ntohs(sin.sin_port);
+  }
+
+  Listener(const Listener&) = delete;
+  auto operator=(const Listener&) -> Listener& = delete;
+
+  ~Listener() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  [[nodiscard]] auto ok() const -> bool { return fd_ >= 0; }
+  [[nodiscard]] auto port() const -> std::string {
+    return std::to_string(port_);
+  }
+  [[nodiscard]] auto accept() const -> int {
+    return ::accept(fd_, nullptr, nullptr);
+  }
+
+ private:
+  int fd_ = -1;
+  uint16_t port_ = 0;
+};
+
+auto pickFreePort() -> std::string {
+  Listener listener;
+  return listener.ok() ? listener.port() : std::string{};
+}
+
+TEST(IoUringClient, SendAndReceiveOverLoopback) {
+  if (!IoUringClient::isSupported()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  Listener listener;
+  if (!listener.ok()) {
+    GTEST_SKIP() << "Loopback sockets are not available";
+  }
+
+  IoUringClient client("127.0.0.1", listener.port());
+  ASSERT_TRUE(client.connect(1s).has_value());
+  ASSERT_TRUE(client.setSendTimeout(500ms).has_value());
+  const int peer = listener.accept();
+  ASSERT_GE(peer, 0);
+
+  // Client to peer: many buffers, some empty, more than one sendmsg worth.
+  std::vector<std::vector<uint8_t>> chunks;
+  std::vector<uint8_t> expected;
+  for (size_t i = 0; i < 40; ++i) {
+    auto& chunk = chunks.emplace_back((i % 7 == 3) ? 0 : 100 + i * 37);
+    std::iota(chunk.begin(), chunk.end(), static_cast<uint8_t>(i));
+    expected.insert(expected.end(), chunk.begin(), chunk.end());
+  }
+  std::vector<std::span<const uint8_t>> spans(chunks.begin(), chunks.end());
+  ASSERT_TRUE(client.sendAllv(spans).has_value());
+
+  std::vector<uint8_t> received(expected.size());
+  size_t got = 0;
+  while (got < received.size()) {
+    const auto n = ::recv(peer, received.data() + got, received.size() - got, 0);
+    ASSERT_GT(n, 0);
+    got += static_cast<size_t>(n);
+  }
+  EXPECT_EQ(received, expected);
+
+  // Peer to client: more data than all provided buffers together, so the
+  // buffers have to be recycled and the receive re-armed.
+  std::vector<uint8_t> payload(600 * 1024);
+  std::iota(payload.begin(), payload.end(), static_cast<uint8_t>(7));
+  std::thread sender([&] {
+    size_t sent = 0;
+    while (sent < payload.size()) {
+      const auto n =
+          ::send(peer, payload.data() + sent, payload.size() - sent, 0);
+      if (n <= 0) {
+        return;
+      }
+      sent += static_cast<size_t>(n);
+    }
+    ::shutdown(peer, SHUT_WR);
+  });
+  std::vector<uint8_t> incoming(payload.size());
+  size_t offset = 0;
+  std::array<uint8_t, 1500> scratch{};
+  while (offset < incoming.size()) {
+    auto res = client.recvSome(scratch);
+    ASSERT_TRUE(res.has_value()) << res.error().message();
+    ASSERT_LE(offset + *res, incoming.size());
+    std::copy_n(scratch.begin(), *res, incoming.begin() + offset);
+    offset += *res;
+  }
+  sender.join();
+  EXPECT_EQ(incoming, payload);
+
+  // The peer closed its side, which ends the stream.
+  EXPECT_FALSE(client.recvSome(scratch).has_value());
+  ::close(peer);
+}
+
+TEST(IoUringClient, NodeWritesAndReadsThroughServer) {
+  if (!spw_rmap::SpwRmapIoUringClient::isSupported()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  const auto port = pickFreePort();
+  if (port.empty()) {
+    GTEST_SKIP() << "Loopback sockets are not available";
+  }
+
+  std::array<uint8_t, 256> memory{};
+  spw_rmap::SpwRmapTCPServer server(
+      {.ip_address = "127.0.0.1", .port = port});
+  server.registerOnWrite([&memory](spw_rmap::Packet packet) {
+    std::ranges::copy(packet.data, memory.begin() + packet.address);
+  });
+  server.registerOnRead([&memory](spw_rmap::Packet packet) {
+    const auto first = memory.begin() + packet.address;
+    return std::vector<uint8_t>(first, first + packet.dataLength);
+  });
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+
+  spw_rmap::SpwRmapIoUringClient client(
+      {.ip_address = "127.0.0.1", .port = port});
+  bool connected = false;
+  for (int attempt = 0; attempt < 100 && !connected; ++attempt) {
+    connected = client.connect(100ms).has_value();
+    if (!connected) {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  ASSERT_TRUE(connected);
+  std::thread client_thread([&client] { std::ignore = client.runLoop(); });
+
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+  std::vector<uint8_t> data(64);
+  std::iota(data.begin(), data.end(), static_cast<uint8_t>(0x40));
+  for (uint32_t round = 0; round < 16; ++round) {
+    ASSERT_TRUE(client.write(target, round * 4, data).has_value());
+    std::vector<uint8_t> readback(data.size());
+    ASSERT_TRUE(client.read(target, round * 4, readback).has_value());
+    EXPECT_EQ(readback, data);
+  }
+
+  ASSERT_TRUE(client.shutdown().has_value());
+  client_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+}
+
+}  // namespace
+
+#endif  // __linux__
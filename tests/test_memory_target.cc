@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <spw_rmap/crc.hh>
+#include <spw_rmap/memory_target.hh>
+#include <spw_rmap/packet_builder.hh>
+#include <spw_rmap/packet_parser.hh>
+#include <spw_rmap/rmap_packet_type.hh>
+#include <spw_rmap/spw_rmap_tcp_node.hh>
+#include <spw_rmap/target_node.hh>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <spw_rmap/spw_rmap_tcp_multi_server.hh>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using spw_rmap::PacketStatusCode;
+
+auto command(uint8_t extended_address, uint32_t address,
+             std::span<const uint8_t> data) -> spw_rmap::Packet {
+  return {.extendedAddress = extended_address,
+          .address = address,
+          .dataLength = static_cast<uint32_t>(data.size()),
+          .data = data};
+}
+
+// An RMW command: a write command with the write bit cleared, carrying
+// `value` followed by `mask`.
+auto rmwCommand(uint16_t transaction_id, uint32_t address,
+                std::span<const uint8_t> value, std::span<const uint8_t> mask)
+    -> std::vector<uint8_t> {
+  std::vector<uint8_t> data(value.begin(), value.end());
+  data.insert(data.end(), mask.begin(), mask.end());
+  auto config = spw_rmap::WritePacketConfig{
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = transaction_id,
+      .address = address,
+      .data = data,
+  };
+  spw_rmap::WritePacketBuilder builder;
+  std::vector<uint8_t> packet(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, packet).has_value());
+  packet[2] &= ~std::to_underlying(spw_rmap::RMAPCommandCode::Write);
+  packet[15] = spw_rmap::crc::calcCRC(std::span(packet).first(15));
+  return packet;
+}
+
+TEST(MemoryTarget, RejectsOverlappingAndOutOfRangeRegions) {
+  spw_rmap::MemoryTarget memory;
+  auto add = [&memory](spw_rmap::MemoryRegionConfig config) {
+    return memory.addRegion(config).has_value();
+  };
+  ASSERT_TRUE(add({.address = 0x1000, .size = 0x1000}));
+  EXPECT_FALSE(add({.address = 0x1800, .size = 0x1000}));
+  EXPECT_FALSE(add({.address = 0x0800, .size = 0x1000}));
+  EXPECT_FALSE(add({.address = 0x3000, .size = 0}));
+  EXPECT_FALSE(add({.address = 0xFFFFF000, .size = 0x2000}));
+  // Adjacent regions and the same range under another extended address.
+  EXPECT_TRUE(add({.address = 0x2000, .size = 0x1000}));
+  EXPECT_TRUE(add({.extended_address = 1, .address = 0x1000, .size = 0x1000}));
+  EXPECT_TRUE(add({.address = 0xFFFFF000, .size = 0x1000}));
+}
+
+TEST(MemoryTarget, ServesCommandsWithinOneRegion) {
+  spw_rmap::MemoryTarget memory;
+  ASSERT_TRUE(
+      memory.addRegion({.address = 0x1000, .size = 0x1000}).has_value());
+  ASSERT_TRUE(memory.addRegion(
+      {.extended_address = 2, .address = 0x1000, .size = 0x1000}).has_value());
+
+  const std::array<uint8_t, 4> value{0x11, 0x22, 0x33, 0x44};
+  EXPECT_EQ(memory.write(command(2, 0x1FFC, value)),
+            PacketStatusCode::CommandExecutedSuccessfully);
+  std::array<uint8_t, 4> read{};
+  EXPECT_EQ(memory.read(command(2, 0x1FFC, read), read),
+            PacketStatusCode::CommandExecutedSuccessfully);
+  EXPECT_EQ(read, value);
+  auto view = memory.readView(command(2, 0x1FFC, read));
+  ASSERT_TRUE(view.has_value());
+  EXPECT_TRUE(std::ranges::equal(*view, value));
+  // Extended address 0 is a separate region.
+  EXPECT_EQ(memory.view(0, 0x1FFC, 4)[0], 0);
+
+  // Past the end of the region, or in no region at all.
+  EXPECT_EQ(memory.write(command(2, 0x1FFE, value)),
+            PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised);
+  EXPECT_EQ(memory.read(command(1, 0x1000, read), read),
+            PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised);
+  EXPECT_FALSE(memory.readView(command(0, 0x0FFF, read)).has_value());
+
+  // RMW: the masked bits take the new value, the reply the old one.
+  const std::array<uint8_t, 4> rmw{0xFF, 0x00, 0x0F, 0x0F};
+  std::array<uint8_t, 2> old{};
+  auto packet = command(2, 0x1FFC, rmw);
+  EXPECT_EQ(memory.readModifyWrite(packet, old),
+            PacketStatusCode::CommandExecutedSuccessfully);
+  EXPECT_EQ(old, (std::array<uint8_t, 2>{0x11, 0x22}));
+  EXPECT_TRUE(std::ranges::equal(memory.view(2, 0x1FFC, 2),
+                                 std::array<uint8_t, 2>{0x1F, 0x20}));
+  const std::array<uint8_t, 10> too_long{};
+  std::array<uint8_t, 5> ignored{};
+  EXPECT_EQ(memory.readModifyWrite(command(2, 0x1000, too_long), ignored),
+            PacketStatusCode::RMWDataLengthError);
+}
+
+TEST(MemoryTarget, FileBackedRegionsKeepTheirContents) {
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("spwrmap_memory_target_" + std::to_string(::getpid()));
+  std::filesystem::remove(path);
+  const auto region = spw_rmap::MemoryRegionConfig{
+      .address = 0x4000, .size = 0x10000, .backing_file = path};
+  const std::array<uint8_t, 4> value{0xCA, 0xFE, 0xBA, 0xBE};
+  {
+    spw_rmap::MemoryTarget memory;
+    ASSERT_TRUE(memory.addRegion(region).has_value());
+    EXPECT_EQ(memory.write(command(0, 0x8000, value)),
+              PacketStatusCode::CommandExecutedSuccessfully);
+    EXPECT_TRUE(memory.sync().has_value());
+  }
+  EXPECT_EQ(std::filesystem::file_size(path), 0x10000U);
+  {
+    spw_rmap::MemoryTarget memory;
+    ASSERT_TRUE(memory.addRegion(region).has_value());
+    EXPECT_TRUE(std::ranges::equal(memory.view(0, 0x8000, 4), value));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(MemoryTarget, RmwCommandsParseAsDataAndMask) {
+  const std::array<uint8_t, 2> value{0xAB, 0xCD};
+  const std::array<uint8_t, 2> mask{0xF0, 0x0F};
+  const auto packet = rmwCommand(0x0042, 0x10, value, mask);
+  spw_rmap::PacketParser parser;
+  ASSERT_EQ(parser.parse(packet), spw_rmap::PacketParser::Status::Success);
+  EXPECT_EQ(parser.getPacket().type, spw_rmap::PacketType::ReadModifyWrite);
+  EXPECT_EQ(parser.getPacket().dataLength, 4U);
+  EXPECT_TRUE(std::ranges::equal(parser.getPacket().data,
+                                 std::array<uint8_t, 4>{0xAB, 0xCD, 0xF0,
+                                                        0x0F}));
+}
+
+#ifdef __linux__
+
+auto pickFreePort() -> std::string {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) {
+    return {};
+  }
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sl = sizeof(sin);
+  std::string port;
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+             sizeof(sin)) == 0 &&
+      ::getsockname(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                    &sl) == 0) {
+    port = std::to_string(ntohs(sin.sin_port));
+  }
+  ::close(fd);
+  return port;
+}
+
+TEST(MemoryTarget, ServesAClientThroughTheServer) {
+  const auto port = pickFreePort();
+  if (port.empty()) {
+    GTEST_SKIP() << "Loopback sockets are not available";
+  }
+  auto memory = std::make_shared<spw_rmap::MemoryTarget>();
+  ASSERT_TRUE(memory->addRegion({.address = 0, .size = 1 << 20}).has_value());
+  spw_rmap::SpwRmapTCPServer server(
+      {.ip_address = "127.0.0.1", .port = port});
+  server.registerTarget(memory);
+  std::thread server_thread([&server] {
+    if (server.acceptOnce().has_value()) {
+      std::ignore = server.runLoop();
+    }
+  });
+
+  spw_rmap::SpwRmapTCPClient client(
+      {.ip_address = "127.0.0.1", .port = port});
+  bool connected = false;
+  for (int attempt = 0; attempt < 100 && !connected; ++attempt) {
+    connected = client.connect(100ms).has_value();
+    if (!connected) {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  ASSERT_TRUE(connected);
+  std::thread client_thread([&client] { std::ignore = client.runLoop(); });
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+
+  std::vector<uint8_t> data(1024);
+  std::iota(data.begin(), data.end(), static_cast<uint8_t>(0x07));
+  EXPECT_TRUE(client.write(target, 0xFFC00, data, 1s).has_value());
+  std::vector<uint8_t> readback(data.size());
+  EXPECT_TRUE(client.read(target, 0xFFC00, readback, 1s).has_value());
+  EXPECT_EQ(readback, data);
+  // Past the end of the region: answered with a status and no data.
+  EXPECT_FALSE(client.read(target, 0xFFE00, readback, 1s).has_value());
+  uint8_t status = 0;
+  EXPECT_TRUE(client
+                  .writeAsync(target, 0xFFE00, data,
+                              [&status](spw_rmap::Packet packet) {
+                                status = packet.status;
+                              })
+                  .get()
+                  .has_value());
+  EXPECT_EQ(status,
+            static_cast<uint8_t>(
+                PacketStatusCode::RMAPCommandNotImplementedOrNotAuthorised));
+
+  std::ignore = client.shutdown();
+  client_thread.join();
+  std::ignore = server.shutdown();
+  server_thread.join();
+}
+
+TEST(MemoryTarget, AnswersRmwCommandsThroughTheMultiServer) {
+  auto memory = std::make_shared<spw_rmap::MemoryTarget>();
+  ASSERT_TRUE(memory->addRegion({.address = 0, .size = 0x1000}).has_value());
+  const std::array<uint8_t, 2> initial{0x12, 0x34};
+  std::ranges::copy(initial, memory->view(0, 0x10, 2).begin());
+  spw_rmap::SpwRmapTCPMultiServer server(
+      {.ip_address = "127.0.0.1", .port = "0"});
+  server.registerTarget(memory);
+  ASSERT_TRUE(server.start().has_value());
+
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  ASSERT_GE(fd, 0);
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sin.sin_port = htons(static_cast<uint16_t>(std::stoi(server.getPort())));
+  ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                      sizeof(sin)),
+            0);
+
+  const auto packet =
+      rmwCommand(0x0042, 0x10, std::array<uint8_t, 2>{0xAB, 0xCD},
+                 std::array<uint8_t, 2>{0xF0, 0x0F});
+  std::vector<uint8_t> frame(12 + packet.size(), 0);
+  frame[11] = static_cast<uint8_t>(packet.size());
+  std::ranges::copy(packet, frame.begin() + 12);
+  ASSERT_EQ(::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL),
+            static_cast<ssize_t>(frame.size()));
+
+  std::array<uint8_t, 12> header{};
+  ASSERT_EQ(::recv(fd, header.data(), header.size(), MSG_WAITALL), 12);
+  std::vector<uint8_t> reply(header[11]);
+  ASSERT_EQ(::recv(fd, reply.data(), reply.size(), MSG_WAITALL),
+            static_cast<ssize_t>(reply.size()));
+  spw_rmap::PacketParser parser;
+  ASSERT_EQ(parser.parse(reply), spw_rmap::PacketParser::Status::Success);
+  const auto& answer = parser.getPacket();
+  EXPECT_EQ(answer.type, spw_rmap::PacketType::ReadReply);
+  EXPECT_NE(answer.instruction &
+                std::to_underlying(
+                    spw_rmap::RMAPCommandCode::VerifyDataBeforeWrite),
+            0);
+  EXPECT_EQ(answer.transactionID, 0x0042);
+  EXPECT_EQ(answer.status, 0);
+  EXPECT_TRUE(std::ranges::equal(answer.data, initial));
+  EXPECT_TRUE(std::ranges::equal(memory->view(0, 0x10, 2),
+                                 std::array<uint8_t, 2>{0xA2, 0x3D}));
+  ::close(fd);
+  std::ignore = server.shutdown();
+}
+
+#endif  // __linux__
+
+}  // namespace
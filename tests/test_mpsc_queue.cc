@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <spw_rmap/internal/mpsc_queue.hh>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Item : spw_rmap::internal::MpscQueueHook {
+  std::size_t producer = 0;
+  std::size_t sequence = 0;
+};
+
+TEST(MpscQueue, PopsInPushOrder) {
+  spw_rmap::internal::MpscQueue<Item> queue;
+  std::array<Item, 3> items{};
+  EXPECT_EQ(queue.pop(), nullptr);
+  for (auto& item : items) {
+    queue.push(&item);
+  }
+  for (auto& item : items) {
+    EXPECT_EQ(queue.pop(), &item);
+  }
+  EXPECT_EQ(queue.pop(), nullptr);
+  queue.push(items.data());
+  EXPECT_EQ(queue.pop(), items.data());
+}
+
+TEST(MpscQueue, KeepsPerProducerOrderUnderContention) {
+  constexpr std::size_t kProducers = 8;
+  constexpr std::size_t kPerProducer = 20000;
+  spw_rmap::internal::MpscQueue<Item> queue;
+  std::vector<Item> items(kProducers * kPerProducer);
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (std::size_t i = 0; i < kPerProducer; ++i) {
+        auto& item = items[p * kPerProducer + i];
+        item.producer = p;
+        item.sequence = i;
+        queue.push(&item);
+      }
+    });
+  }
+
+  std::array<std::size_t, kProducers> next{};
+  std::size_t received = 0;
+  while (received < items.size()) {
+    Item* item = queue.pop();
+    if (item == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(item->sequence, next.at(item->producer));
+    ++next.at(item->producer);
+    ++received;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(queue.pop(), nullptr);
+}
+
+}  // namespace
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <spw_rmap/packet_builder.hh>
+#include <spw_rmap/packet_parser.hh>
+#include <spw_rmap/spw_rmap_tcp_multi_server.hh>
+#include <spw_rmap/spw_rmap_tcp_node.hh>
+#include <spw_rmap/target_node.hh>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Target memory shared by every connection.
+class Memory {
+ public:
+  explicit Memory(std::size_t size) : bytes_(size) {}
+
+  auto write(const spw_rmap::Packet& packet) -> void {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::ranges::copy(packet.data, bytes_.begin() + packet.address);
+  }
+
+  auto read(const spw_rmap::Packet& packet) -> std::vector<uint8_t> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const auto begin = bytes_.begin() + packet.address;
+    return {begin, begin + packet.dataLength};
+  }
+
+ private:
+  std::mutex mtx_;
+  std::vector<uint8_t> bytes_;
+};
+
+auto frameOf(uint8_t type, std::span<const uint8_t> payload)
+    -> std::vector<uint8_t> {
+  std::vector<uint8_t> frame(12 + payload.size(), 0);
+  frame[0] = type;
+  const uint64_t length = payload.size();
+  for (std::size_t i = 0; i < 8; ++i) {
+    frame[4 + i] = static_cast<uint8_t>(length >> (56 - 8 * i));
+  }
+  std::ranges::copy(payload, frame.begin() + 12);
+  return frame;
+}
+
+auto recvExact(int fd, std::span<uint8_t> buffer) -> bool {
+  std::size_t got = 0;
+  while (got < buffer.size()) {
+    const auto n = ::recv(fd, buffer.data() + got, buffer.size() - got, 0);
+    if (n <= 0) {
+      return false;
+    }
+    got += static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+TEST(SpwRmapTCPMultiServer, ServesConcurrentClientsOnTheirOwnConnections) {
+  constexpr std::size_t kClients = 8;
+  constexpr std::size_t kRegion = 256;
+  Memory memory(kClients * kRegion);
+  spw_rmap::SpwRmapTCPMultiServer server(
+      {.ip_address = "127.0.0.1", .port = "0", .worker_threads = 3});
+  server.registerOnWrite(
+      [&memory](spw_rmap::Packet packet) { memory.write(packet); });
+  server.registerOnRead(
+      [&memory](spw_rmap::Packet packet) { return memory.read(packet); });
+  ASSERT_TRUE(server.start().has_value());
+
+  // Every client uses the same transaction IDs, so a reply sent on the
+  // wrong connection completes another client's transaction with the
+  // wrong data.
+  std::array<bool, kClients> ok{};
+  std::vector<std::thread> threads;
+  for (std::size_t c = 0; c < kClients; ++c) {
+    threads.emplace_back([&server, &ok, c] {
+      spw_rmap::SpwRmapTCPClient client(
+          {.ip_address = "127.0.0.1", .port = server.getPort()});
+      if (!client.connect(1s).has_value()) {
+        return;
+      }
+      std::thread loop([&client] { std::ignore = client.runLoop(); });
+      auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+          0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+      const auto address = static_cast<uint32_t>(c * kRegion);
+      bool good = true;
+      for (std::size_t i = 0; i < 20 && good; ++i) {
+        std::vector<uint8_t> written(kRegion);
+        for (std::size_t j = 0; j < written.size(); ++j) {
+          written[j] = static_cast<uint8_t>(c * 31 + i * 7 + j);
+        }
+        std::vector<uint8_t> read(kRegion);
+        good = client.write(target, address, written, 1s).has_value() &&
+               client.read(target, address, read, 1s).has_value() &&
+               read == written;
+      }
+      ok[c] = good;
+      std::ignore = client.shutdown();
+      loop.join();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (std::size_t c = 0; c < kClients; ++c) {
+    EXPECT_TRUE(ok[c]) << "client " << c;
+  }
+  std::ignore = server.shutdown();
+  EXPECT_EQ(server.connectionCount(), 0U);
+}
+
+TEST(SpwRmapTCPMultiServer, ReassemblesSplitFramesAndPipelinedCommands) {
+  Memory memory(64);
+  spw_rmap::SpwRmapTCPMultiServer server(
+      {.ip_address = "127.0.0.1", .port = "0"});
+  server.registerOnWrite(
+      [&memory](spw_rmap::Packet packet) { memory.write(packet); });
+  server.registerOnRead(
+      [&memory](spw_rmap::Packet packet) { return memory.read(packet); });
+  ASSERT_TRUE(server.start().has_value());
+
+  const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  ASSERT_GE(fd, 0);
+  int yes = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sin.sin_port = htons(static_cast<uint16_t>(std::stoi(server.getPort())));
+  ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                      sizeof(sin)),
+            0);
+
+  const std::array<uint8_t, 4> value{0xDE, 0xAD, 0xBE, 0xEF};
+  const std::array<uint8_t, 1> reply_address{0x01};
+  auto write_config = spw_rmap::WritePacketConfig{
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = 0x1234,
+      .address = 0x10,
+      .reply = true,
+      .data = value,
+  };
+  spw_rmap::WritePacketBuilder write_builder;
+  std::vector<uint8_t> write(write_builder.getTotalSize(write_config));
+  ASSERT_TRUE(write_builder.build(write_config, write).has_value());
+  auto read_config = spw_rmap::ReadPacketConfig{
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = 0x1235,
+      .address = 0x10,
+      .dataLength = 4,
+  };
+  spw_rmap::ReadPacketBuilder read_builder;
+  std::vector<uint8_t> read(read_builder.getTotalSize(read_config));
+  ASSERT_TRUE(read_builder.build(read_config, read).has_value());
+
+  // The write split over two frames with a timecode between them, then
+  // the read, all sent a byte at a time.
+  const auto half = write.size() / 2;
+  std::vector<uint8_t> stream;
+  for (const auto& frame :
+       {frameOf(0x02, std::span(write).first(half)),
+        frameOf(0x30, std::array<uint8_t, 2>{0x05, 0x00}),
+        frameOf(0x00, std::span(write).subspan(half)), frameOf(0x00, read)}) {
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  for (const auto byte : stream) {
+    ASSERT_EQ(::send(fd, &byte, 1, MSG_NOSIGNAL), 1);
+  }
+
+  for (const auto [type, transaction_id] :
+       {std::pair{spw_rmap::PacketType::WriteReply, 0x1234},
+        std::pair{spw_rmap::PacketType::ReadReply, 0x1235}}) {
+    std::array<uint8_t, 12> header{};
+    ASSERT_TRUE(recvExact(fd, header));
+    EXPECT_EQ(header[0], 0x00);
+    std::vector<uint8_t> reply(header[11]);
+    ASSERT_TRUE(recvExact(fd, reply));
+    spw_rmap::PacketParser parser;
+    ASSERT_EQ(parser.parse(reply), spw_rmap::PacketParser::Status::Success);
+    EXPECT_EQ(parser.getPacket().type, type);
+    EXPECT_EQ(parser.getPacket().transactionID, transaction_id);
+    if (type == spw_rmap::PacketType::ReadReply) {
+      EXPECT_TRUE(std::ranges::equal(parser.getPacket().data, value));
+    }
+  }
+  EXPECT_EQ(server.connectionCount(), 1U);
+  ::close(fd);
+  std::ignore = server.shutdown();
+}
+
+TEST(SpwRmapTCPMultiServer, DropsConnectionsSendingOversizedPackets) {
+  spw_rmap::SpwRmapTCPMultiServer server({.ip_address = "127.0.0.1",
+                                          .port = "0",
+                                          .worker_threads = 1,
+                                          .max_packet_size = 64});
+  ASSERT_TRUE(server.start().has_value());
+  sockaddr_in sin{};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sin.sin_port = htons(static_cast<uint16_t>(std::stoi(server.getPort())));
+
+  // One frame announcing 1 GiB, and a packet of 40-byte frames that only
+  // passes the limit on its second frame.
+  std::array<uint8_t, 12> huge{};
+  huge[8] = 0x40;
+  const std::vector<uint8_t> part(40, 0xAA);
+  auto split = frameOf(0x02, part);
+  const auto second = frameOf(0x02, part);
+  split.insert(split.end(), second.begin(), second.end());
+  for (const auto& stream : {std::vector<uint8_t>(huge.begin(), huge.end()),
+                             split}) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&sin),  // NOLINT
+                        sizeof(sin)),
+              0);
+    ASSERT_EQ(::send(fd, stream.data(), stream.size(), MSG_NOSIGNAL),
+              static_cast<ssize_t>(stream.size()));
+    std::array<uint8_t, 1> byte{};
+    EXPECT_EQ(::recv(fd, byte.data(), byte.size(), 0), 0);
+    ::close(fd);
+  }
+  std::ignore = server.shutdown();
+}
+
+TEST(SpwRmapTCPMultiServer, ReadIntoHandlerFillsTheReply) {
+  spw_rmap::SpwRmapTCPMultiServer server(
+      {.ip_address = "127.0.0.1", .port = "0"});
+  server.registerOnReadInto(
+      [](spw_rmap::Packet packet, std::span<uint8_t> data) {
+        std::ranges::fill(data, static_cast<uint8_t>(packet.address));
+        return spw_rmap::PacketStatusCode::CommandExecutedSuccessfully;
+      });
+  ASSERT_TRUE(server.start().has_value());
+  spw_rmap::SpwRmapTCPClient client(
+      {.ip_address = "127.0.0.1", .port = server.getPort()});
+  ASSERT_TRUE(client.connect(1s).has_value());
+  std::thread loop([&client] { std::ignore = client.runLoop(); });
+  auto target = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0xFE, std::vector<uint8_t>{}, std::vector<uint8_t>{});
+  std::array<uint8_t, 32> data{};
+  EXPECT_TRUE(client.read(target, 0x5A, data, 1s).has_value());
+  EXPECT_TRUE(std::ranges::all_of(data, [](uint8_t b) { return b == 0x5A; }));
+  std::ignore = client.shutdown();
+  loop.join();
+  std::ignore = server.shutdown();
+}
+
+}  // namespace
+
+#endif  // __linux__
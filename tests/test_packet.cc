@@ -2,10 +2,14 @@
 #include <gtest/gtest-matchers.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <random>
+#include <spw_rmap/inline_packet_builder.hh>
 #include <spw_rmap/packet_builder.hh>
 #include <spw_rmap/packet_parser.hh>
+#include <spw_rmap/static_packet.hh>
 
 #include "spw_rmap/target_node.hh"
 
@@ -364,3 +368,255 @@ TEST(spw_rmap, ParseWritePacketDirectly) {
   EXPECT_EQ(parsed.address, config.address);
   EXPECT_TRUE(SpanEqual(parsed.data, config.data));
 }
+
+TEST(spw_rmap, StreamingDataCRCMatchesParser) {
+  using namespace spw_rmap;
+
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 300; ++i) {
+    data.push_back(random_byte());
+  }
+  const std::array<uint8_t, 2> reply_address{0x02, 0x03};
+  auto b = ReadReplyPacketBuilder();
+  auto c = ReadReplyPacketConfig{
+      .replyAddress = reply_address,
+      .targetLogicalAddress = 0x34,
+      .transactionID = 0x1234,
+      .data = data,
+  };
+  std::vector<uint8_t> packet(b.getTotalSize(c));
+  ASSERT_TRUE(b.build(c, packet).has_value());
+
+  for (size_t chunk : {1UL, 3UL, 13UL, 64UL, packet.size()}) {
+    StreamingDataCRC streaming;
+    for (size_t received = 0; received < packet.size();) {
+      received = std::min(received + chunk, packet.size());
+      streaming.advance(std::span(packet).first(received));
+    }
+    auto data_crc = streaming.result(packet);
+    ASSERT_TRUE(data_crc.has_value());
+    EXPECT_EQ(*data_crc, 0x00);
+
+    auto parser = PacketParser();
+    EXPECT_EQ(parser.parse(packet, data_crc), PacketParser::Status::Success);
+    EXPECT_TRUE(SpanEqual(parser.getPacket().data, std::span(c.data)));
+  }
+
+  packet[20] ^= 0x01;
+  StreamingDataCRC streaming;
+  streaming.advance(std::span(packet).first(10));
+  streaming.advance(packet);
+  auto parser = PacketParser();
+  EXPECT_EQ(parser.parse(packet, streaming.result(packet)),
+            PacketParser::Status::DataCRCError);
+}
+
+TEST(spw_rmap, SuppliedDataCRCReplacesSecondPass) {
+  using namespace spw_rmap;
+
+  std::array<uint8_t, 64> data{};
+  for (auto& byte : data) {
+    byte = random_byte();
+  }
+  const std::array<uint8_t, 1> reply_address{0x02};
+  auto rb = ReadReplyPacketBuilder();
+  auto rc = ReadReplyPacketConfig{.replyAddress = reply_address,
+                                  .targetLogicalAddress = 0x34,
+                                  .transactionID = 0x0101,
+                                  .data = data};
+  std::vector<uint8_t> reply(rb.getTotalSize(rc));
+  ASSERT_TRUE(rb.build(rc, reply).has_value());
+  auto wb = WritePacketBuilder();
+  auto wc = WritePacketConfig{.replyAddress = reply_address,
+                              .targetLogicalAddress = 0xFE,
+                              .initiatorLogicalAddress = 0x34,
+                              .transactionID = 0x0102,
+                              .address = 0x1000,
+                              .data = data};
+  std::vector<uint8_t> command(wb.getTotalSize(wc));
+  ASSERT_TRUE(wb.build(wc, command).has_value());
+
+  for (auto* packet : {&reply, &command}) {
+    // The data no longer matches its CRC byte, but the CRC computed while
+    // streaming is what counts; the parser must not check it again.
+    (*packet)[packet->size() - 10] ^= 0x01;
+    auto parser = PacketParser();
+    EXPECT_EQ(parser.parse(*packet, uint8_t{0x00}),
+              PacketParser::Status::Success);
+    EXPECT_EQ(parser.parse(*packet, uint8_t{0x01}),
+              PacketParser::Status::DataCRCError);
+    EXPECT_EQ(parser.parse(*packet), PacketParser::Status::DataCRCError);
+  }
+}
+
+TEST(spw_rmap, StreamingDataCRCNoDataField) {
+  using namespace spw_rmap;
+
+  const std::array<uint8_t, 1> reply_address{0x02};
+  auto b = WriteReplyPacketBuilder();
+  auto c = WriteReplyPacketConfig{.replyAddress = reply_address};
+  std::vector<uint8_t> packet(b.getTotalSize(c));
+  ASSERT_TRUE(b.build(c, packet).has_value());
+
+  StreamingDataCRC streaming;
+  streaming.advance(packet);
+  EXPECT_FALSE(streaming.result(packet).has_value());
+}
+
+TEST(spw_rmap, StaticReadCommandMatchesBuilder) {
+  using namespace spw_rmap;
+
+  constexpr auto command = [] {
+    TargetNodeFixed<2, 3> node(0x34, {0x05, 0x07}, {0x01, 0x02, 0x03});
+    return makeReadCommand(node, 0x44A00010, 4);
+  }();
+  const TargetNodeFixed<2, 3> node(0x34, {0x05, 0x07}, {0x01, 0x02, 0x03});
+  static_assert(command.size() == 2 + 4 + 4 + 12);
+
+  auto b = ReadPacketBuilder();
+  for (int i = 0; i < 100; ++i) {
+    auto transaction_id =
+        static_cast<uint16_t>(random_byte() << 8 | random_byte());
+    auto c = ReadPacketConfig{
+        .targetSpaceWireAddress = node.getTargetSpaceWireAddress(),
+        .replyAddress = node.getReplyAddress(),
+        .targetLogicalAddress = node.getTargetLogicalAddress(),
+        .transactionID = transaction_id,
+        .address = 0x44A00010,
+        .dataLength = 4,
+    };
+    std::vector<uint8_t> expected(b.getTotalSize(c));
+    ASSERT_TRUE(b.build(c, expected).has_value());
+
+    std::vector<uint8_t> packet(command.size());
+    EXPECT_EQ(command.writeTo(packet, transaction_id), command.size());
+    EXPECT_EQ(packet, expected);
+  }
+}
+
+TEST(spw_rmap, StaticReadCommandWithoutReplyAddress) {
+  using namespace spw_rmap;
+
+  const auto command = makeReadCommand(std::array<uint8_t, 0>{},
+                                       std::array<uint8_t, 0>{}, 0xFE,
+                                       0x00001000, 16, 0x01, 0x20, 0x55, false);
+  std::vector<uint8_t> packet(command.size());
+  command.writeTo(packet, 0xBEEF);
+
+  auto parser = PacketParser();
+  ASSERT_EQ(parser.parse(packet), PacketParser::Status::Success);
+  auto d = parser.getPacket();
+  EXPECT_EQ(d.type, PacketType::Read);
+  EXPECT_EQ(d.transactionID, 0xBEEF);
+  EXPECT_EQ(d.extendedAddress, 0x01);
+  EXPECT_EQ(d.address, 0x00001000U);
+  EXPECT_EQ(d.dataLength, 16U);
+  EXPECT_EQ(d.key, 0x55);
+  EXPECT_EQ(d.initiatorLogicalAddress, 0x20);
+  EXPECT_EQ(d.instruction & 0b00000100, 0);
+}
+
+TEST(spw_rmap, CommandHeaderTemplateMatchesBuilder) {
+  using namespace spw_rmap;
+
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<uint8_t> target_address;
+    std::vector<uint8_t> reply_address;
+    for (size_t j = 0; j < random_bus_length(); ++j) {
+      target_address.push_back(random_bus_address());
+      reply_address.push_back(random_bus_address());
+    }
+    TargetNodeDynamic node(random_logical_address(), std::move(target_address),
+                           std::move(reply_address));
+    const auto& header = node.getCommandHeader();
+    ASSERT_TRUE(header.isValid());
+
+    const auto path = node.getTargetSpaceWireAddress();
+    const auto initiator = random_logical_address();
+    const auto transaction_id =
+        static_cast<uint16_t>(random_byte() << 8 | random_byte());
+    const auto address = random_address();
+    std::vector<uint8_t> data(random_data_length());
+    for (auto& byte : data) {
+      byte = random_byte();
+    }
+
+    auto rb = ReadPacketBuilder();
+    auto rc = ReadPacketConfig{
+        .targetSpaceWireAddress = path,
+        .replyAddress = node.getReplyAddress(),
+        .targetLogicalAddress = node.getTargetLogicalAddress(),
+        .initiatorLogicalAddress = initiator,
+        .transactionID = transaction_id,
+        .address = address,
+        .dataLength = static_cast<uint32_t>(data.size()),
+    };
+    std::vector<uint8_t> expected(rb.getTotalSize(rc));
+    ASSERT_TRUE(rb.build(rc, expected).has_value());
+    std::vector<uint8_t> packet(path.size() + header.size());
+    std::ranges::copy(path, packet.begin());
+    header.writeTo(std::span(packet).subspan(path.size()),
+                   CommandHeaderTemplate::Kind::Read, initiator,
+                   transaction_id, 0x00, address,
+                   static_cast<uint32_t>(data.size()));
+    EXPECT_EQ(packet, expected);
+
+    for (bool verify : {false, true}) {
+      auto wb = WritePacketBuilder();
+      auto wc = WritePacketConfig{
+          .targetSpaceWireAddress = path,
+          .replyAddress = node.getReplyAddress(),
+          .targetLogicalAddress = node.getTargetLogicalAddress(),
+          .initiatorLogicalAddress = initiator,
+          .transactionID = transaction_id,
+          .address = address,
+          .verifyMode = verify,
+          .data = data,
+      };
+      std::vector<uint8_t> expected_write(wb.getTotalSize(wc));
+      ASSERT_TRUE(wb.build(wc, expected_write).has_value());
+      std::vector<uint8_t> header_bytes(header.size());
+      header.writeTo(header_bytes,
+                     verify ? CommandHeaderTemplate::Kind::WriteVerify
+                            : CommandHeaderTemplate::Kind::Write,
+                     initiator, transaction_id, 0x00, address,
+                     static_cast<uint32_t>(data.size()));
+      EXPECT_TRUE(std::equal(header_bytes.begin(), header_bytes.end(),
+                             expected_write.begin() +
+                                 static_cast<std::ptrdiff_t>(path.size())));
+    }
+  }
+}
+
+TEST(spw_rmap, CommandHeaderTemplateRejectsLongReplyAddress) {
+  using namespace spw_rmap;
+
+  TargetNodeDynamic node(0x34, {0x01}, std::vector<uint8_t>(13, 0x02));
+  EXPECT_FALSE(node.getCommandHeader().isValid());
+}
+
+TEST(spw_rmap, InlineBuilderRejectsShortBuffer) {
+  using namespace spw_rmap;
+
+  const std::array<uint8_t, 2> target_address{0x05, 0x07};
+  const std::array<uint8_t, 8> data{};
+  auto c = WritePacketConfig{
+      .targetSpaceWireAddress = target_address,
+      .targetLogicalAddress = 0x34,
+      .data = data,
+  };
+  const auto size = InlineWritePacketBuilder::getTotalSize(c);
+  EXPECT_EQ(size, WritePacketBuilder().getTotalSize(c));
+
+  std::vector<uint8_t> packet(size - 1);
+  auto res = InlineWritePacketBuilder::build(c, packet);
+  ASSERT_FALSE(res.has_value());
+  EXPECT_EQ(res.error(), std::make_error_code(std::errc::no_buffer_space));
+
+  packet.resize(size);
+  res = InlineWritePacketBuilder::build(c, packet);
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(*res, size);
+  auto parser = PacketParser();
+  EXPECT_EQ(parser.parse(packet), PacketParser::Status::Success);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "spw_rmap/internal/rtt_estimator.hh"
+
+namespace {
+
+using namespace std::chrono_literals;
+using spw_rmap::internal::RttEstimator;
+
+constexpr RttEstimator::Duration kGranularity = 100us;
+constexpr RttEstimator::Duration kMin = 1ms;
+constexpr RttEstimator::Duration kMax = 1s;
+
+TEST(RttEstimator, FirstSampleSetsTheTimeoutToThreeRoundTrips) {
+  RttEstimator estimator;
+  EXPECT_EQ(estimator.timeout(), 0ns);
+  estimator.sample(10ms, kGranularity, kMin, kMax);
+  EXPECT_EQ(estimator.srtt(), 10ms);
+  EXPECT_EQ(estimator.rttvar(), 5ms);
+  EXPECT_EQ(estimator.timeout(), 30ms);
+  EXPECT_EQ(estimator.samples(), 1U);
+}
+
+TEST(RttEstimator, SmoothsLaterSamples) {
+  RttEstimator estimator;
+  estimator.sample(8ms, kGranularity, kMin, kMax);
+  estimator.sample(16ms, kGranularity, kMin, kMax);
+  // RTTVAR = 3/4 * 4 + 1/4 * |8 - 16|, SRTT = 7/8 * 8 + 1/8 * 16.
+  EXPECT_EQ(estimator.rttvar(), 5ms);
+  EXPECT_EQ(estimator.srtt(), 9ms);
+  EXPECT_EQ(estimator.timeout(), 29ms);
+}
+
+TEST(RttEstimator, ClampsToTheBoundsAndGranularity) {
+  RttEstimator estimator;
+  estimator.sample(20us, kGranularity, kMin, kMax);
+  EXPECT_EQ(estimator.timeout(), kMin);
+  for (int i = 0; i < 100; ++i) {
+    estimator.sample(20us, kGranularity, 0ns, kMax);
+  }
+  // The variation has decayed; the clock granularity remains.
+  EXPECT_EQ(estimator.timeout(), estimator.srtt() + kGranularity);
+  estimator.sample(10s, kGranularity, kMin, kMax);
+  EXPECT_EQ(estimator.timeout(), kMax);
+}
+
+TEST(RttEstimator, BackoffDoublesUntilTheNextSample) {
+  RttEstimator estimator;
+  estimator.sample(100ms, kGranularity, kMin, kMax);
+  EXPECT_EQ(estimator.timeout(), 300ms);
+  estimator.backoff(kMax);
+  EXPECT_EQ(estimator.timeout(), 600ms);
+  estimator.backoff(kMax);
+  EXPECT_EQ(estimator.timeout(), kMax);
+  EXPECT_EQ(estimator.timeouts(), 2U);
+  estimator.sample(100ms, kGranularity, kMin, kMax);
+  EXPECT_LT(estimator.timeout(), 300ms);
+}
+
+}  // namespace
@@ -1,22 +1,31 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <deque>
 #include <expected>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <span>
+#include <thread>
 #include <vector>
 
 #include "spw_rmap/internal/spw_rmap_tcp_node_impl.hh"
 #include "spw_rmap/packet_builder.hh"
+#include "spw_rmap/packet_parser.hh"
+#include "spw_rmap/static_packet.hh"
 #include "spw_rmap/target_node.hh"
 
 namespace {
 
+using namespace std::chrono_literals;
+
 class MockBackend {
  public:
   MockBackend(std::string ip, std::string port)
@@ -41,10 +50,27 @@ class MockBackend {
 
   auto sendAll(std::span<const uint8_t> data) noexcept
       -> std::expected<std::monostate, std::error_code> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fail_sends_) {
+      return std::unexpected{std::make_error_code(std::errc::broken_pipe)};
+    }
     sent_frames_.emplace_back(data.begin(), data.end());
     return std::monostate{};
   }
 
+  auto sendAllv(std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fail_sends_) {
+      return std::unexpected{std::make_error_code(std::errc::broken_pipe)};
+    }
+    auto& frame = sent_frames_.emplace_back();
+    for (const auto& buffer : buffers) {
+      frame.insert(frame.end(), buffer.begin(), buffer.end());
+    }
+    return std::monostate{};
+  }
+
   auto recvSome(std::span<uint8_t> buffer) noexcept
       -> std::expected<std::size_t, std::error_code> {
     if (buffer.empty()) {
@@ -97,6 +123,22 @@ class MockBackend {
     return sent_frames_;
   }
 
+  // Everything sent so far as one byte stream; safe while a writer thread
+  // is sending.
+  [[nodiscard]] auto sentStream() -> std::vector<uint8_t> {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::vector<uint8_t> stream;
+    for (const auto& frame : sent_frames_) {
+      stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    return stream;
+  }
+
+  void setFailSends(bool fail) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    fail_sends_ = fail;
+  }
+
  private:
     std::string ip_address_;
     std::string port_;
@@ -105,6 +147,7 @@ class MockBackend {
     std::mutex mtx_;
     std::condition_variable cv_;
     bool shutdown_ = false;
+    bool fail_sends_ = false;
 };
 
 class TestNode
@@ -128,6 +171,14 @@ class TestNode
     return backend().isShutdown();
   }
 
+  auto sentFrames() -> const std::vector<std::vector<uint8_t>>& {
+    return backend().sent_frames();
+  }
+
+  auto sentStream() -> std::vector<uint8_t> { return backend().sentStream(); }
+
+  void setFailSends(bool fail) { backend().setFailSends(fail); }
+
  private:
   using Base::getBackend_;
 
@@ -173,6 +224,82 @@ auto buildWriteReplyFrame(uint16_t transaction_id)
   return makeFrame(payload);
 }
 
+auto buildReadReplyFrame(uint16_t transaction_id,
+                         std::span<const uint8_t> data)
+    -> std::vector<uint8_t> {
+  spw_rmap::ReadReplyPacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::ReadReplyPacketConfig{
+      .replyAddress = reply_addr,
+      .initiatorLogicalAddress = 0x34,
+      .status = static_cast<uint8_t>(
+          spw_rmap::PacketStatusCode::CommandExecutedSuccessfully),
+      .targetLogicalAddress = 0xFE,
+      .transactionID = transaction_id,
+      .data = data,
+      .incrementMode = true,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return makeFrame(payload);
+}
+
+// Commands addressed to the node itself, to exercise the target side.
+auto buildReadCommandFrame(uint16_t transaction_id, uint32_t address,
+                           uint32_t length) -> std::vector<uint8_t> {
+  spw_rmap::ReadPacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::ReadPacketConfig{
+      .replyAddress = reply_addr,
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = transaction_id,
+      .address = address,
+      .dataLength = length,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return makeFrame(payload);
+}
+
+auto buildWriteCommandFrame(uint16_t transaction_id, uint32_t address,
+                            std::span<const uint8_t> data)
+    -> std::vector<uint8_t> {
+  spw_rmap::WritePacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::WritePacketConfig{
+      .replyAddress = reply_addr,
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = transaction_id,
+      .address = address,
+      .data = data,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return makeFrame(payload);
+}
+
+// Transaction IDs of the replies in a sent byte stream, in order.
+auto replyTransactionIds(std::span<const uint8_t> stream)
+    -> std::vector<uint16_t> {
+  std::vector<uint16_t> transaction_ids;
+  spw_rmap::PacketParser parser;
+  std::size_t offset = 0;
+  while (offset + 12 <= stream.size()) {
+    std::size_t length = 0;
+    for (std::size_t i = 4; i < 12; ++i) {
+      length = length << 8 | stream[offset + i];
+    }
+    if (parser.parse(stream.subspan(offset + 12, length)) ==
+        spw_rmap::PacketParser::Status::Success) {
+      transaction_ids.push_back(parser.getPacket().transactionID);
+    }
+    offset += 12 + length;
+  }
+  return transaction_ids;
+}
+
 auto makeNodeConfig() -> spw_rmap::SpwRmapTCPNodeConfig {
   spw_rmap::SpwRmapTCPNodeConfig config;
   config.ip_address = "127.0.0.1";
@@ -182,6 +309,27 @@ auto makeNodeConfig() -> spw_rmap::SpwRmapTCPNodeConfig {
   return config;
 }
 
+// Target that does not build a command header template, so the node falls
+// back to the packet builders.
+class PlainTargetNode : public spw_rmap::TargetNodeBase {
+ public:
+  PlainTargetNode() : spw_rmap::TargetNodeBase(0x34) {}
+
+  [[nodiscard]] auto getTargetSpaceWireAddress() const noexcept
+      -> std::span<const uint8_t> override {
+    return target_addr_;
+  }
+
+  [[nodiscard]] auto getReplyAddress() const noexcept
+      -> std::span<const uint8_t> override {
+    return reply_addr_;
+  }
+
+ private:
+  std::array<uint8_t, 2> target_addr_{0x20, 0x30};
+  std::array<uint8_t, 2> reply_addr_{0x10, 0x11};
+};
+
 auto makeTargetNode()
     -> std::shared_ptr<spw_rmap::TargetNodeBase> {
   std::vector<uint8_t> target_addr{0x20, 0x30};
@@ -190,6 +338,17 @@ auto makeTargetNode()
       0x34, std::move(target_addr), std::move(reply_addr));
 }
 
+// Minimal eager, fire-and-forget coroutine for driving the awaiters.
+struct Detached {
+  struct promise_type {
+    auto get_return_object() noexcept -> Detached { return {}; }
+    auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() noexcept -> std::suspend_never { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
 TEST(SpwRmapTCPNodeImplTest, WriteAsyncCompletesAfterPoll) {
   TestNode node(makeNodeConfig());
   auto target_node = makeTargetNode();
@@ -241,4 +400,784 @@ TEST(SpwRmapTCPNodeImplTest, WriteTimeoutReleasesTransactionId) {
   EXPECT_TRUE(callback_called.load());
 }
 
+TEST(SpwRmapTCPNodeImplTest, UnansweredTransactionExpiresAndFreesItsId) {
+  auto config = makeNodeConfig();
+  config.transaction_id_min = 0x0020;
+  config.transaction_id_max = 0x0021;
+  TestNode node(config);
+  node.setTimeout(std::chrono::milliseconds(1));
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 2> payload{0x01, 0x02};
+
+  // Nothing polls or allocates; the deadline alone completes the write.
+  const auto start = std::chrono::steady_clock::now();
+  auto stalled = node.writeAsync(target_node, 0x2000, payload,
+                                 [](const spw_rmap::Packet&) {});
+  ASSERT_EQ(stalled.wait_for(1s), std::future_status::ready);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 1ms);
+  auto stalled_result = stalled.get();
+  ASSERT_FALSE(stalled_result.has_value());
+  EXPECT_EQ(stalled_result.error(), std::make_error_code(std::errc::timed_out));
+
+  // The only ID is free again.
+  auto future = node.writeAsync(target_node, 0x2000, payload,
+                                [](const spw_rmap::Packet&) {});
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_TRUE(future.get().has_value());
+}
+
+TEST(SpwRmapTCPNodeImplTest, AdaptiveTimeoutFollowsMeasuredRoundTrips) {
+  auto config = makeNodeConfig();
+  config.adaptive_timeout = true;
+  config.min_adaptive_timeout = 5ms;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+  const auto target = target_node->getTargetLogicalAddress();
+  std::array<uint8_t, 2> payload{0x01, 0x02};
+  EXPECT_EQ(node.getRttEstimate(target).samples, 0U);
+
+  spw_rmap::TransactionCompletion completion;
+  node.writeAsync(target_node, 0x2000, payload, completion);
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(completion.result().has_value());
+  auto estimate = node.getRttEstimate(target);
+  EXPECT_EQ(estimate.samples, 1U);
+  EXPECT_GT(estimate.smoothed_rtt, 0ns);
+  EXPECT_GE(estimate.timeout, 5ms);
+
+  // Unanswered transactions now fail after the measured deadline, not the
+  // fixed one second, and back the next one off once, not once each.
+  // One submission shares one deadline.
+  const auto before = estimate.timeout;
+  const auto start = std::chrono::steady_clock::now();
+  spw_rmap::CompletionQueue queue(2);
+  const spw_rmap::RmapRequest request{
+      .operation = spw_rmap::RmapOperation::Write,
+      .target_node = target_node,
+      .memory_address = 0x2000,
+      .write_data = payload};
+  const std::array<spw_rmap::RmapRequest, 2> requests{request, request};
+  ASSERT_EQ(node.submit(queue, requests), 2U);
+  std::array<spw_rmap::RmapCompletion, 2> out{};
+  ASSERT_EQ(queue.reap(out, 2), 2U);
+  for (const auto& completed : out) {
+    EXPECT_EQ(completed.error, std::make_error_code(std::errc::timed_out));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+  estimate = node.getRttEstimate(target);
+  EXPECT_EQ(estimate.timeouts, 1U);
+  EXPECT_EQ(estimate.timeout, 2 * before);
+}
+
+TEST(SpwRmapTCPNodeImplTest, FixedTimeoutDoesNotTimeReplies) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 2> payload{0x01, 0x02};
+
+  spw_rmap::TransactionCompletion completion;
+  node.writeAsync(target_node, 0x2000, payload, completion);
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(completion.result().has_value());
+  EXPECT_EQ(node.getRttEstimate(target_node->getTargetLogicalAddress())
+                .samples,
+            0U);
+}
+
+TEST(SpwRmapTCPNodeImplTest, TransactionIdFFFFIsUsable) {
+  auto config = makeNodeConfig();
+  config.transaction_id_min = 0xFFFF;
+  config.transaction_id_max = 0x10000;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 2> payload{0x01, 0x02};
+
+  auto future = node.writeAsync(target_node, 0x2000, payload,
+                                [](const spw_rmap::Packet&) {});
+  node.enqueueIncoming(buildWriteReplyFrame(0xFFFF));
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_TRUE(future.get().has_value());
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadAsyncDeliversData) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> expected(200);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> received;
+  auto future = node.readAsync(
+      target_node, 0x3000, static_cast<uint32_t>(expected.size()),
+      [&received](const spw_rmap::Packet& packet) {
+        received.assign(packet.data.begin(), packet.data.end());
+      });
+
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+
+  auto poll_result = node.poll();
+  ASSERT_TRUE(poll_result.has_value());
+  EXPECT_TRUE(future.get().has_value());
+  EXPECT_EQ(received, expected);
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadReplySplitOverContinuationFrames) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> expected(200);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> received;
+  auto future = node.readAsync(
+      target_node, 0x3000, static_cast<uint32_t>(expected.size()),
+      [&received](const spw_rmap::Packet& packet) {
+        received.assign(packet.data.begin(), packet.data.end());
+      });
+
+  // The reply as two 0x02 frames, the first ending inside the header,
+  // followed by the final 0x00 frame.
+  const auto whole = buildReadReplyFrame(0x0020, expected);
+  const auto payload = std::span<const uint8_t>(whole).subspan(12);
+  std::vector<uint8_t> stream;
+  for (const auto& [offset, length] :
+       {std::pair<std::size_t, std::size_t>{0, 8}, {8, 100}}) {
+    auto frame = makeFrame(payload.subspan(offset, length));
+    frame[0] = 0x02;
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  const auto last = makeFrame(payload.subspan(108));
+  stream.insert(stream.end(), last.begin(), last.end());
+  node.enqueueIncoming(stream);
+
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_TRUE(future.get().has_value());
+  EXPECT_EQ(received, expected);
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadReplyWithBadDataCRCIsRejected) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> data(64, 0x5A);
+  auto future = node.readAsync(target_node, 0x3000,
+                               static_cast<uint32_t>(data.size()),
+                               [](const spw_rmap::Packet&) {});
+
+  auto frame = buildReadReplyFrame(0x0020, data);
+  frame[frame.size() - 10] ^= 0xFF;
+  node.enqueueIncoming(frame);
+
+  auto poll_result = node.poll();
+  ASSERT_FALSE(poll_result.has_value());
+  EXPECT_EQ(poll_result.error(),
+            spw_rmap::make_error_code(
+                spw_rmap::PacketParser::Status::DataCRCError));
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadWithStaticCommand) {
+  TestNode node(makeNodeConfig());
+  constexpr auto command = spw_rmap::makeReadCommand(
+      std::array<uint8_t, 2>{0x20, 0x30}, std::array<uint8_t, 2>{0x10, 0x11},
+      0x34, 0x3000, 8);
+
+  std::vector<uint8_t> expected{1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint8_t> received;
+  auto future = node.readAsync(
+      command, [&received](const spw_rmap::Packet& packet) {
+        received.assign(packet.data.begin(), packet.data.end());
+      });
+
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+
+  auto poll_result = node.poll();
+  ASSERT_TRUE(poll_result.has_value());
+  EXPECT_TRUE(future.get().has_value());
+  EXPECT_EQ(received, expected);
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadAsyncIntoCompletion) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> expected{9, 8, 7, 6, 5, 4};
+  std::vector<uint8_t> received(expected.size());
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, received, completion);
+  EXPECT_FALSE(completion.isReady());
+
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(completion.isReady());
+  EXPECT_TRUE(completion.result().has_value());
+  EXPECT_EQ(received, expected);
+
+  // The ID was released before the completion fired, so it is reused.
+  std::array<uint8_t, 2> payload{0x01, 0x02};
+  node.writeAsync(target_node, 0x3000, payload, completion);
+  EXPECT_FALSE(completion.isReady());
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_TRUE(completion.result().has_value());
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadIntoCompletionRejectsWrongLength) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::array<uint8_t, 8> buffer{};
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, buffer, completion);
+
+  const std::array<uint8_t, 4> short_reply{1, 2, 3, 4};
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, short_reply));
+  ASSERT_TRUE(node.poll().has_value());
+  auto result = completion.result();
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error(), std::make_error_code(std::errc::bad_message));
+  EXPECT_EQ(buffer, (std::array<uint8_t, 8>{}));
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadReplyIsCopiedIntoCallerBufferAsItArrives) {
+  auto config = makeNodeConfig();
+  config.recv_buffer_size = 64;
+  config.buffer_policy = spw_rmap::BufferPolicy::Fixed;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> expected(4096);
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> received(expected.size());
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, received, completion);
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+
+  // Far larger than the fixed receive buffer, but copied out of it as it
+  // arrives.
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(completion.isReady());
+  EXPECT_TRUE(completion.result().has_value());
+  EXPECT_EQ(received, expected);
+
+  // Without a destination to receive into, the reply must fit the buffer.
+  auto future = node.readAsync(target_node, 0x3000,
+                               static_cast<uint32_t>(expected.size()),
+                               [](const spw_rmap::Packet&) {});
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+  auto poll_result = node.poll();
+  ASSERT_FALSE(poll_result.has_value());
+  EXPECT_EQ(poll_result.error(),
+            std::make_error_code(std::errc::no_buffer_space));
+}
+
+TEST(SpwRmapTCPNodeImplTest, DirectReadReplyWithBadDataCRCFailsTransaction) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> received(64);
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, received, completion);
+
+  auto frame = buildReadReplyFrame(0x0020, std::vector<uint8_t>(64, 0x5A));
+  frame[frame.size() - 10] ^= 0xFF;
+  node.enqueueIncoming(frame);
+
+  const auto crc_error =
+      spw_rmap::make_error_code(spw_rmap::PacketParser::Status::DataCRCError);
+  auto poll_result = node.poll();
+  ASSERT_FALSE(poll_result.has_value());
+  EXPECT_EQ(poll_result.error(), crc_error);
+  ASSERT_TRUE(completion.isReady());
+  auto result = completion.result();
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error(), crc_error);
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadReplyCutOffMidDataFailsTransaction) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> received(64);
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, received, completion);
+
+  auto frame = buildReadReplyFrame(0x0020, std::vector<uint8_t>(64, 0x5A));
+  frame.resize(frame.size() - 20);
+  node.enqueueIncoming(frame);
+  ASSERT_TRUE(node.shutdown().has_value());
+
+  auto poll_result = node.poll();
+  ASSERT_TRUE(poll_result.has_value());
+  EXPECT_FALSE(*poll_result);
+  ASSERT_TRUE(completion.isReady());
+  EXPECT_FALSE(completion.result().has_value());
+}
+
+TEST(SpwRmapTCPNodeImplTest, ReadReplyStalledMidDataStillTimesOut) {
+  auto config = makeNodeConfig();
+  config.recv_buffer_size = 64;
+  TestNode node(config);
+  node.setTimeout(20ms);
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> expected(1024, 0x5A);
+  std::vector<uint8_t> received(expected.size());
+  spw_rmap::TransactionCompletion completion;
+  node.readAsync(target_node, 0x3000, received, completion);
+  auto future = node.readAsync(target_node, 0x3000,
+                               static_cast<uint32_t>(expected.size()),
+                               [](const spw_rmap::Packet&) {});
+
+  // Both replies stop halfway through their data; poll blocks on the rest.
+  auto first = buildReadReplyFrame(0x0020, expected);
+  auto second = buildReadReplyFrame(0x0021, expected);
+  const auto half = first.size() / 2;
+  std::thread poller([&node] {
+    while (node.poll().value_or(false)) {
+    }
+  });
+  node.enqueueIncoming({first.begin(), first.begin() + half});
+  const auto deadline = std::chrono::steady_clock::now() + 2s;
+  while (!completion.isReady() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_TRUE(completion.isReady());
+  EXPECT_EQ(completion.result().error(),
+            std::make_error_code(std::errc::timed_out));
+  node.enqueueIncoming({first.begin() + half, first.end()});
+  node.enqueueIncoming({second.begin(), second.begin() + half});
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  EXPECT_EQ(future.get().error(), std::make_error_code(std::errc::timed_out));
+
+  // The late remainders are dropped and the stream stays in step.
+  node.enqueueIncoming({second.begin() + half, second.end()});
+  std::vector<uint8_t> data(expected.size());
+  spw_rmap::TransactionCompletion next;
+  node.readAsync(target_node, 0x3000, data, next);
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+  EXPECT_TRUE(next.result().has_value());
+  EXPECT_EQ(data, expected);
+
+  ASSERT_TRUE(node.shutdown().has_value());
+  poller.join();
+}
+
+TEST(SpwRmapTCPNodeImplTest, CompletionReportsSendFailure) {
+  TestNode node(makeNodeConfig());
+  node.setFailSends(true);
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 4> payload{0x01, 0x02, 0x03, 0x04};
+
+  spw_rmap::TransactionCompletion completion;
+  node.writeAsync(target_node, 0x1000, payload, completion);
+  ASSERT_TRUE(completion.isReady());
+  auto result = completion.result();
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error(), std::make_error_code(std::errc::broken_pipe));
+}
+
+TEST(SpwRmapTCPNodeImplTest, AwaitersResumeFromPoll) {
+  constexpr std::size_t kSequences = 200;
+  auto config = makeNodeConfig();
+  config.transaction_id_max = config.transaction_id_min + kSequences;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+
+  const std::array<uint8_t, 2> payload{0x01, 0x02};
+  std::vector<std::array<uint8_t, 4>> reads(kSequences);
+  std::size_t finished = 0;
+  auto sequence = [&](std::size_t i) -> Detached {
+    auto written = co_await node.writeAwait(target_node, 0x1000, payload);
+    EXPECT_TRUE(written.has_value());
+    auto read = co_await node.readAwait(target_node, 0x2000, reads[i]);
+    EXPECT_TRUE(read.has_value());
+    ++finished;
+  };
+  for (std::size_t i = 0; i < kSequences; ++i) {
+    sequence(i);
+  }
+  EXPECT_EQ(finished, 0U);
+
+  // Each resumed sequence reads under the ID its write just released.
+  for (std::size_t i = 0; i < kSequences; ++i) {
+    node.enqueueIncoming(
+        buildWriteReplyFrame(static_cast<uint16_t>(0x0020 + i)));
+    ASSERT_TRUE(node.poll().has_value());
+  }
+  EXPECT_EQ(finished, 0U);
+  for (std::size_t i = 0; i < kSequences; ++i) {
+    const std::array<uint8_t, 4> data{static_cast<uint8_t>(i), 1, 2, 3};
+    node.enqueueIncoming(
+        buildReadReplyFrame(static_cast<uint16_t>(0x0020 + i), data));
+    ASSERT_TRUE(node.poll().has_value());
+    EXPECT_EQ(reads[i], data);
+  }
+  EXPECT_EQ(finished, kSequences);
+}
+
+TEST(SpwRmapTCPNodeImplTest, AwaiterCompletesWithoutSuspendingOnFailure) {
+  TestNode node(makeNodeConfig());
+  node.setFailSends(true);
+  auto target_node = makeTargetNode();
+  const std::array<uint8_t, 2> payload{0x01, 0x02};
+
+  std::optional<std::error_code> error;
+  [&]() -> Detached {
+    auto res = co_await node.writeAwait(target_node, 0x1000, payload);
+    error = res.has_value() ? std::error_code{} : res.error();
+  }();
+  ASSERT_TRUE(error.has_value());
+  EXPECT_EQ(*error, std::make_error_code(std::errc::broken_pipe));
+}
+
+TEST(SpwRmapTCPNodeImplTest, AwaiterTimesOutFromTimerThread) {
+  TestNode node(makeNodeConfig());
+  node.setTimeout(1ms);
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 4> buffer{};
+
+  std::promise<std::error_code> resumed;
+  [&]() -> Detached {
+    auto res = co_await node.readAwait(target_node, 0x1000, buffer);
+    resumed.set_value(res.has_value() ? std::error_code{} : res.error());
+  }();
+  auto future = resumed.get_future();
+  ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+  EXPECT_EQ(future.get(), std::make_error_code(std::errc::timed_out));
+}
+
+TEST(SpwRmapTCPNodeImplTest, SubmittedTransactionsCompleteIntoQueue) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+  spw_rmap::CompletionQueue queue(4);
+
+  const std::array<uint8_t, 2> payload{0x01, 0x02};
+  std::array<uint8_t, 3> buffer{};
+  std::array<uint8_t, 3> short_buffer{};
+  const std::array<spw_rmap::RmapRequest, 5> requests{{
+      {.operation = spw_rmap::RmapOperation::Write,
+       .target_node = target_node,
+       .memory_address = 0x1000,
+       .write_data = payload,
+       .user_data = 10},
+      {.operation = spw_rmap::RmapOperation::Read,
+       .target_node = target_node,
+       .memory_address = 0x2000,
+       .read_data = buffer,
+       .user_data = 11},
+      {.operation = spw_rmap::RmapOperation::Read,
+       .target_node = target_node,
+       .memory_address = 0x3000,
+       .read_data = short_buffer,
+       .user_data = 12},
+      {.operation = spw_rmap::RmapOperation::Write,
+       .target_node = target_node,
+       .memory_address = 0x4000,
+       .write_data = payload,
+       .user_data = 13},
+      {.operation = spw_rmap::RmapOperation::Write,
+       .target_node = target_node,
+       .user_data = 14},
+  }};
+  // The queue holds four, so the fifth request is not accepted.
+  ASSERT_EQ(node.submit(queue, requests), 4U);
+  EXPECT_EQ(node.submit(queue, requests), 0U);
+
+  const std::array<uint8_t, 3> data{7, 8, 9};
+  node.enqueueIncoming(buildReadReplyFrame(0x0021, data));
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  node.enqueueIncoming(buildReadReplyFrame(0x0022, payload));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(node.poll().has_value());
+  }
+
+  std::array<spw_rmap::RmapCompletion, 4> out{};
+  ASSERT_EQ(node.submit(queue, requests), 0U);
+  ASSERT_EQ(queue.reap(out, 3), 3U);
+  EXPECT_EQ(out[0].user_data, 11U);
+  EXPECT_FALSE(out[0].error);
+  EXPECT_EQ(buffer, data);
+  EXPECT_EQ(out[1].user_data, 10U);
+  EXPECT_FALSE(out[1].error);
+  EXPECT_EQ(out[2].user_data, 12U);
+  EXPECT_EQ(out[2].error, std::make_error_code(std::errc::bad_message));
+  EXPECT_EQ(queue.outstanding(), 1U);
+}
+
+TEST(SpwRmapTCPNodeImplTest, SubmitReportsUnstartableTransactions) {
+  auto config = makeNodeConfig();
+  config.transaction_id_max = config.transaction_id_min + 1;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+  spw_rmap::CompletionQueue queue(8);
+  const std::array<uint8_t, 2> payload{0x01, 0x02};
+
+  std::vector<spw_rmap::RmapRequest> requests(
+      3, {.target_node = target_node, .write_data = payload});
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    requests[i].user_data = i;
+  }
+  ASSERT_EQ(node.submit(queue, requests), 3U);
+  std::array<spw_rmap::RmapCompletion, 8> out{};
+  ASSERT_EQ(queue.reap(out), 2U);
+  for (std::size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(out[i].user_data, i + 1);
+    EXPECT_EQ(out[i].error, std::make_error_code(
+                                std::errc::resource_unavailable_try_again));
+  }
+
+  node.setFailSends(true);
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_EQ(node.submit(queue, std::span(requests).first(1)), 1U);
+  ASSERT_EQ(queue.reap(out, 2), 2U);
+  EXPECT_EQ(out[0].user_data, 0U);
+  EXPECT_FALSE(out[0].error);
+  EXPECT_EQ(out[1].error, std::make_error_code(std::errc::broken_pipe));
+}
+
+TEST(SpwRmapTCPNodeImplTest, HeaderTemplateMatchesBuilderOnWire) {
+  auto templated = makeTargetNode();
+  auto plain = std::make_shared<PlainTargetNode>();
+  ASSERT_TRUE(templated->getCommandHeader().isValid());
+  ASSERT_FALSE(plain->getCommandHeader().isValid());
+
+  std::vector<uint8_t> data{0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+  std::vector<std::vector<uint8_t>> frames[2];
+  for (int i = 0; i < 2; ++i) {
+    TestNode node(makeNodeConfig());
+    std::shared_ptr<spw_rmap::TargetNodeBase> target = templated;
+    if (i == 1) {
+      target = plain;
+    }
+    auto write_future = node.writeAsync(target, 0x1000, data,
+                                        [](const spw_rmap::Packet&) {});
+    auto read_future =
+        node.readAsync(target, 0x2000, 16, [](const spw_rmap::Packet&) {});
+    frames[i] = node.sentFrames();
+  }
+  ASSERT_EQ(frames[0].size(), 2U);
+  EXPECT_EQ(frames[0], frames[1]);
+}
+
+TEST(SpwRmapTCPNodeImplTest, LargeWriteDoesNotGrowSendBuffer) {
+  auto config = makeNodeConfig();
+  config.buffer_policy = spw_rmap::BufferPolicy::Fixed;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+
+  std::vector<uint8_t> data(64 * 1024);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 13);
+  }
+  auto future = node.writeAsync(target_node, 0x4000, data,
+                                [](const spw_rmap::Packet&) {});
+  ASSERT_EQ(node.sentFrames().size(), 1U);
+  const auto& frame = node.sentFrames().front();
+  // Skip the frame header and the target SpaceWire address.
+  const auto packet = std::span(frame).subspan(12 + 2);
+
+  spw_rmap::PacketParser parser;
+  ASSERT_EQ(parser.parse(packet), spw_rmap::PacketParser::Status::Success);
+  const auto& parsed = parser.getPacket();
+  EXPECT_EQ(parsed.type, spw_rmap::PacketType::Write);
+  EXPECT_EQ(parsed.address, 0x4000U);
+  EXPECT_TRUE(std::ranges::equal(parsed.data, data));
+
+  node.enqueueIncoming(buildWriteReplyFrame(0x0020));
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_TRUE(future.get().has_value());
+}
+
+TEST(SpwRmapTCPNodeImplTest, BufferedReceiveParsesSeveralFramesPerRecv) {
+  TestNode node(makeNodeConfig());
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 8> payload{};
+  constexpr std::size_t kCount = 8;
+
+  std::vector<std::future<std::expected<std::monostate, std::error_code>>>
+      futures;
+  std::vector<uint8_t> incoming;
+  for (std::size_t i = 0; i < kCount; ++i) {
+    futures.push_back(node.writeAsync(target_node, 0x1000, payload,
+                                      [](const spw_rmap::Packet&) {}));
+    auto frame = buildWriteReplyFrame(static_cast<uint16_t>(0x0020 + i));
+    incoming.insert(incoming.end(), frame.begin(), frame.end());
+  }
+  node.resetIoStatistics();
+  node.enqueueIncoming(incoming);
+
+  for (std::size_t i = 0; i < kCount; ++i) {
+    auto poll_result = node.poll();
+    ASSERT_TRUE(poll_result.has_value());
+  }
+  for (auto& future : futures) {
+    EXPECT_TRUE(future.get().has_value());
+  }
+  const auto stats = node.getIoStatistics();
+  EXPECT_EQ(stats.packets_received, kCount);
+  EXPECT_EQ(stats.recv_calls, 1U);
+}
+
+TEST(SpwRmapTCPNodeImplTest, WriterThreadCoalescesConcurrentWrites) {
+  auto config = makeNodeConfig();
+  config.use_writer_thread = true;
+  config.writer_latency_bound = std::chrono::milliseconds(20);
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+  constexpr std::size_t kThreads = 16;
+
+  std::vector<std::future<std::expected<std::monostate, std::error_code>>>
+      futures(kThreads);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&, i] {
+      std::array<uint8_t, 8> payload{};
+      payload.fill(static_cast<uint8_t>(i));
+      futures[i] = node.writeAsync(target_node, 0x1000, payload,
+                                   [](const spw_rmap::Packet&) {});
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Frames are sent asynchronously; walk the stream until all are there.
+  // Command layout after the 12-byte frame header: path (2), logical
+  // address, protocol ID, instruction, key, reply address (4), initiator,
+  // then the transaction ID.
+  std::vector<uint16_t> transaction_ids;
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (transaction_ids.size() < kThreads &&
+         std::chrono::steady_clock::now() < deadline) {
+    transaction_ids.clear();
+    const auto stream = node.sentStream();
+    std::size_t offset = 0;
+    while (offset + 12 <= stream.size()) {
+      const auto length = static_cast<std::size_t>(stream[offset + 10]) << 8 |
+                          stream[offset + 11];
+      transaction_ids.push_back(static_cast<uint16_t>(
+          stream[offset + 23] << 8 | stream[offset + 24]));
+      offset += 12 + length;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(transaction_ids.size(), kThreads);
+  const auto stats = node.getIoStatistics();
+  EXPECT_EQ(stats.packets_sent, kThreads);
+  EXPECT_LT(stats.send_calls, kThreads);
+
+  for (const auto transaction_id : transaction_ids) {
+    node.enqueueIncoming(buildWriteReplyFrame(transaction_id));
+  }
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    ASSERT_TRUE(node.poll().has_value());
+  }
+  for (auto& future : futures) {
+    EXPECT_TRUE(future.get().has_value());
+  }
+}
+
+TEST(SpwRmapTCPNodeImplTest, WriterThreadReportsSendFailure) {
+  auto config = makeNodeConfig();
+  config.use_writer_thread = true;
+  TestNode node(config);
+  node.setFailSends(true);
+  auto target_node = makeTargetNode();
+  std::array<uint8_t, 4> payload{0x01, 0x02, 0x03, 0x04};
+
+  auto future = node.writeAsync(target_node, 0x1000, payload,
+                                [](const spw_rmap::Packet&) {});
+  ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+  auto result = future.get();
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error(), std::make_error_code(std::errc::broken_pipe));
+}
+
+TEST(SpwRmapTCPNodeImplTest, HandlerThreadsAnswerCommandsInArrivalOrder) {
+  auto config = makeNodeConfig();
+  config.handler_threads = 2;
+  TestNode node(config);
+  std::promise<void> release;
+  auto released = release.get_future();
+  std::vector<uint8_t> written;
+  std::atomic<int> reads{0};
+  node.registerOnWrite([&](spw_rmap::Packet packet) {
+    released.wait();
+    written.assign(packet.data.begin(), packet.data.end());
+  });
+  node.registerOnReadInto(
+      [&reads](spw_rmap::Packet packet, std::span<uint8_t> data) {
+        std::ranges::fill(data, static_cast<uint8_t>(packet.address));
+        reads.fetch_add(1);
+        return spw_rmap::PacketStatusCode::CommandExecutedSuccessfully;
+      });
+
+  const std::array<uint8_t, 4> payload{0x01, 0x02, 0x03, 0x04};
+  node.enqueueIncoming(buildWriteCommandFrame(0x0101, 0x10, payload));
+  node.enqueueIncoming(buildReadCommandFrame(0x0102, 0x20, 4));
+  node.enqueueIncoming(buildReadCommandFrame(0x0103, 0x30, 4));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(node.poll().has_value());
+  }
+  // The reads are served while the write stalls, but not answered first.
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (reads.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_EQ(reads.load(), 2);
+  EXPECT_TRUE(node.sentStream().empty());
+
+  release.set_value();
+  std::vector<uint16_t> transaction_ids;
+  while (transaction_ids.size() < 3 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+    transaction_ids = replyTransactionIds(node.sentStream());
+  }
+  EXPECT_EQ(transaction_ids, (std::vector<uint16_t>{0x0101, 0x0102, 0x0103}));
+  // Received before the later commands reused the receive buffer.
+  EXPECT_TRUE(std::ranges::equal(written, payload));
+}
+
+TEST(SpwRmapTCPNodeImplTest, HandlerThreadsRunReplyCallbacks) {
+  auto config = makeNodeConfig();
+  config.handler_threads = 1;
+  TestNode node(config);
+  auto target_node = makeTargetNode();
+  std::promise<void> release;
+  auto released = release.get_future();
+  std::thread::id callback_thread;
+  std::vector<uint8_t> received;
+  auto read = node.readAsync(
+      target_node, 0x3000, 4, [&](const spw_rmap::Packet& packet) {
+        released.wait();
+        callback_thread = std::this_thread::get_id();
+        received.assign(packet.data.begin(), packet.data.end());
+      });
+  std::array<uint8_t, 4> payload{};
+  auto write = node.writeAsync(target_node, 0x1000, payload,
+                               [](const spw_rmap::Packet&) {});
+
+  const std::array<uint8_t, 4> expected{0x09, 0x08, 0x07, 0x06};
+  node.enqueueIncoming(buildReadReplyFrame(0x0020, expected));
+  node.enqueueIncoming(buildWriteReplyFrame(0x0021));
+  // Neither reply waits for the blocked callback to be received.
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(node.poll().has_value());
+  EXPECT_EQ(write.wait_for(10ms), std::future_status::timeout);
+
+  release.set_value();
+  EXPECT_TRUE(read.get().has_value());
+  EXPECT_TRUE(write.get().has_value());
+  EXPECT_NE(callback_thread, std::this_thread::get_id());
+  EXPECT_TRUE(std::ranges::equal(received, expected));
+}
+
 }  // namespace
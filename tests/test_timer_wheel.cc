@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <spw_rmap/internal/timer_wheel.hh>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using spw_rmap::internal::TimerWheel;
+
+// Advances one tick at a time and records (tick, index) of every expiry.
+auto runTo(TimerWheel& wheel, uint64_t tick)
+    -> std::vector<std::pair<uint64_t, uint32_t>> {
+  std::vector<std::pair<uint64_t, uint32_t>> fired;
+  while (wheel.now() < tick) {
+    const auto target = wheel.now() + 1;
+    wheel.advance(target, [&](uint32_t index) {
+      fired.emplace_back(target, index);
+    });
+  }
+  return fired;
+}
+
+TEST(TimerWheel, FiresAtTheScheduledTick) {
+  TimerWheel wheel(4);
+  wheel.schedule(0, 5);
+  wheel.schedule(1, 64);
+  wheel.schedule(2, 64 * 64 + 3);
+  wheel.schedule(3, 1);
+  EXPECT_EQ(wheel.pending(), 4U);
+
+  const auto fired = runTo(wheel, 64 * 64 + 10);
+  const std::vector<std::pair<uint64_t, uint32_t>> expected{
+      {1, 3}, {5, 0}, {64, 1}, {64 * 64 + 3, 2}};
+  EXPECT_EQ(fired, expected);
+  EXPECT_EQ(wheel.pending(), 0U);
+}
+
+TEST(TimerWheel, CancelAndRescheduleDisarmTheOldTick) {
+  TimerWheel wheel(2);
+  wheel.schedule(0, 10);
+  wheel.schedule(1, 20);
+  wheel.cancel(0);
+  wheel.cancel(0);
+  EXPECT_FALSE(wheel.isScheduled(0));
+  wheel.schedule(1, 300);
+
+  EXPECT_TRUE(runTo(wheel, 299).empty());
+  const auto fired = runTo(wheel, 400);
+  ASSERT_EQ(fired.size(), 1U);
+  EXPECT_EQ(fired[0], std::make_pair(uint64_t{300}, uint32_t{1}));
+}
+
+TEST(TimerWheel, PastTickFiresOnNextAdvance) {
+  TimerWheel wheel(1);
+  std::ignore = runTo(wheel, 100);
+  wheel.schedule(0, 50);
+  const auto fired = runTo(wheel, 101);
+  ASSERT_EQ(fired.size(), 1U);
+  EXPECT_EQ(fired[0].first, 101U);
+}
+
+TEST(TimerWheel, SkipsIdleTicksAndKeepsFarTimers) {
+  TimerWheel wheel(2);
+  constexpr uint64_t kFar = (uint64_t{1} << 24) + 12345;  // Overflow list
+  wheel.schedule(0, kFar);
+  wheel.schedule(1, 70'000);
+  // 70000 sits in level 2 until that level's bucket 17 begins.
+  EXPECT_EQ(wheel.nextTick(), 17U << 12);
+
+  std::vector<std::pair<uint64_t, uint32_t>> fired;
+  const std::array<uint64_t, 4> steps{69'999, 70'000, kFar - 1, kFar};
+  for (const auto step : steps) {
+    wheel.advance(step, [&](uint32_t index) {
+      fired.emplace_back(wheel.now(), index);
+    });
+  }
+  const std::vector<std::pair<uint64_t, uint32_t>> expected{{70'000, 1},
+                                                            {kFar, 0}};
+  EXPECT_EQ(fired, expected);
+  EXPECT_FALSE(wheel.nextTick().has_value());
+}
+
+TEST(TimerWheel, MatchesSortedDeadlines) {
+  constexpr uint32_t kTimers = 2000;
+  TimerWheel wheel(kTimers);
+  std::mt19937_64 rng(7);
+  std::vector<uint64_t> deadline(kTimers);
+  for (uint32_t i = 0; i < kTimers; ++i) {
+    deadline[i] = 1 + rng() % 300'000;
+    wheel.schedule(i, deadline[i]);
+  }
+  uint64_t now = 0;
+  std::vector<bool> seen(kTimers, false);
+  while (wheel.pending() > 0) {
+    const auto previous = now;
+    now += 1 + rng() % 5000;
+    wheel.advance(now, [&](uint32_t index) {
+      EXPECT_GT(deadline[index], previous);
+      EXPECT_LE(deadline[index], now);
+      EXPECT_EQ(wheel.now(), deadline[index]);
+      seen[index] = true;
+    });
+  }
+  for (uint32_t i = 0; i < kTimers; ++i) {
+    EXPECT_TRUE(seen[i]) << i;
+  }
+}
+
+}  // namespace
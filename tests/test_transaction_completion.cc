@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spw_rmap/internal/spw_rmap_tcp_node_impl.hh"
+#include "spw_rmap/packet_builder.hh"
+#include "spw_rmap/target_node.hh"
+#include "spw_rmap/transaction_completion.hh"
+
+namespace {
+
+// Allocations made by the current thread while counting is on.
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+  if (counting) {
+    ++allocations;
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+auto operator delete(void* ptr) noexcept -> void { std::free(ptr); }
+
+auto operator delete(void* ptr, std::size_t /*size*/) noexcept -> void {
+  std::free(ptr);
+}
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Backend that neither allocates nor blocks: sends are discarded into a
+// fixed buffer and replies are served from bytes staged in advance.
+class FixedBackend {
+ public:
+  FixedBackend(std::string ip, std::string port)
+      : ip_address_(std::move(ip)), port_(std::move(port)) {}
+
+  auto getIpAddress() const noexcept -> const std::string& {
+    return ip_address_;
+  }
+
+  auto setIpAddress(std::string ip_address) noexcept -> void {
+    ip_address_ = std::move(ip_address);
+  }
+
+  auto getPort() const noexcept -> const std::string& { return port_; }
+
+  auto setPort(std::string port) noexcept -> void { port_ = std::move(port); }
+
+  auto setSendTimeout(std::chrono::microseconds /*timeout*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  auto sendAll(std::span<const uint8_t> data) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    sent_bytes_ += data.size();
+    last_sent_size_ = std::min(data.size(), sink_.size());
+    std::copy_n(data.begin(), std::min(data.size(), sink_.size()),
+                sink_.begin());
+    return std::monostate{};
+  }
+
+  auto sendAllv(std::span<const std::span<const uint8_t>> buffers) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    for (const auto& buffer : buffers) {
+      std::ignore = sendAll(buffer);
+    }
+    return std::monostate{};
+  }
+
+  auto recvSome(std::span<uint8_t> buffer) noexcept
+      -> std::expected<std::size_t, std::error_code> {
+    const auto count = std::min(buffer.size(), staged_.size() - read_pos_);
+    if (count == 0) {
+      return std::unexpected{
+          std::make_error_code(std::errc::operation_canceled)};
+    }
+    std::copy_n(staged_.begin() + static_cast<std::ptrdiff_t>(read_pos_),
+                count, buffer.begin());
+    read_pos_ += count;
+    return count;
+  }
+
+  auto shutdown() noexcept -> std::expected<std::monostate, std::error_code> {
+    shutdown_ = true;
+    return std::monostate{};
+  }
+
+  [[nodiscard]] auto isShutdown() const noexcept -> bool { return shutdown_; }
+
+  [[nodiscard]] auto lastSent() const noexcept -> std::span<const uint8_t> {
+    return std::span(sink_).first(last_sent_size_);
+  }
+
+  auto connect(std::chrono::microseconds /*timeout*/) noexcept
+      -> std::expected<std::monostate, std::error_code> {
+    return std::monostate{};
+  }
+
+  void stage(std::span<const uint8_t> bytes) {
+    staged_.assign(bytes.begin(), bytes.end());
+    read_pos_ = 0;
+  }
+
+ private:
+  std::string ip_address_;
+  std::string port_;
+  std::array<uint8_t, 4096> sink_{};
+  std::size_t sent_bytes_ = 0;
+  std::size_t last_sent_size_ = 0;
+  std::vector<uint8_t> staged_;
+  std::size_t read_pos_ = 0;
+  bool shutdown_ = false;
+};
+
+class FixedNode
+    : public spw_rmap::internal::SpwRmapTCPNodeImpl<FixedBackend> {
+  using Base = spw_rmap::internal::SpwRmapTCPNodeImpl<FixedBackend>;
+
+ public:
+  explicit FixedNode(spw_rmap::SpwRmapTCPNodeConfig config)
+      : Base(std::move(config)) {}
+
+  void stage(std::span<const uint8_t> bytes) { getBackend_()->stage(bytes); }
+
+  auto lastSent() -> std::span<const uint8_t> {
+    return getBackend_()->lastSent();
+  }
+
+  auto shutdown() noexcept
+      -> std::expected<std::monostate, std::error_code> override {
+    return getBackend_()->shutdown();
+  }
+
+  auto isShutdowned() noexcept -> bool override {
+    return getBackend_()->isShutdown();
+  }
+};
+
+auto frameOf(std::span<const uint8_t> payload) -> std::vector<uint8_t> {
+  std::vector<uint8_t> frame(12 + payload.size(), 0);
+  const uint64_t length = payload.size();
+  for (std::size_t i = 0; i < 8; ++i) {
+    frame[4 + i] = static_cast<uint8_t>(length >> (56 - 8 * i));
+  }
+  std::copy(payload.begin(), payload.end(), frame.begin() + 12);
+  return frame;
+}
+
+auto writeReply(uint16_t transaction_id) -> std::vector<uint8_t> {
+  spw_rmap::WriteReplyPacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::WriteReplyPacketConfig{
+      .replyAddress = reply_addr,
+      .initiatorLogicalAddress = 0x34,
+      .status = static_cast<uint8_t>(
+          spw_rmap::PacketStatusCode::CommandExecutedSuccessfully),
+      .targetLogicalAddress = 0xFE,
+      .transactionID = transaction_id,
+      .incrementMode = true,
+      .verifyMode = true,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return frameOf(payload);
+}
+
+auto readReply(uint16_t transaction_id, std::span<const uint8_t> data)
+    -> std::vector<uint8_t> {
+  spw_rmap::ReadReplyPacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::ReadReplyPacketConfig{
+      .replyAddress = reply_addr,
+      .initiatorLogicalAddress = 0x34,
+      .status = static_cast<uint8_t>(
+          spw_rmap::PacketStatusCode::CommandExecutedSuccessfully),
+      .targetLogicalAddress = 0xFE,
+      .transactionID = transaction_id,
+      .data = data,
+      .incrementMode = true,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return frameOf(payload);
+}
+
+auto readCommand(uint16_t transaction_id, uint32_t address,
+                 uint32_t length) -> std::vector<uint8_t> {
+  spw_rmap::ReadPacketBuilder builder;
+  auto reply_addr = std::array<uint8_t, 1>{0x01};
+  auto config = spw_rmap::ReadPacketConfig{
+      .replyAddress = reply_addr,
+      .targetLogicalAddress = 0xFE,
+      .initiatorLogicalAddress = 0x34,
+      .transactionID = transaction_id,
+      .address = address,
+      .dataLength = length,
+  };
+  std::vector<uint8_t> payload(builder.getTotalSize(config));
+  EXPECT_TRUE(builder.build(config, payload).has_value());
+  return frameOf(payload);
+}
+
+auto makeConfig() -> spw_rmap::SpwRmapTCPNodeConfig {
+  spw_rmap::SpwRmapTCPNodeConfig config;
+  config.ip_address = "127.0.0.1";
+  config.port = "10030";
+  config.send_buffer_size = 512;
+  config.recv_buffer_size = 512;
+  return config;
+}
+
+TEST(TransactionCompletion, StartsPendingAndReportsTheError) {
+  spw_rmap::TransactionCompletion completion;
+  EXPECT_FALSE(completion.isReady());
+  completion.complete(std::make_error_code(std::errc::timed_out));
+  ASSERT_TRUE(completion.isReady());
+  EXPECT_EQ(completion.result().error(),
+            std::make_error_code(std::errc::timed_out));
+  completion.reset();
+  EXPECT_FALSE(completion.isReady());
+  completion.complete({});
+  EXPECT_TRUE(completion.result().has_value());
+}
+
+TEST(TransactionCompletion, WaiterMayDestroyItAsSoonAsItIsDone) {
+  // The completer must be finished with the object by the time `wait`
+  // returns; the waiter frees it straight away.
+  for (int i = 0; i < 2000; ++i) {
+    auto completion = std::make_unique<spw_rmap::TransactionCompletion>();
+    auto* raw = completion.get();
+    std::thread completer([raw] { raw->complete({}); });
+    completion->wait();
+    completion.reset();
+    completer.join();
+  }
+}
+
+TEST(TransactionCompletion, RoundTripsDoNotAllocate) {
+  FixedNode node(makeConfig());
+  auto target_node = std::make_shared<spw_rmap::TargetNodeDynamic>(
+      0x34, std::vector<uint8_t>{0x20, 0x30}, std::vector<uint8_t>{0x10});
+  const std::array<uint8_t, 16> payload{};
+  const std::array<uint8_t, 16> expected{1, 2, 3, 4, 5, 6, 7, 8,
+                                         9, 10, 11, 12, 13, 14, 15, 16};
+  std::array<uint8_t, 16> received{};
+  const auto write_reply = writeReply(0x0020);
+  const auto read_reply = readReply(0x0020, expected);
+  spw_rmap::TransactionCompletion completion;
+
+  // The first transaction starts the timer thread and sizes the buffers.
+  node.writeAsync(target_node, 0x1000, payload, completion);
+  node.stage(write_reply);
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_TRUE(completion.result().has_value());
+
+  std::size_t counted = 0;
+  for (int i = 0; i < 100; ++i) {
+    counting = true;
+    allocations = 0;
+    node.writeAsync(target_node, 0x1000, payload, completion);
+    counting = false;
+    node.stage(write_reply);
+    counting = true;
+    std::ignore = node.poll();
+    const bool wrote = completion.result().has_value();
+    node.readAsync(target_node, 0x2000, received, completion);
+    counting = false;
+    node.stage(read_reply);
+    counting = true;
+    std::ignore = node.poll();
+    const bool read = completion.result().has_value();
+    counting = false;
+    counted += allocations;
+    ASSERT_TRUE(wrote);
+    ASSERT_TRUE(read);
+  }
+  EXPECT_EQ(counted, 0U);
+  EXPECT_EQ(received, expected);
+}
+
+TEST(TransactionCompletion, ReadIntoHandlerServesReadsWithoutAllocating) {
+  FixedNode node(makeConfig());
+  node.registerOnReadInto(
+      [](spw_rmap::Packet packet, std::span<uint8_t> data) {
+        if (packet.address >= 0x8000) {
+          return spw_rmap::PacketStatusCode::InvalidKey;
+        }
+        for (std::size_t i = 0; i < data.size(); ++i) {
+          data[i] = static_cast<uint8_t>(packet.address + i);
+        }
+        return spw_rmap::PacketStatusCode::CommandExecutedSuccessfully;
+      });
+  const auto command = readCommand(0x0100, 0x40, 64);
+
+  // The first reply sizes the send buffer.
+  node.stage(command);
+  ASSERT_TRUE(node.poll().has_value());
+
+  std::size_t counted = 0;
+  for (int i = 0; i < 100; ++i) {
+    node.stage(command);
+    counting = true;
+    allocations = 0;
+    const bool polled = node.poll().has_value();
+    counting = false;
+    counted += allocations;
+    ASSERT_TRUE(polled);
+  }
+  EXPECT_EQ(counted, 0U);
+
+  spw_rmap::PacketParser parser;
+  ASSERT_EQ(parser.parse(node.lastSent().subspan(12)),
+            spw_rmap::PacketParser::Status::Success);
+  const auto& reply = parser.getPacket();
+  EXPECT_EQ(reply.type, spw_rmap::PacketType::ReadReply);
+  EXPECT_EQ(reply.transactionID, 0x0100);
+  EXPECT_EQ(reply.status, 0);
+  ASSERT_EQ(reply.data.size(), 64U);
+  for (std::size_t i = 0; i < reply.data.size(); ++i) {
+    EXPECT_EQ(reply.data[i], static_cast<uint8_t>(0x40 + i));
+  }
+
+  // A failure status is answered without data.
+  node.stage(readCommand(0x0101, 0x8000, 64));
+  ASSERT_TRUE(node.poll().has_value());
+  ASSERT_EQ(parser.parse(node.lastSent().subspan(12)),
+            spw_rmap::PacketParser::Status::Success);
+  EXPECT_EQ(parser.getPacket().transactionID, 0x0101);
+  EXPECT_EQ(parser.getPacket().status,
+            static_cast<uint8_t>(spw_rmap::PacketStatusCode::InvalidKey));
+  EXPECT_TRUE(parser.getPacket().data.empty());
+}
+
+}  // namespace
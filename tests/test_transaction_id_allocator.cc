@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <span>
+#include <spw_rmap/internal/transaction_id_allocator.hh>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using spw_rmap::internal::TransactionIdAllocator;
+
+TEST(TransactionIdAllocator, HandsOutLowestFreeIndex) {
+  TransactionIdAllocator ids(5);
+  for (std::size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(ids.acquire(), i);
+  }
+  EXPECT_FALSE(ids.acquire().has_value());
+  EXPECT_EQ(ids.available(), 0U);
+
+  ids.release(3);
+  ids.release(1);
+  EXPECT_TRUE(ids.isFree(1));
+  EXPECT_EQ(ids.available(), 2U);
+  EXPECT_EQ(ids.acquire(), 1U);
+  EXPECT_EQ(ids.acquire(), 3U);
+  EXPECT_FALSE(ids.acquire().has_value());
+}
+
+TEST(TransactionIdAllocator, ReleasingTwiceIsHarmless) {
+  TransactionIdAllocator ids(2);
+  ASSERT_EQ(ids.acquire(), 0U);
+  ids.release(0);
+  ids.release(0);
+  EXPECT_EQ(ids.available(), 2U);
+  EXPECT_EQ(ids.acquire(), 0U);
+  EXPECT_EQ(ids.acquire(), 1U);
+  EXPECT_FALSE(ids.acquire().has_value());
+}
+
+TEST(TransactionIdAllocator, BatchAcquireStopsWhenExhausted) {
+  TransactionIdAllocator ids(70);
+  ASSERT_EQ(ids.acquire(), 0U);
+  std::vector<std::size_t> batch(100);
+  EXPECT_EQ(ids.acquire(batch), 69U);
+  for (std::size_t i = 0; i < 69; ++i) {
+    EXPECT_EQ(batch[i], i + 1);
+  }
+  EXPECT_EQ(ids.available(), 0U);
+  ids.release(64);
+  EXPECT_EQ(ids.acquire(std::span(batch).first(1)), 1U);
+  EXPECT_EQ(batch[0], 64U);
+}
+
+TEST(TransactionIdAllocator, CoversFullSixteenBitRange) {
+  constexpr std::size_t kCount = 0x10000;
+  TransactionIdAllocator ids(kCount);
+  for (std::size_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(ids.acquire(), i);
+  }
+  EXPECT_FALSE(ids.acquire().has_value());
+
+  // Free indices in different leaf and summary words; they come back in
+  // ascending order.
+  for (const std::size_t index : {0xFFFFUL, 0x1000UL, 0x40UL, 0x3FUL}) {
+    ids.release(index);
+  }
+  EXPECT_EQ(ids.acquire(), 0x3FU);
+  EXPECT_EQ(ids.acquire(), 0x40U);
+  EXPECT_EQ(ids.acquire(), 0x1000U);
+  EXPECT_EQ(ids.acquire(), 0xFFFFU);
+  EXPECT_FALSE(ids.acquire().has_value());
+}
+
+TEST(TransactionIdAllocator, NeverHandsOutAnIndexTwice) {
+  constexpr std::size_t kThreads = 8;
+  constexpr std::size_t kRounds = 20000;
+  TransactionIdAllocator ids(100);
+  std::mutex mtx;
+  std::set<std::size_t> in_use;
+  bool duplicate = false;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      for (std::size_t i = 0; i < kRounds; ++i) {
+        const auto index = ids.acquire();
+        if (!index.has_value()) {
+          continue;
+        }
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          duplicate |= !in_use.insert(*index).second;
+        }
+        {
+          std::lock_guard<std::mutex> lock(mtx);
+          in_use.erase(*index);
+        }
+        ids.release(*index);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(duplicate);
+  EXPECT_EQ(ids.available(), 100U);
+}
+
+}  // namespace